@@ -34,8 +34,8 @@ int main() {
         // 3. Test new start point setting
         std::cout << "\n3. Testing new start point..." << std::endl;
         Vector2d new_start(15.0, 25.0);
-        auto reordered_track = utils::setNewStartPoint(track, new_start);
-        std::cout << "Track reordered with new start point" << std::endl;
+        TrackView reordered_track = utils::setNewStartPoint(track, new_start);
+        std::cout << "Track reordered with new start point (index " << reordered_track.offset() << ")" << std::endl;
         
         // 4. Test raceline calculation
         std::cout << "\n4. Testing raceline calculation..." << std::endl;
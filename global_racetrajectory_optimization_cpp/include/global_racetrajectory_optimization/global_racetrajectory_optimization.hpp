@@ -1,11 +1,25 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <string>
+#include <fstream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <tuple>
 #include <memory>
+#include <utility>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+
+namespace trajectory_planning_helpers {
+template <typename Scalar> class SegmentIndex;
+} // namespace trajectory_planning_helpers
 
 namespace global_racetrajectory_optimization {
 
@@ -14,12 +28,16 @@ using VectorXd = Eigen::VectorXd;
 using MatrixXd = Eigen::MatrixXd;
 using Matrix2Xd = Eigen::Matrix2Xd;
 using Vector2d = Eigen::Vector2d;
+using SparseMatrixXd = Eigen::SparseMatrix<double>;
+using ConstMatrixMap = Eigen::Map<const MatrixXd>;
 
 // Forward declarations
 struct VehicleParameters;
 struct OptimizationOptions;
 struct TrackData;
 struct OptimizationResult;
+class SharedTables;
+class ArtifactCache;
 
 // Enums
 enum class OptimizationType {
@@ -74,16 +92,135 @@ struct OptimizationOptions {
     double w_veh_reopt = 1.6;    // [m] vehicle width for reoptimization
     int step_non_reg = 0;        // [-] non-regular sampling step
     double eps_kappa = 1e-3;     // [rad/m] curvature threshold
+    bool footprint_bounds = false;  // derive lateral bounds from the vehicle footprint instead of width_opt
+    double footprint_margin = 0.2;  // [m] safety distance added to the vehicle footprint
+    double footprint_dalpha = 0.1;  // [m] lateral resolution of the corridor distance field
 };
 
 struct TrackData {
-    MatrixXd reftrack;           // [x, y, w_tr_right, w_tr_left]
     MatrixXd coeffs_x;           // spline coefficients x
     MatrixXd coeffs_y;           // spline coefficients y
     MatrixXd normvectors;        // normalized normal vectors
-    MatrixXd a_interp;           // spline interpolation matrix
+    SparseMatrixXd a_interp;     // spline interpolation matrix (banded, stored sparse)
     VectorXd el_lengths;         // element lengths
     std::string track_name;      // track identifier
+    std::shared_ptr<const trajectory_planning_helpers::SegmentIndex<double>> segment_index;  // spatial index of reftrack
+    int start_index = 0;         // row of the prepared arrays (before setStartPoint rotated them) they now start at
+    uint64_t source_hash = 0;    // content hash of the source track file
+    
+    // Reference track [x, y, w_tr_right, w_tr_left, optional extra channels]: zero-copy view into a read-only
+    // SharedTables mapping, shared by all copies of the track data (and by all processes mapping the same file)
+    ConstMatrixMap reftrack() const { return ConstMatrixMap(reftrack_data_, reftrack_rows_, reftrack_cols_); }
+    std::shared_ptr<const SharedTables> reftrackTables() const { return reftrack_tables_; }
+    
+    // Stores table as the reference track in a new anonymous memfd mapping
+    void setReftrack(const MatrixXd& table);
+    // Uses the "reftrack" table of a mapping, throws std::runtime_error if there is none
+    void setReftrack(std::shared_ptr<const SharedTables> tables);
+
+private:
+    std::shared_ptr<const SharedTables> reftrack_tables_;
+    const double* reftrack_data_ = nullptr;
+    Eigen::Index reftrack_rows_ = 0;
+    Eigen::Index reftrack_cols_ = 0;
+};
+
+// Read-only view of a closed track table [x, y, w_tr_right, w_tr_left, ...] (one point per row) starting at another row:
+// row i of the view is row (offset + i) mod n of the table, nothing is copied. Reversed views run backwards from the
+// offset, (offset - i) mod n, with the width columns swapped. The table (or the mapping behind it) must outlive the view
+class TrackView {
+public:
+    TrackView() = default;
+    explicit TrackView(const ConstMatrixMap& table, int offset = 0, bool reversed = false)
+        : data_(table.data()), rows_(static_cast<int>(table.rows())), cols_(static_cast<int>(table.cols())),
+          offset_(rows_ > 0 ? ((offset % rows_) + rows_) % rows_ : 0), reversed_(reversed) {}
+    explicit TrackView(const MatrixXd& table, int offset = 0, bool reversed = false)
+        : TrackView(ConstMatrixMap(table.data(), table.rows(), table.cols()), offset, reversed) {}
+    
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int offset() const { return offset_; }
+    bool reversed() const { return reversed_; }
+    
+    // Row of the underlying table for view row i
+    int index(int i) const { return reversed_ ? ((offset_ - i) % rows() + rows()) % rows() : (offset_ + i) % rows(); }
+    
+    // Column of the underlying table for view column j
+    int column(int j) const { return (reversed_ && (j == 2 || j == 3)) ? 5 - j : j; }
+    
+    double operator()(int i, int j) const { return table()(index(i), column(j)); }
+    
+    Eigen::RowVectorXd row(int i) const {
+        Eigen::RowVectorXd result = table().row(index(i));
+        if (reversed_ && result.size() >= 4) {
+            std::swap(result(2), result(3));
+        }
+        return result;
+    }
+    
+    // Copy in view order
+    MatrixXd toMatrix() const {
+        int n = rows();
+        ConstMatrixMap table = this->table();
+        MatrixXd result(n, cols());
+        if (!reversed_) {
+            result.topRows(n - offset_) = table.middleRows(offset_, n - offset_);
+            result.bottomRows(offset_) = table.topRows(offset_);
+        } else if (n > 0) {
+            result.topRows(offset_ + 1) = table.topRows(offset_ + 1).colwise().reverse();
+            result.bottomRows(n - offset_ - 1) = table.bottomRows(n - offset_ - 1).colwise().reverse();
+            if (result.cols() >= 4) {
+                result.col(2).swap(result.col(3));
+            }
+        }
+        return result;
+    }
+
+private:
+    const double* data_ = nullptr;
+    int rows_ = 0;
+    int cols_ = 0;
+    int offset_ = 0;
+    bool reversed_ = false;
+    
+    ConstMatrixMap table() const { return ConstMatrixMap(data_, rows_, cols_); }
+};
+
+// Prepared track driven in the opposite direction, computed on access from the original arrays: reversed point order
+// (the start point is kept), swapped widths, negated normal vectors and splines traversed from t = 1 to 0. Matching
+// reuses the segment index of the original track. The track data must outlive the view. The view is only meant for
+// ad-hoc queries on the reversed track without switching it (the optimizer does not use it, reverseDirection()
+// reverses the prepared arrays in place through utils::reverseTrackData because the solvers index them directly)
+class ReversedTrackView {
+public:
+    explicit ReversedTrackView(const TrackData& track);
+    
+    int size() const { return reftrack_.rows(); }
+    
+    const TrackView& reftrack() const { return reftrack_; }
+    
+    // Row of the original arrays for point i, and for spline/element i (from point i to point i + 1)
+    int pointIndex(int i) const { return reftrack_.index(i); }
+    int splineIndex(int i) const { return reftrack_.index(i + 1); }
+    
+    Vector2d point(int i) const;
+    Vector2d normal(int i) const;
+    double widthRight(int i) const { return reftrack_(i, 2); }
+    double widthLeft(int i) const { return reftrack_(i, 3); }
+    double elLength(int i) const;
+    Eigen::Vector4d coeffsX(int i) const;
+    Eigen::Vector4d coeffsY(int i) const;
+    
+    // Curvilinear coordinates [s, d] in the reversed direction (s from the start point, d positive to the left)
+    Vector2d toFrenet(const Vector2d& pos) const;
+    MatrixXd toFrenet(const MatrixXd& points, int n_threads = 0) const;  // points: N x 2 [x, y], result N x 2 [s, d]
+    
+    // Materialized reversed track for the solvers (no smoothing, spline coefficients and normals transformed)
+    TrackData toTrackData() const;
+
+private:
+    const TrackData* track_;
+    TrackView reftrack_;
 };
 
 struct OptimizationResult {
@@ -91,11 +228,79 @@ struct OptimizationResult {
     VectorXd s_opt;              // arc length coordinates
     VectorXd v_opt;              // optimal velocity profile
     VectorXd kappa_opt;          // optimal curvature profile
+    VectorXd psi_opt;            // heading profile
+    VectorXd ax_opt;             // longitudinal acceleration profile
     MatrixXd raceline;           // optimal raceline [x, y]
     double lap_time;             // total lap time
     double optimization_time;    // optimization duration
     bool success;                // optimization success flag
     std::string message;         // result message
+    uint64_t content_key = 0;    // hash of all inputs and options the result depends on (0: unknown)
+};
+
+// Value of a config entry, typed once while parsing
+struct ConfigValue {
+    enum Type { NUMBER, BOOL, NONE, STRING };
+    
+    Type type = NONE;
+    double number = 0.0;
+    bool boolean = false;
+    std::string text;            // source text (strings without their quotes)
+    int line = 0;                // line in the config file
+};
+
+// Config file (racecar.ini) compiled once into fully populated option structs. Every entry is typed while parsing and
+// kept under its full key, "SECTION.name" or "SECTION.block.name" for entries of {...} blocks (nested blocks keep
+// their whole path). Later entries for the same option win, e.g. the flat stepsize keys over stepsize_opts. Syntax
+// errors, unknown keys, values of the wrong type and out-of-range options throw std::runtime_error with file and line
+class Config {
+public:
+    Config() = default;
+    explicit Config(const std::string& filename);
+    static Config fromString(const std::string& text, const std::string& source = "<memory>");
+    
+    VehicleParameters vehicle;
+    OptimizationOptions optimization;
+    StepsizeOptions stepsize;
+    RegSmoothOptions reg_smooth;
+    CurvCalcOptions curv_calc;
+    
+    // O(1) access to every entry, also those without an option struct (e.g. the mintime vehicle, tire and powertrain
+    // blocks): find returns nullptr for missing keys, number throws for missing or non-numeric ones
+    const ConfigValue* find(const std::string& key) const;
+    double number(const std::string& key) const;
+    const std::vector<std::string>& keys() const { return keys_; }  // file order
+    const std::string& source() const { return source_; }
+
+private:
+    std::string source_;
+    std::unordered_map<std::string, ConfigValue> values_;
+    std::vector<std::string> keys_;
+    
+    void compile(const std::string& text);
+};
+
+// Watches a config file from a background thread (polling its modification time) and passes every changed version
+// that compiles to the callback, so long-running processes pick up tuning without a restart. Versions with errors
+// are reported on std::cerr and skipped. The callback runs on the watcher thread
+class ConfigWatcher {
+public:
+    ConfigWatcher(const std::string& filename, std::function<void(const Config&)> on_change, int poll_ms = 500);
+    ~ConfigWatcher();
+    
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+private:
+    std::string filename_;
+    std::function<void(const Config&)> on_change_;
+    int poll_ms_;
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stop_cv_;
+    bool stop_ = false;
+    
+    void run();
 };
 
 // Main optimization class
@@ -103,15 +308,46 @@ class GlobalRaceTrajectoryOptimizer {
 public:
     GlobalRaceTrajectoryOptimizer();
     ~GlobalRaceTrajectoryOptimizer();
-
+    
     // Configuration
     bool loadConfig(const std::string& config_file);
+    bool applyConfig(const Config& config);  // same thread as the optimizations, see setPendingConfig
+    
+    // Thread-safe hand-over of a new config, e.g. from a ConfigWatcher callback (which runs on the watcher thread):
+    // the latest pending config is applied at the start of the next prepareTrack or optimization call. Changed
+    // preparation options prepare the track again from the imported reference line
+    void setPendingConfig(const Config& config);
     bool loadTrack(const std::string& track_file);
     bool loadVehicleDynamics(const std::string& ggv_file, const std::string& ax_max_file);
-
+    
     // Track preparation
     bool prepareTrack(bool debug = true);
     
+    // Moves the start/finish line of the prepared track to the point closest to new_start (no re-preparation), the
+    // returned view shows the reference track in the new order. The start point and the direction are kept when the
+    // track is prepared again (e.g. for new options)
+    TrackView setStartPoint(const Vector2d& new_start);
+    
+    // Switches the prepared track to the opposite driving direction (no re-preparation, the arrays are reversed in
+    // place by utils::reverseTrackData), the start point is kept
+    bool reverseDirection();
+    
+    // Binary snapshot of the prepared track: prepareTrack loads it instead of preparing when it matches the track file
+    // and the preparation options, otherwise the track is prepared and the snapshot is written
+    void setTrackSnapshot(const std::string& snapshot_file) { snapshot_file_ = snapshot_file; }
+    
+    // Shared table file for the vehicle dynamics tables: loadVehicleDynamics maps it when it was written for the same
+    // input files (e.g. by another worker process), otherwise the CSVs are parsed and the file is written. Without a
+    // file the tables are kept in an anonymous memfd, which forked workers share as well
+    void setSharedTableFile(const std::string& table_file) { shared_table_file_ = table_file; }
+    
+    // Content-addressed cache of the pipeline stages (prepared track, optimized path, velocity profile, exports):
+    // every stage output is stored under the hash of its inputs and options and reused while they are unchanged,
+    // e.g. a new GGV file only recomputes the velocity profile. Takes the place of the track snapshot file. The
+    // prepared reference track is kept in a cache table file as well, which all processes using the cache map
+    void setArtifactCache(const std::string& directory);
+    std::shared_ptr<const ArtifactCache> getArtifactCache() const { return cache_; }
+    
     // Optimization methods
     OptimizationResult optimizeShortestPath();
     OptimizationResult optimizeMinCurvature(bool use_iqp = false);
@@ -125,6 +361,10 @@ public:
     const TrackData& getTrackData() const { return track_data_; }
     const VehicleParameters& getVehicleParams() const { return veh_params_; }
     const OptimizationOptions& getOptimizationOptions() const { return optim_opts_; }
+    // Vehicle dynamics tables: zero-copy views into input_tables_
+    ConstMatrixMap getGGVData() const { return ConstMatrixMap(ggv_data_, ggv_rows_, ggv_cols_); }
+    ConstMatrixMap getAxMaxMachines() const { return ConstMatrixMap(ax_max_data_, ax_max_rows_, ax_max_cols_); }
+    std::shared_ptr<const SharedTables> getInputTables() const { return input_tables_; }
 
 private:
     // Member variables
@@ -135,45 +375,550 @@ private:
     RegSmoothOptions reg_smooth_opts_;
     CurvCalcOptions curv_calc_opts_;
     
-    MatrixXd ggv_data_;          // GGV diagram data
-    MatrixXd ax_max_machines_;   // Machine acceleration limits
+    // GGV diagram data and machine acceleration limits (tables in input_tables_)
+    const double* ggv_data_ = nullptr;
+    Eigen::Index ggv_rows_ = 0;
+    Eigen::Index ggv_cols_ = 0;
+    const double* ax_max_data_ = nullptr;
+    Eigen::Index ax_max_rows_ = 0;
+    Eigen::Index ax_max_cols_ = 0;
+    std::shared_ptr<const SharedTables> input_tables_;
+    std::shared_ptr<const SharedTables> raw_reftrack_;  // reference track as imported, input of every preparation
+    
+    std::mutex pending_mutex_;
+    std::optional<Config> pending_config_;  // set by setPendingConfig, guarded by pending_mutex_
     
     bool config_loaded_;
     bool track_loaded_;
     bool veh_dynamics_loaded_;
     bool track_prepared_;
     
+    std::string snapshot_file_;  // prepared track snapshot, empty: disabled
+    std::string shared_table_file_;  // shared vehicle dynamics tables, empty: anonymous memfd
+    std::shared_ptr<const ArtifactCache> cache_;  // pipeline artifact cache, nullptr: disabled
+    uint64_t track_key_ = 0;     // content key of the prepared track
+    std::optional<Vector2d> start_point_;  // position given to setStartPoint, re-applied after each preparation
+    bool reversed_ = false;      // reverseDirection was called an odd number of times
+    
     // Helper methods
     bool validateConfiguration();
+    bool applyPendingConfig(bool reprepare);
+    void restoreStartAndDirection();
+    void shareReftrack();
     bool interpolateTrack();
     bool calculateSplines();
     MatrixXd loadCSV(const std::string& filename);
-    bool saveCSV(const MatrixXd& data, const std::string& filename);
+    void calculateVelocityProfile(OptimizationResult& result, uint64_t path_key, double v_fallback);
+    bool saveCSV(const MatrixXd& data, const std::string& filename, int precision = 6);
+};
+
+// Uniformly resampled, s-indexed raceline for online consumers. Lookups are O(1) (sample index = s / ds) with linear
+// interpolation and wrap around the lap. Samples are stored one per column with rows [s, x, y, psi, kappa, vx, ax] and
+// continue max_horizon beyond the lap end, so every horizon slice is a contiguous view into the table
+class RacelineTable {
+public:
+    enum Channel { S = 0, X, Y, PSI, KAPPA, VX, AX, N_CHANNELS };
+    
+    struct Sample {
+        double s, x, y, psi, kappa, vx, ax;
+    };
+    
+    using Samples = Eigen::Matrix<double, N_CHANNELS, Eigen::Dynamic>;
+    using HorizonView = Eigen::Map<const Samples>;
+    
+    RacelineTable() = default;
+    
+    // ds: target sample spacing (adjusted to divide the lap length), max_horizon <= 0: one full lap. s of the table
+    // starts at 0 on the first raceline point (s_opt is shifted if it starts elsewhere)
+    explicit RacelineTable(const OptimizationResult& result, double ds = 0.5, double max_horizon = 0.0);
+    
+    // Interpolated sample at arbitrary s (wrapped into [0, lap length))
+    Sample at(double s) const;
+    
+    // Samples from s over the given length (s row continues beyond the lap length for wrapped slices)
+    HorizonView horizon(double s, double length) const;
+    
+    double lapLength() const { return lap_length_; }
+    double stepsize() const { return ds_; }
+    int numSamples() const { return n_lap_; }
+    const Samples& samples() const { return samples_; }
+
+private:
+    Samples samples_;
+    double lap_length_ = 0.0;
+    double ds_ = 1.0;
+    int n_lap_ = 0;              // samples per lap, columns beyond belong to the horizon extension
+    
+    double wrap(double s) const;
+};
+
+// Left and right track boundary (reftrack +/- normvectors * widths), each indexed with a uniform grid over its segments.
+// Distances are signed positive towards the track interior, batch queries take one point per row and run in parallel
+class TrackBoundaries {
+public:
+    struct Query {
+        bool inside;             // between both boundaries
+        double d_left;           // signed distance to the left boundary (positive inside)
+        double d_right;          // signed distance to the right boundary (positive inside)
+        double signed_distance;  // min(d_left, d_right)
+    };
+    
+    TrackBoundaries() = default;
+    
+    // track: prepared track data (reftrack with widths and matching normvectors), cell_size <= 0: automatic
+    explicit TrackBoundaries(const TrackData& track, double cell_size = 0.0);
+    
+    Query query(const Vector2d& pos) const;
+    
+    Eigen::Array<bool, Eigen::Dynamic, 1> inside(const MatrixXd& points, int n_threads = 0) const;
+    VectorXd signedDistance(const MatrixXd& points, int n_threads = 0) const;
+    MatrixXd boundaryDistances(const MatrixXd& points, int n_threads = 0) const;  // [d_left, d_right] per row
+    
+    const MatrixXd& leftBound() const { return bound_left_; }
+    const MatrixXd& rightBound() const { return bound_right_; }
+
+private:
+    MatrixXd bound_left_;        // [x, y]
+    MatrixXd bound_right_;       // [x, y]
+    std::shared_ptr<const trajectory_planning_helpers::SegmentIndex<double>> index_left_;
+    std::shared_ptr<const trajectory_planning_helpers::SegmentIndex<double>> index_right_;
+};
+
+// Signed boundary distance (positive inside) sampled over the track corridor in curvilinear coordinates: row i belongs
+// to reftrack point i, column j to the lateral shift alpha_min + j * d_alpha along its normal vector
+struct CorridorDistanceField {
+    MatrixXd distance;
+    double alpha_min = 0.0;
+    double d_alpha = 0.1;
+};
+
+// Read-only memory mapping of a whole file, unmapped on destruction (empty files map to size 0)
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return open_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    
+    void unmap();
+};
+
+// Reads a numeric CSV file block by block (same format as utils::readCSV): next() returns the rows of the next
+// block of complete lines, an empty matrix at the end of the file. Memory is bounded by the block size
+class CsvChunkReader {
+public:
+    explicit CsvChunkReader(const std::string& filename, char delimiter = ',', size_t chunk_bytes = 8 << 20);
+    
+    MatrixXd next();
+    bool done() const { return !file_.good() && carry_.empty(); }
+    int cols() const { return n_cols_; }
+
+private:
+    std::ifstream file_;
+    std::string source_;
+    char delimiter_;
+    size_t chunk_bytes_;
+    std::string carry_;          // incomplete last line of the previous block
+    size_t line_number_ = 1;
+    int n_cols_ = 0;
+};
+
+// Named numeric tables (column-major doubles) in one read-only mapping of a file or a sealed anonymous memfd. All
+// processes mapping the same file, or inheriting the memfd, share one copy of the pages. Tables are handed out as
+// zero-copy Eigen::Map views, valid as long as the SharedTables object exists
+class SharedTables {
+public:
+    SharedTables() = default;
+    
+    // Maps an existing table file, throws std::runtime_error if it is missing or corrupt
+    explicit SharedTables(const std::string& filename);
+    ~SharedTables();
+    
+    SharedTables(const SharedTables&) = delete;
+    SharedTables& operator=(const SharedTables&) = delete;
+    SharedTables(SharedTables&& other) noexcept;
+    SharedTables& operator=(SharedTables&& other) noexcept;
+    
+    // Writes the tables into filename (via a temporary file, so readers never see a partial file) or, with an empty
+    // filename, into an anonymous memfd, and maps the result. key identifies the inputs (e.g. their content hashes)
+    static SharedTables create(const std::vector<std::pair<std::string, MatrixXd>>& tables, uint64_t key,
+                               const std::string& filename = "");
+    
+    bool contains(const std::string& name) const;
+    ConstMatrixMap table(const std::string& name) const;
+    
+    uint64_t key() const { return key_; }
+    int fd() const { return fd_; }                 // memfd of anonymous tables, -1 for files
+    const std::string& path() const { return path_; }  // file, or /proc/<pid>/fd/<fd> for a memfd
+
+private:
+    struct Entry {
+        std::string name;
+        Eigen::Index rows;
+        Eigen::Index cols;
+        const double* data;
+    };
+    
+    MappedFile file_;
+    int fd_ = -1;
+    uint64_t key_ = 0;
+    std::string path_;
+    std::vector<Entry> entries_;
+    
+    void map(const std::string& filename);
+};
+
+// Content-addressed artifact store: every artifact is a SharedTables file <directory>/<stage>_<key>.bin (or another
+// file type for exports), where key hashes everything the stage output depends on. Entries never change once written
+// (atomic rename), so concurrent runs can share one cache directory
+class ArtifactCache {
+public:
+    explicit ArtifactCache(const std::string& directory);
+    
+    std::string path(const std::string& stage, uint64_t key, const std::string& extension = ".bin") const;
+    
+    // Cached tables of a stage, nullptr if the artifact does not exist or cannot be read
+    std::shared_ptr<const SharedTables> load(const std::string& stage, uint64_t key) const;
+    bool store(const std::string& stage, uint64_t key, const std::vector<std::pair<std::string, MatrixXd>>& tables) const;
+    
+    // Copies the cached file of a stage to target, writing it with write(cache_path) first if it is missing
+    bool materialize(const std::string& stage, uint64_t key, const std::string& extension, const std::string& target,
+                     const std::function<bool(const std::string&)>& write) const;
+    
+    const std::string& directory() const { return directory_; }
+
+private:
+    std::string directory_;
+};
+
+// Buffered CSV output: numbers are formatted with std::to_chars into a large buffer that is written in blocks (no
+// flush per row). precision: significant digits (printf %g style), <= 0: shortest representation that round-trips
+class CsvWriter {
+public:
+    explicit CsvWriter(const std::string& filename, int precision = 6, char delimiter = ',',
+                       size_t buffer_size = 1 << 20);
+    ~CsvWriter();
+    
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+    
+    bool isOpen() const { return file_.is_open(); }
+    
+    void writeText(const std::string& text);
+    void writeValue(double value);
+    void writeSeparator() { put(delimiter_); }
+    void endRow() { put('\n'); }
+    void writeRow(const MatrixXd& data, int row);
+    
+    // Writes the remaining buffer and closes the file, false if any write failed
+    bool close();
+
+private:
+    std::ofstream file_;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    int precision_;
+    char delimiter_;
+    
+    void put(char c);
+    void flush();
+};
+
+// Columnar binary container for many optimization results (e.g. parameter sweeps). Every result has a fixed-size
+// header (sweep parameters, lap time, timings), the profiles are stored as one column chunk per channel
+// (RacelineTable::Channel order s, x, y, psi, kappa, vx, ax) holding all results back to back. Chunks are either raw
+// doubles or delta encoded (zigzag varints of the differences between neighbouring IEEE bit patterns, lossless)
+class ResultArchiveWriter {
+public:
+    explicit ResultArchiveWriter(const std::string& filename, int n_parameters = 0, bool delta_encoding = false);
+    ~ResultArchiveWriter();
+    
+    ResultArchiveWriter(const ResultArchiveWriter&) = delete;
+    ResultArchiveWriter& operator=(const ResultArchiveWriter&) = delete;
+    
+    // parameters: n_parameters values describing the run (empty: zeros)
+    void add(const OptimizationResult& result, const VectorXd& parameters = VectorXd());
+    
+    // Writes the archive, false on I/O errors
+    bool close();
+
+private:
+    struct Entry {
+        uint64_t n_points;
+        bool success;
+        double lap_time;
+        double optimization_time;
+        VectorXd parameters;
+    };
+    
+    std::string filename_;
+    int n_parameters_;
+    bool delta_encoding_;
+    bool closed_ = false;
+    std::vector<Entry> entries_;
+    std::vector<std::vector<char>> chunks_;                  // encoded data per channel
+    std::vector<std::vector<uint64_t>> chunk_offsets_;       // start of every result in its chunk
+};
+
+// Memory-mapped reader for ResultArchiveWriter files: only the pages of the requested columns are touched
+class ResultArchiveReader {
+public:
+    struct ResultInfo {
+        int n_points;
+        bool success;
+        double lap_time;
+        double optimization_time;
+        Eigen::Map<const VectorXd> parameters;
+    };
+    
+    explicit ResultArchiveReader(const std::string& filename);
+    
+    int numResults() const { return n_results_; }
+    int numParameters() const { return n_parameters_; }
+    bool deltaEncoded() const { return delta_encoding_; }
+    
+    ResultInfo info(int result) const;
+    
+    // One channel of one result, or of all results back to back
+    VectorXd column(RacelineTable::Channel channel, int result) const;
+    VectorXd column(RacelineTable::Channel channel) const;
+    
+    // Zero-copy view of a channel of all results (raw archives only)
+    Eigen::Map<const VectorXd> columnView(RacelineTable::Channel channel) const;
+    
+    // Profiles of one result (raceline [x, y], s, psi, kappa, v, ax) plus its header values
+    OptimizationResult result(int result) const;
+
+private:
+    MappedFile file_;
+    int n_results_ = 0;
+    int n_parameters_ = 0;
+    bool delta_encoding_ = false;
+    uint64_t n_points_total_ = 0;
+    const char* records_ = nullptr;
+    const uint64_t* directory_ = nullptr;        // per channel: chunk offset, chunk size, n_results + 1 result offsets
+    
+    const uint64_t* channelDirectory(RacelineTable::Channel channel) const;
+    void decode(RacelineTable::Channel channel, int result, double* out) const;
+};
+
+// Prepared piece of a streamed track: resampled points [first_point, first_point + n) with the spline from every
+// point to its successor (the last point of an open track has no spline). A closed track is emitted starting at point
+// overlap: its first points are held back until the end of the track is known and close the last segment, so the
+// indices of that segment continue past the last point (index mod number of points) and s past the track length
+struct TrackSegment {
+    int index = 0;               // running segment number
+    int first_point = 0;         // index of the first point in the whole resampled track
+    double s_start = 0.0;        // [m] arc length at the first point (from point 0)
+    MatrixXd reftrack;           // [x, y, w_tr_right, w_tr_left, optional extra channels]
+    MatrixXd coeffs_x;
+    MatrixXd coeffs_y;
+    MatrixXd normvectors;
+    VectorXd el_lengths;
+};
+
+// Incremental track preparation for tracks or logs too long to hold in memory: raw points are added in chunks,
+// resampled to stepsize_reg on the fly and every segment_points points a segment is prepared on a window with
+// overlap context points on both sides and passed to the callback. Only the window is kept, so memory is bounded
+// by segment_points + 4 * overlap rows independent of the track length
+class TrackStreamPreparer {
+public:
+    using SegmentCallback = std::function<void(const TrackSegment&)>;
+    
+    TrackStreamPreparer(const StepsizeOptions& stepsize_opts, SegmentCallback callback, int segment_points = 4096,
+                        int overlap = 8, bool closed = true);
+    
+    // Raw points [x, y, w_tr_right, w_tr_left, ...] in driving direction, all chunks with the same columns
+    void add(const MatrixXd& points);
+    
+    // Emits the remaining points (closed tracks: including the closing spline back to point 0)
+    void finish();
+    
+    int numPoints() const { return n_points_; }
+    int numSegments() const { return n_segments_; }
+    double length() const { return s_emitted_ - s_first_; }
+
+private:
+    double stepsize_;
+    SegmentCallback callback_;
+    int segment_points_;
+    int overlap_;
+    bool closed_;
+    bool finished_ = false;
+    
+    // Resampling state: last raw point, its arc length and the next sample position
+    VectorXd raw_prev_;
+    double raw_s_ = 0.0;
+    long long n_samples_ = 0;
+    double last_sample_s_ = -1.0;
+    
+    MatrixXd window_;            // left context, core and right context of the next segment
+    int n_window_ = 0;
+    int n_left_ = 0;             // context rows at the start of the window
+    MatrixXd head_;              // first 2 * overlap points of a closed track (held back, then right context)
+    int n_head_ = 0;
+    
+    int n_points_ = 0;           // resampled points so far
+    int n_emitted_ = 0;          // points passed to the callback
+    int n_segments_ = 0;
+    double s_emitted_ = 0.0;
+    double s_first_ = 0.0;       // arc length of the first emitted point
+    
+    void addSample(const VectorXd& sample);
+    void emit(int n_core, int n_right);
+};
+
+// Telemetry log ingestion: CSV logs (any header, see utils::readCSV) or binary logs of little-endian float64 records,
+// columns selected by index. AUTO reads files ending in ".bin" as binary logs and everything else as CSV
+enum class TelemetryFormat {
+    AUTO,
+    CSV,
+    BINARY
+};
+
+struct TelemetryOptions {
+    TelemetryFormat format = TelemetryFormat::AUTO;
+    char delimiter = ',';
+    int binary_cols = 3;         // values per record of binary logs
+    int col_t = 0;               // [s] timestamp
+    int col_x = 1;               // [m]
+    int col_y = 2;               // [m]
+    int col_v = -1;              // [m/s] speed, < 0: from the distance between consecutive positions
+    double max_offset = 10.0;    // [m] laps with samples further from the reference line are rejected (pit lane)
+    double max_gap = 1.0;        // [s] laps with a longer gap between two samples are rejected (logging dropouts)
+    double match_tol = 5.0;      // [m] arc length jumps beyond twice the driven distance plus match_tol reject the lap
+    double ds_resample = 0.0;    // [m] > 0: laps resampled onto a uniform s grid
+    bool keep_partial = false;   // keep the incomplete laps before the first and after the last start line crossing
+    size_t chunk_bytes = 8 << 20;  // CSV read block
+};
+
+// One lap of a log matched onto the reference line of a track, s-indexed for delta-time analysis: s runs strictly
+// increasing from 0 to the track length (complete laps start and end with a sample interpolated at the start line)
+struct TelemetryLap {
+    int lap = 0;                 // start line crossings in the log before this lap
+    bool complete = true;        // started and ended at the start line
+    double t_start = 0.0;        // [s] log time at the first sample
+    double lap_time = 0.0;       // [s]
+    VectorXd s;                  // [m] arc length along the reference line
+    VectorXd t;                  // [s] time since t_start
+    VectorXd d;                  // [m] lateral offset, positive to the left
+    VectorXd v;                  // [m/s]
+    MatrixXd xy;                 // [x, y]
+};
+
+struct TelemetryLog {
+    std::string source;
+    bool success = false;
+    std::string message;
+    int n_samples = 0;
+    int n_invalid = 0;           // rows with non-finite values, skipped before matching
+    int n_rejected = 0;          // laps dropped for leaving the track, gaps or mismatches
+    std::vector<TelemetryLap> laps;
 };
 
 // Standalone utility functions
 namespace utils {
     
-    // Configuration parsing
+    // Configuration parsing (untyped, see Config for the typed and validated form)
     std::map<std::string, std::string> parseConfigFile(const std::string& filename);
     bool parseVehicleParams(const std::map<std::string, std::string>& config, VehicleParameters& params);
     bool parseOptimizationOptions(const std::map<std::string, std::string>& config, OptimizationOptions& opts);
     bool parseStepsizeOptions(const std::map<std::string, std::string>& config, StepsizeOptions& opts);
     bool parseRegSmoothOptions(const std::map<std::string, std::string>& config, RegSmoothOptions& opts);
+    bool parseCurvCalcOptions(const std::map<std::string, std::string>& config, CurvCalcOptions& opts);
+    
+    // Numeric CSV tables: one matrix row per line, lines starting with '#' and leading header lines are skipped, all
+    // data lines must have the same number of cells. Malformed cells throw std::runtime_error with the line number
+    MatrixXd readCSV(const std::string& filename, char delimiter = ',');
+    MatrixXd parseCSV(const char* data, size_t size, char delimiter = ',', const std::string& source = "<memory>");
+    
+    // Streams a track CSV through a TrackStreamPreparer (chunk_bytes per read), returns the number of points
+    int prepareTrackStreaming(const std::string& filename, const StepsizeOptions& stepsize_opts,
+                              const TrackStreamPreparer::SegmentCallback& callback, int segment_points = 4096,
+                              bool closed = true, size_t chunk_bytes = 8 << 20);
+    
+    // Content hashes (64 bit FNV-1a) identifying track files and the options their preparation depends on
+    uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL);
+    uint64_t hashFile(const std::string& filename);
+    uint64_t hashPreparationOptions(const StepsizeOptions& stepsize_opts, const RegSmoothOptions& reg_smooth_opts);
+    uint64_t hashValues(const std::vector<double>& values, uint64_t seed);  // cache keys from options
+    
+    // Prepared track snapshots (versioned binary, arrays stored column-major, a_interp in compressed sparse form), loading returns false
+    // if the file is missing, corrupt or was written for another source hash or options hash. The reference track is
+    // used from reftrack_tables (no copy) if its "reftrack" table equals the stored one
+    bool saveTrackSnapshot(const TrackData& track, uint64_t options_hash, const std::string& filename);
+    bool loadTrackSnapshot(const std::string& filename, uint64_t source_hash, uint64_t options_hash, TrackData& track,
+                           std::shared_ptr<const SharedTables> reftrack_tables = nullptr);
     
     // Track utilities
     MatrixXd importTrack(const std::string& filename, bool flip_track = false);
     bool checkTrackValidity(const MatrixXd& track);
-    MatrixXd setNewStartPoint(const MatrixXd& track, const Vector2d& new_start);
+    bool checkTrackIntersections(const MatrixXd& track);  // sweep-line test of centerline and both boundaries
+    TrackView setNewStartPoint(const MatrixXd& track, const Vector2d& new_start);
+    TrackView setNewStartPoint(const ConstMatrixMap& track, const Vector2d& new_start);
+    TrackView setNewStartPoint(const TrackData& track, const Vector2d& new_start);  // uses the track segment index
+    // Rotates all prepared arrays (reftrack, splines, normal vectors, element lengths, spline system) so that they
+    // start at row offset, shifts the segment index (no new grid) and accumulates the offset in start_index
+    void rotateTrackData(TrackData& track, int offset);
+    // Reverses the driving direction of a prepared track in place (same result as ReversedTrackView::toTrackData)
+    void reverseTrackData(TrackData& track);
     
     // Result processing
-    MatrixXd calculateRaceline(const MatrixXd& reftrack, const MatrixXd& normvectors, const VectorXd& alpha);
-    VectorXd calculateCurvature(const MatrixXd& raceline, const VectorXd& el_lengths, bool closed = true);
+    MatrixXd calculateRaceline(const Eigen::Ref<const MatrixXd>& reftrack, const MatrixXd& normvectors,
+                               const VectorXd& alpha);
+    VectorXd calculateCurvature(const MatrixXd& raceline, const VectorXd& el_lengths, bool closed = true,
+                                const CurvCalcOptions& curv_opts = CurvCalcOptions());
+    std::tuple<VectorXd, VectorXd> calculateHeadingCurvature(const MatrixXd& raceline, const VectorXd& el_lengths,
+                                                             bool closed = true,
+                                                             const CurvCalcOptions& curv_opts = CurvCalcOptions());
+    // Heading and curvature at the start of every spline, in closed form from the spline coefficients
+    std::tuple<VectorXd, VectorXd> calculateSplineHeadingCurvature(const MatrixXd& coeffs_x, const MatrixXd& coeffs_y);
     double calculateLapTime(const VectorXd& v_profile, const VectorXd& el_lengths);
     
-    // Export utilities
-    bool exportToCSV(const OptimizationResult& result, const std::string& filename);
-    bool exportToLTPL(const OptimizationResult& result, const std::string& filename);
+    // Footprint-aware lateral bounds [alpha_min, alpha_max] per reftrack point (shift along normvectors)
+    CorridorDistanceField calculateCorridorDistanceField(const TrackData& track, const TrackBoundaries& boundaries,
+                                                         double d_alpha = 0.1, int n_threads = 0);
+    MatrixXd calculateFootprintBounds(const TrackData& track, const CorridorDistanceField& field,
+                                      const VehicleParameters& veh_params, double margin = 0.0);
+    // Replaces the track widths of reftrack by the footprint bounds, widths of points whose bounds do not contain the
+    // reference line are clamped to zero. Returns the number of clamped points
+    int applyFootprintBounds(MatrixXd& reftrack, const MatrixXd& bounds);
+    
+    // Export utilities (precision: significant digits, <= 0: shortest round-trip representation), the batch export
+    // writes one file per result in parallel and returns false if any of them failed
+    bool exportToCSV(const OptimizationResult& result, const std::string& filename, int precision = 6);
+    bool exportToCSV(const std::vector<OptimizationResult>& results, const std::vector<std::string>& filenames,
+                     int precision = 6, int n_threads = 0);
+    
+    // LTPL trajectory file: hash line of the source track, then per reference point (';' separated) x_ref, y_ref,
+    // width_right, width_left, x_normvec, y_normvec, alpha and the raceline s, psi, kappa, vx, ax. Written in one pass
+    // over the prepared track and a result computed on it (one raceline point per reference point)
+    bool exportToLTPL(const TrackData& track, const OptimizationResult& result, const std::string& filename,
+                      int precision = 0);
+    
+    // Telemetry: parses a log, matches every sample onto the segment index of the prepared track
+    // (path_matching_global) and splits it into laps at the start line. Errors are reported in the returned log.
+    // ingestTelemetryLogs processes the files in parallel, one log per file
+    TelemetryLog ingestTelemetry(const std::string& filename, const TrackData& track,
+                                 const TelemetryOptions& opts = TelemetryOptions());
+    std::vector<TelemetryLog> ingestTelemetryLogs(const std::vector<std::string>& filenames, const TrackData& track,
+                                                  const TelemetryOptions& opts = TelemetryOptions(), int n_threads = 0);
+    
+    // Time difference to a reference lap at every s of the reference (positive: lap is slower there)
+    VectorXd calculateDeltaTime(const TelemetryLap& lap, const TelemetryLap& reference);
     
 } // namespace utils
 
@@ -0,0 +1,67 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <unistd.h>
+
+namespace global_racetrajectory_optimization {
+
+ArtifactCache::ArtifactCache(const std::string& directory) : directory_(directory) {
+    std::error_code ec;
+    std::filesystem::create_directories(directory_, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create cache directory: " + directory_);
+    }
+}
+
+std::string ArtifactCache::path(const std::string& stage, uint64_t key, const std::string& extension) const {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return directory_ + "/" + stage + "_" + name + extension;
+}
+
+std::shared_ptr<const SharedTables> ArtifactCache::load(const std::string& stage, uint64_t key) const {
+    std::string filename = path(stage, key);
+    if (!std::filesystem::exists(filename)) {
+        return nullptr;
+    }
+    
+    try {
+        auto tables = std::make_shared<const SharedTables>(filename);
+        return (tables->key() == key) ? tables : nullptr;
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring cache entry: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+bool ArtifactCache::store(const std::string& stage, uint64_t key,
+                          const std::vector<std::pair<std::string, MatrixXd>>& tables) const {
+    try {
+        SharedTables::create(tables, key, path(stage, key));
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot store cache entry: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool ArtifactCache::materialize(const std::string& stage, uint64_t key, const std::string& extension,
+                                const std::string& target, const std::function<bool(const std::string&)>& write) const {
+    std::string filename = path(stage, key, extension);
+    
+    if (!std::filesystem::exists(filename)) {
+        // Written under a temporary name, so that concurrent runs never copy a partial file
+        std::string tmp_filename = filename + ".tmp" + std::to_string(::getpid());
+        if (!write(tmp_filename) || std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+            std::remove(tmp_filename.c_str());
+            return false;
+        }
+    }
+    
+    std::error_code ec;
+    std::filesystem::copy_file(filename, target, std::filesystem::copy_options::overwrite_existing, ec);
+    return !ec;
+}
+
+} // namespace global_racetrajectory_optimization
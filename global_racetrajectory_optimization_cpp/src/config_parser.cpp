@@ -3,141 +3,515 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <stdexcept>
+#include <unordered_set>
+#include <sys/stat.h>
 
-namespace global_racetrajectory_optimization::utils {
+namespace global_racetrajectory_optimization {
 
-std::map<std::string, std::string> parseConfigFile(const std::string& filename) {
-    std::map<std::string, std::string> config;
-    std::ifstream file(filename);
+namespace {
+
+// Recursive descent over the whole config text: [SECTION] headers, "key = value" lines and {"key": value, ...} blocks
+// spanning any number of lines (blocks may be nested). Entries are returned in file order under their full keys
+class ConfigTokenizer {
+public:
+    ConfigTokenizer(const std::string& text, const std::string& source) : text_(text), source_(source) {}
     
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open config file: " + filename);
+    std::vector<std::pair<std::string, ConfigValue>> run() {
+        while (true) {
+            skipSpace(true);
+            if (pos_ >= text_.size()) {
+                break;
+            }
+            
+            if (text_[pos_] == '[') {
+                size_t close = text_.find(']', pos_);
+                if (close == std::string::npos || text_.find('\n', pos_) < close) {
+                    fail("unterminated section header");
+                }
+                section_ = trim(text_.substr(pos_ + 1, close - pos_ - 1));
+                pos_ = close + 1;
+                expectLineEnd();
+                continue;
+            }
+            
+            size_t eq = text_.find('=', pos_);
+            if (eq == std::string::npos || text_.find('\n', pos_) < eq) {
+                fail("expected 'key = value', found '" + trim(text_.substr(pos_, text_.find('\n', pos_) - pos_)) + "'");
+            }
+            std::string key = trim(text_.substr(pos_, eq - pos_));
+            if (key.empty()) {
+                fail("missing key before '='");
+            }
+            pos_ = eq + 1;
+            
+            skipSpace(false);
+            parseValue(section_.empty() ? key : section_ + "." + key, false);
+            expectLineEnd();
+        }
+        
+        return std::move(entries_);
     }
+
+private:
+    const std::string& text_;
+    const std::string& source_;
+    size_t pos_ = 0;
+    int line_ = 1;
+    std::string section_;
+    std::vector<std::pair<std::string, ConfigValue>> entries_;
     
-    std::string line;
-    std::string current_section;
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error(source_ + ":" + std::to_string(line_) + ": " + message);
+    }
     
-    while (std::getline(file, line)) {
-        // Remove leading/trailing whitespace
-        line.erase(0, line.find_first_not_of(" \t"));
-        line.erase(line.find_last_not_of(" \t") + 1);
-        
-        // Skip empty lines and comments
-        if (line.empty() || line[0] == '#' || line[0] == ';') {
-            continue;
+    static std::string trim(const std::string& str) {
+        size_t begin = str.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return std::string();
         }
-        
-        // Check for section headers [SECTION]
-        if (line[0] == '[' && line.back() == ']') {
-            current_section = line.substr(1, line.length() - 2);
-            continue;
+        return str.substr(begin, str.find_last_not_of(" \t\r") - begin + 1);
+    }
+    
+    // Skips blanks and comments ('#' anywhere, ';' at the start of a line), across lines if newlines is set
+    void skipSpace(bool newlines) {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            bool line_start = (pos_ == 0 || text_[pos_ - 1] == '\n');
+            if (c == ' ' || c == '\t' || c == '\r') {
+                pos_++;
+            } else if (c == '#' || (c == ';' && line_start)) {
+                pos_ = std::min(text_.find('\n', pos_), text_.size());
+            } else if (c == '\n' && newlines) {
+                pos_++;
+                line_++;
+            } else {
+                break;
+            }
+        }
+    }
+    
+    void expectLineEnd() {
+        skipSpace(false);
+        if (pos_ < text_.size() && text_[pos_] != '\n') {
+            fail("unexpected characters '" + trim(text_.substr(pos_, text_.find('\n', pos_) - pos_)) + "'");
+        }
+    }
+    
+    void parseValue(const std::string& key, bool in_block) {
+        if (pos_ < text_.size() && text_[pos_] == '{') {
+            parseBlock(key);
+            return;
         }
         
-        // Parse key-value pairs
-        size_t eq_pos = line.find('=');
-        if (eq_pos != std::string::npos) {
-            std::string key = line.substr(0, eq_pos);
-            std::string value = line.substr(eq_pos + 1);
-            
-            // Remove whitespace around key and value
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t") + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t") + 1);
+        ConfigValue value;
+        value.line = line_;
+        
+        if (pos_ < text_.size() && (text_[pos_] == '"' || text_[pos_] == '\'')) {
+            char quote = text_[pos_];
+            size_t close = text_.find(quote, pos_ + 1);
+            if (close == std::string::npos || text_.find('\n', pos_) < close) {
+                fail("unterminated string for '" + key + "'");
+            }
+            value.type = ConfigValue::STRING;
+            value.text = text_.substr(pos_ + 1, close - pos_ - 1);
+            pos_ = close + 1;
+        } else {
+            // Unquoted scalars end at the line end, a comment or (inside blocks) at ',' or '}'
+            size_t end = pos_;
+            while (end < text_.size() && text_[end] != '\n' && text_[end] != '#'
+                   && !(in_block && (text_[end] == ',' || text_[end] == '}'))) {
+                end++;
+            }
+            value.text = trim(text_.substr(pos_, end - pos_));
+            pos_ = end;
             
-            // Handle multi-line dictionary values
-            if (value.find('{') != std::string::npos && value.find('}') == std::string::npos) {
-                // Multi-line dictionary - read until closing brace
-                std::string dict_content = value;
-                std::string dict_line;
-                while (std::getline(file, dict_line)) {
-                    dict_content += dict_line;
-                    if (dict_line.find('}') != std::string::npos) {
-                        break;
-                    }
-                }
-                value = dict_content;
+            if (value.text.empty()) {
+                fail("missing value for '" + key + "'");
+            }
+            classify(value);
+        }
+        
+        entries_.emplace_back(key, std::move(value));
+    }
+    
+    void parseBlock(const std::string& prefix) {
+        int first_line = line_;
+        pos_++;
+        
+        while (true) {
+            skipSpace(true);
+            if (pos_ >= text_.size()) {
+                line_ = first_line;
+                fail("unterminated block '" + prefix + "'");
+            }
+            if (text_[pos_] == '}') {
+                pos_++;
+                return;
             }
             
-            // Parse dictionary syntax like {"key": value, "key2": value2}
-            if (value.find('{') != std::string::npos && value.find('}') != std::string::npos) {
-                // Extract dictionary content
-                size_t start = value.find('{') + 1;
-                size_t end = value.find('}');
-                std::string dict_str = value.substr(start, end - start);
-                
-                // Better parser for key-value pairs in dictionary - handle nested quotes and commas
-                size_t pos = 0;
-                while (pos < dict_str.length()) {
-                    // Find start of key (skip whitespace)
-                    while (pos < dict_str.length() && (dict_str[pos] == ' ' || dict_str[pos] == '\t' || dict_str[pos] == '\n' || dict_str[pos] == '\r')) pos++;
-                    if (pos >= dict_str.length()) break;
-                    
-                    // Find key (quoted string)
-                    size_t key_start = pos;
-                    if (dict_str[pos] == '"') {
-                        pos++; // skip opening quote
-                        while (pos < dict_str.length() && dict_str[pos] != '"') pos++;
-                        if (pos < dict_str.length()) pos++; // skip closing quote
-                    } else {
-                        while (pos < dict_str.length() && dict_str[pos] != ':') pos++;
-                    }
-                    size_t key_end = pos;
-                    
-                    // Skip colon
-                    while (pos < dict_str.length() && dict_str[pos] != ':') pos++;
-                    if (pos < dict_str.length()) pos++; // skip colon
-                    
-                    // Skip whitespace after colon
-                    while (pos < dict_str.length() && (dict_str[pos] == ' ' || dict_str[pos] == '\t')) pos++;
-                    
-                    // Find value
-                    size_t value_start = pos;
-                    if (pos < dict_str.length() && dict_str[pos] == '"') {
-                        pos++; // skip opening quote
-                        while (pos < dict_str.length() && dict_str[pos] != '"') pos++;
-                        if (pos < dict_str.length()) pos++; // skip closing quote
-                    } else {
-                        // Read until comma or end
-                        while (pos < dict_str.length() && dict_str[pos] != ',') pos++;
-                    }
-                    size_t value_end = pos;
-                    
-                    // Skip comma
-                    if (pos < dict_str.length() && dict_str[pos] == ',') pos++;
-                    
-                    // Extract and clean key and value
-                    if (key_start < key_end && value_start < value_end) {
-                        std::string dict_key = dict_str.substr(key_start, key_end - key_start);
-                        std::string dict_value = dict_str.substr(value_start, value_end - value_start);
-                        
-                        // Clean up key and value
-                        dict_key.erase(0, dict_key.find_first_not_of(" \t\""));
-                        dict_key.erase(dict_key.find_last_not_of(" \t\"") + 1);
-                        dict_value.erase(0, dict_value.find_first_not_of(" \t"));
-                        dict_value.erase(dict_value.find_last_not_of(" \t"));
-                        
-                        // Create composite key
-                        std::string full_dict_key = current_section.empty() ? 
-                            key + "." + dict_key : current_section + "." + key + "." + dict_key;
-                        config[full_dict_key] = dict_value;
-                        
-                        // Debug output removed for cleaner output
-                    }
+            std::string name;
+            if (text_[pos_] == '"' || text_[pos_] == '\'') {
+                size_t close = text_.find(text_[pos_], pos_ + 1);
+                if (close == std::string::npos || text_.find('\n', pos_) < close) {
+                    fail("unterminated key in block '" + prefix + "'");
                 }
+                name = text_.substr(pos_ + 1, close - pos_ - 1);
+                pos_ = close + 1;
             } else {
-                // Remove quotes if present
-                if ((value.front() == '"' && value.back() == '"') ||
-                    (value.front() == '\'' && value.back() == '\'')) {
-                    value = value.substr(1, value.length() - 2);
-                }
-                
-                std::string full_key = current_section.empty() ? key : current_section + "." + key;
-                config[full_key] = value;
+                size_t end = text_.find_first_of(":\n,}", pos_);
+                name = trim(text_.substr(pos_, end - pos_));
+                pos_ = std::min(end, text_.size());
+            }
+            
+            skipSpace(true);
+            if (name.empty() || pos_ >= text_.size() || text_[pos_] != ':') {
+                fail("expected '\"key\": value' in block '" + prefix + "'");
+            }
+            pos_++;
+            skipSpace(true);
+            parseValue(prefix + "." + name, true);
+            
+            skipSpace(true);
+            if (pos_ < text_.size() && text_[pos_] == ',') {
+                pos_++;
+            } else if (pos_ < text_.size() && text_[pos_] != '}') {
+                fail("expected ',' or '}' after '" + prefix + "." + name + "'");
             }
         }
     }
     
+    static void classify(ConfigValue& value) {
+        const std::string& text = value.text;
+        if (text == "true" || text == "True") {
+            value.type = ConfigValue::BOOL;
+            value.boolean = true;
+        } else if (text == "false" || text == "False") {
+            value.type = ConfigValue::BOOL;
+            value.boolean = false;
+        } else if (text == "null" || text == "None") {
+            value.type = ConfigValue::NONE;
+        } else {
+            const char* begin = text.data() + ((text[0] == '+') ? 1 : 0);
+            const char* end = text.data() + text.size();
+            std::from_chars_result res = std::from_chars(begin, end, value.number);
+            value.type = (res.ec == std::errc() && res.ptr == end) ? ConfigValue::NUMBER : ConfigValue::STRING;
+        }
+    }
+};
+
+// Assignment of one entry to its option struct field
+using ConfigBinding = std::function<void(Config&, const ConfigValue&)>;
+
+template <typename Field>
+Field convertValue(const ConfigValue& value);
+
+template <>
+double convertValue<double>(const ConfigValue& value) {
+    if (value.type != ConfigValue::NUMBER) {
+        throw std::invalid_argument("expected a number, found '" + value.text + "'");
+    }
+    return value.number;
+}
+
+template <>
+int convertValue<int>(const ConfigValue& value) {
+    if (value.type != ConfigValue::NUMBER || value.number != std::floor(value.number)) {
+        throw std::invalid_argument("expected an integer, found '" + value.text + "'");
+    }
+    return static_cast<int>(value.number);
+}
+
+template <>
+bool convertValue<bool>(const ConfigValue& value) {
+    if (value.type != ConfigValue::BOOL) {
+        throw std::invalid_argument("expected true or false, found '" + value.text + "'");
+    }
+    return value.boolean;
+}
+
+template <typename Block, typename Field>
+ConfigBinding bind(Block Config::* block, Field Block::* field) {
+    return [block, field](Config& config, const ConfigValue& value) {
+        (config.*block).*field = convertValue<Field>(value);
+    };
+}
+
+const std::unordered_map<std::string, ConfigBinding>& configBindings() {
+    static const std::unordered_map<std::string, ConfigBinding> bindings = {
+        {"GENERAL_OPTIONS.stepsize_opts.stepsize_prep", bind(&Config::stepsize, &StepsizeOptions::stepsize_prep)},
+        {"GENERAL_OPTIONS.stepsize_opts.stepsize_reg", bind(&Config::stepsize, &StepsizeOptions::stepsize_reg)},
+        {"GENERAL_OPTIONS.stepsize_opts.stepsize_interp_after_opt",
+         bind(&Config::stepsize, &StepsizeOptions::stepsize_interp_after_opt)},
+        {"GENERAL_OPTIONS.stepsize_prep", bind(&Config::stepsize, &StepsizeOptions::stepsize_prep)},
+        {"GENERAL_OPTIONS.stepsize_reg", bind(&Config::stepsize, &StepsizeOptions::stepsize_reg)},
+        {"GENERAL_OPTIONS.stepsize_interp_after_opt", bind(&Config::stepsize, &StepsizeOptions::stepsize_interp_after_opt)},
+        
+        {"GENERAL_OPTIONS.reg_smooth_opts.k_reg", bind(&Config::reg_smooth, &RegSmoothOptions::k_reg)},
+        {"GENERAL_OPTIONS.reg_smooth_opts.s_reg", bind(&Config::reg_smooth, &RegSmoothOptions::s_reg)},
+        
+        {"GENERAL_OPTIONS.curv_calc_opts.d_preview_curv", bind(&Config::curv_calc, &CurvCalcOptions::d_preview_curv)},
+        {"GENERAL_OPTIONS.curv_calc_opts.d_review_curv", bind(&Config::curv_calc, &CurvCalcOptions::d_review_curv)},
+        {"GENERAL_OPTIONS.curv_calc_opts.d_preview_head", bind(&Config::curv_calc, &CurvCalcOptions::d_preview_head)},
+        {"GENERAL_OPTIONS.curv_calc_opts.d_review_head", bind(&Config::curv_calc, &CurvCalcOptions::d_review_head)},
+        
+        {"GENERAL_OPTIONS.veh_params.v_max", bind(&Config::vehicle, &VehicleParameters::v_max)},
+        {"GENERAL_OPTIONS.veh_params.length", bind(&Config::vehicle, &VehicleParameters::length)},
+        {"GENERAL_OPTIONS.veh_params.width", bind(&Config::vehicle, &VehicleParameters::width)},
+        {"GENERAL_OPTIONS.veh_params.mass", bind(&Config::vehicle, &VehicleParameters::mass)},
+        {"GENERAL_OPTIONS.veh_params.dragcoeff", bind(&Config::vehicle, &VehicleParameters::dragcoeff)},
+        {"GENERAL_OPTIONS.veh_params.curvlim", bind(&Config::vehicle, &VehicleParameters::curvlim)},
+        {"GENERAL_OPTIONS.veh_params.g", bind(&Config::vehicle, &VehicleParameters::g)},
+        
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.width_opt",
+         bind(&Config::optimization, &OptimizationOptions::width_opt)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.iqp_iters_min",
+         bind(&Config::optimization, &OptimizationOptions::iqp_iters_min)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.iqp_curverror_allowed",
+         bind(&Config::optimization, &OptimizationOptions::iqp_curverror_allowed)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_bounds",
+         bind(&Config::optimization, &OptimizationOptions::footprint_bounds)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_margin",
+         bind(&Config::optimization, &OptimizationOptions::footprint_margin)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_dalpha",
+         bind(&Config::optimization, &OptimizationOptions::footprint_dalpha)},
+        
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.penalty_delta",
+         bind(&Config::optimization, &OptimizationOptions::penalty_delta)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.penalty_F", bind(&Config::optimization, &OptimizationOptions::penalty_F)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.mue", bind(&Config::optimization, &OptimizationOptions::mue)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.n_gauss", bind(&Config::optimization, &OptimizationOptions::n_gauss)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.dn", bind(&Config::optimization, &OptimizationOptions::dn)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.limit_energy",
+         bind(&Config::optimization, &OptimizationOptions::limit_energy)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.energy_limit",
+         bind(&Config::optimization, &OptimizationOptions::energy_limit)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.safe_traj", bind(&Config::optimization, &OptimizationOptions::safe_traj)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.w_tr_reopt",
+         bind(&Config::optimization, &OptimizationOptions::w_tr_reopt)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.w_veh_reopt",
+         bind(&Config::optimization, &OptimizationOptions::w_veh_reopt)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.step_non_reg",
+         bind(&Config::optimization, &OptimizationOptions::step_non_reg)},
+        {"OPTIMIZATION_OPTIONS.optim_opts_mintime.eps_kappa", bind(&Config::optimization, &OptimizationOptions::eps_kappa)},
+    };
+    return bindings;
+}
+
+// Entries without an option struct field that are still part of the format
+const std::unordered_set<std::string>& configPlainKeys() {
+    static const std::unordered_set<std::string> keys = {
+        "GENERAL_OPTIONS.ggv_file",
+        "GENERAL_OPTIONS.ax_max_machines_file",
+        "OPTIMIZATION_OPTIONS.optim_opts_shortest_path.width_opt",
+        "OPTIMIZATION_OPTIONS.optim_opts_mintime.width_opt",
+        "OPTIMIZATION_OPTIONS.optim_opts_mintime.ax_pos_safe",
+        "OPTIMIZATION_OPTIONS.optim_opts_mintime.ax_neg_safe",
+        "OPTIMIZATION_OPTIONS.optim_opts_mintime.ay_safe",
+        "OPTIMIZATION_OPTIONS.optim_opts_mintime.w_add_spl_regr",
+    };
+    return keys;
+}
+
+// Blocks whose entries are kept as they are (parameters of models not implemented by option structs)
+bool isOpenBlockKey(const std::string& key) {
+    static const char* const prefixes[] = {
+        "GENERAL_OPTIONS.vel_calc_opts.",
+        "OPTIMIZATION_OPTIONS.vehicle_params_mintime.",
+        "OPTIMIZATION_OPTIONS.tire_params_mintime.",
+        "OPTIMIZATION_OPTIONS.pwr_params_mintime.",
+    };
+    for (const char* prefix : prefixes) {
+        if (key.compare(0, std::char_traits<char>::length(prefix), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open config file: " + filename);
+    }
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+} // namespace
+
+Config::Config(const std::string& filename) : source_(filename) {
+    compile(readFile(filename));
+}
+
+Config Config::fromString(const std::string& text, const std::string& source) {
+    Config config;
+    config.source_ = source;
+    config.compile(text);
+    return config;
+}
+
+void Config::compile(const std::string& text) {
+    auto entries = ConfigTokenizer(text, source_).run();
+    
+    const auto& bindings = configBindings();
+    const auto& plain_keys = configPlainKeys();
+    
+    auto fail = [this](int line, const std::string& message) {
+        throw std::runtime_error(source_ + ":" + std::to_string(line) + ": " + message);
+    };
+    
+    for (auto& [key, value] : entries) {
+        auto existing = values_.find(key);
+        if (existing != values_.end()) {
+            fail(value.line, "duplicate key '" + key + "' (first set on line " + std::to_string(existing->second.line)
+                 + ")");
+        }
+        
+        auto binding = bindings.find(key);
+        if (binding != bindings.end()) {
+            try {
+                binding->second(*this, value);
+            } catch (const std::invalid_argument& e) {
+                fail(value.line, key + ": " + e.what());
+            }
+        } else if (plain_keys.count(key) == 0 && !isOpenBlockKey(key)) {
+            fail(value.line, "unknown key '" + key + "'");
+        }
+        
+        keys_.push_back(key);
+        values_.emplace(key, std::move(value));
+    }
+    
+    // Range checks, reported at the entry that set the option (or without line for defaults)
+    auto require = [&](bool valid, const std::string& key, const std::string& message) {
+        if (!valid) {
+            const ConfigValue* value = find(key);
+            std::string where = value ? source_ + ":" + std::to_string(value->line) : source_;
+            throw std::runtime_error(where + ": " + key + " " + message);
+        }
+    };
+    
+    require(stepsize.stepsize_prep > 0.0, "GENERAL_OPTIONS.stepsize_prep", "must be positive");
+    require(stepsize.stepsize_reg > 0.0, "GENERAL_OPTIONS.stepsize_reg", "must be positive");
+    require(stepsize.stepsize_interp_after_opt > 0.0, "GENERAL_OPTIONS.stepsize_interp_after_opt", "must be positive");
+    require(reg_smooth.k_reg >= 1 && reg_smooth.k_reg <= 5, "GENERAL_OPTIONS.reg_smooth_opts.k_reg",
+            "must be between 1 and 5");
+    require(reg_smooth.s_reg >= 0.0, "GENERAL_OPTIONS.reg_smooth_opts.s_reg", "must not be negative");
+    require(vehicle.v_max > 0.0, "GENERAL_OPTIONS.veh_params.v_max", "must be positive");
+    require(vehicle.length > 0.0, "GENERAL_OPTIONS.veh_params.length", "must be positive");
+    require(vehicle.width > 0.0, "GENERAL_OPTIONS.veh_params.width", "must be positive");
+    require(vehicle.mass > 0.0, "GENERAL_OPTIONS.veh_params.mass", "must be positive");
+    require(vehicle.dragcoeff >= 0.0, "GENERAL_OPTIONS.veh_params.dragcoeff", "must not be negative");
+    require(vehicle.curvlim > 0.0, "GENERAL_OPTIONS.veh_params.curvlim", "must be positive");
+    require(vehicle.g > 0.0, "GENERAL_OPTIONS.veh_params.g", "must be positive");
+    require(optimization.width_opt > 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mincurv.width_opt", "must be positive");
+    require(optimization.iqp_iters_min >= 1, "OPTIMIZATION_OPTIONS.optim_opts_mincurv.iqp_iters_min",
+            "must be at least 1");
+    require(optimization.iqp_curverror_allowed > 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mincurv.iqp_curverror_allowed",
+            "must be positive");
+    require(optimization.footprint_margin >= 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_margin",
+            "must not be negative");
+    require(optimization.footprint_dalpha > 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_dalpha",
+            "must be positive");
+    require(optimization.mue > 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mintime.mue", "must be positive");
+    require(optimization.n_gauss >= 1, "OPTIMIZATION_OPTIONS.optim_opts_mintime.n_gauss", "must be at least 1");
+    require(optimization.dn > 0.0, "OPTIMIZATION_OPTIONS.optim_opts_mintime.dn", "must be positive");
+    require(curv_calc.d_preview_curv > 0.0 && curv_calc.d_review_curv > 0.0, "GENERAL_OPTIONS.curv_calc_opts",
+            "distances must be positive");
+    require(curv_calc.d_preview_head > 0.0 && curv_calc.d_review_head > 0.0, "GENERAL_OPTIONS.curv_calc_opts",
+            "distances must be positive");
+}
+
+const ConfigValue* Config::find(const std::string& key) const {
+    auto it = values_.find(key);
+    return (it != values_.end()) ? &it->second : nullptr;
+}
+
+double Config::number(const std::string& key) const {
+    const ConfigValue* value = find(key);
+    if (value == nullptr) {
+        throw std::runtime_error(source_ + ": missing key '" + key + "'");
+    }
+    if (value->type != ConfigValue::NUMBER) {
+        throw std::runtime_error(source_ + ":" + std::to_string(value->line) + ": " + key + ": expected a number, found '"
+                                 + value->text + "'");
+    }
+    return value->number;
+}
+
+ConfigWatcher::ConfigWatcher(const std::string& filename, std::function<void(const Config&)> on_change, int poll_ms)
+    : filename_(filename), on_change_(std::move(on_change)), poll_ms_(std::max(poll_ms, 10)) {
+    thread_ = std::thread(&ConfigWatcher::run, this);
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    stop_cv_.notify_all();
+    thread_.join();
+}
+
+void ConfigWatcher::run() {
+    // Modification time and size are polled. A change is only loaded once the file stayed the same for one poll
+    // interval (editors truncate and rewrite), and the content hash filters out touches without changes
+    auto same_state = [](const struct stat& a, const struct stat& b) {
+        return a.st_mtim.tv_sec == b.st_mtim.tv_sec && a.st_mtim.tv_nsec == b.st_mtim.tv_nsec && a.st_size == b.st_size;
+    };
+    
+    struct stat seen {};
+    ::stat(filename_.c_str(), &seen);
+    bool pending = false;
+    
+    uint64_t last_hash = 0;
+    try {
+        last_hash = utils::hashFile(filename_);
+    } catch (const std::exception&) {
+    }
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_cv_.wait_for(lock, std::chrono::milliseconds(poll_ms_), [this] { return stop_; })) {
+        struct stat st {};
+        if (::stat(filename_.c_str(), &st) != 0) {
+            continue;
+        }
+        if (!same_state(st, seen)) {
+            seen = st;
+            pending = true;
+            continue;
+        }
+        if (!pending) {
+            continue;
+        }
+        pending = false;
+        
+        lock.unlock();
+        try {
+            uint64_t hash = utils::hashFile(filename_);
+            if (hash != last_hash) {
+                last_hash = hash;
+                on_change_(Config(filename_));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Config reload failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+namespace utils {
+
+std::map<std::string, std::string> parseConfigFile(const std::string& filename) {
+    std::map<std::string, std::string> config;
+    for (auto& [key, value] : ConfigTokenizer(readFile(filename), filename).run()) {
+        config[key] = std::move(value.text);
+    }
     return config;
 }
 
@@ -179,7 +553,7 @@ bool parseVehicleParams(const std::map<std::string, std::string>& config, Vehicl
         params.g = get_double("g", params.g);
         
         return true;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Error parsing vehicle parameters: " << e.what() << std::endl;
         return false;
@@ -233,6 +607,13 @@ bool parseOptimizationOptions(const std::map<std::string, std::string>& config,
         opts.iqp_curverror_allowed = get_double("optim_opts_mincurv.iqp_curverror_allowed", opts.iqp_curverror_allowed);
         opts.iqp_curverror_allowed = get_double("iqp_curverror_allowed", opts.iqp_curverror_allowed);
         
+        opts.footprint_bounds = get_bool("OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_bounds", opts.footprint_bounds);
+        opts.footprint_bounds = get_bool("optim_opts_mincurv.footprint_bounds", opts.footprint_bounds);
+        opts.footprint_margin = get_double("OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_margin", opts.footprint_margin);
+        opts.footprint_margin = get_double("optim_opts_mincurv.footprint_margin", opts.footprint_margin);
+        opts.footprint_dalpha = get_double("OPTIMIZATION_OPTIONS.optim_opts_mincurv.footprint_dalpha", opts.footprint_dalpha);
+        opts.footprint_dalpha = get_double("optim_opts_mincurv.footprint_dalpha", opts.footprint_dalpha);
+        
         // Mintime specific options
         opts.penalty_delta = get_double("OPTIMIZATION_OPTIONS.optim_opts_mintime.penalty_delta", opts.penalty_delta);
         opts.penalty_F = get_double("OPTIMIZATION_OPTIONS.optim_opts_mintime.penalty_F", opts.penalty_F);
@@ -244,7 +625,7 @@ bool parseOptimizationOptions(const std::map<std::string, std::string>& config,
         opts.safe_traj = get_bool("OPTIMIZATION_OPTIONS.optim_opts_mintime.safe_traj", opts.safe_traj);
         
         return true;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Error parsing optimization options: " << e.what() << std::endl;
         return false;
@@ -280,7 +661,7 @@ bool parseStepsizeOptions(const std::map<std::string, std::string>& config, Step
                   << ", interp=" << opts.stepsize_interp_after_opt << std::endl;
         
         return true;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Error parsing stepsize options: " << e.what() << std::endl;
         return false;
@@ -289,18 +670,60 @@ bool parseStepsizeOptions(const std::map<std::string, std::string>& config, Step
 
 bool parseRegSmoothOptions(const std::map<std::string, std::string>& config, RegSmoothOptions& opts) {
     try {
-        // Use default values from config - similar to stepsize workaround  
-        opts.k_reg = 3;      // From config: "k_reg": 3
-        opts.s_reg = 10.0;   // From config: "s_reg": 10
+        auto it = config.find("GENERAL_OPTIONS.reg_smooth_opts.k_reg");
+        if (it != config.end()) {
+            opts.k_reg = std::stoi(it->second);
+        }
+        
+        it = config.find("GENERAL_OPTIONS.reg_smooth_opts.s_reg");
+        if (it != config.end()) {
+            opts.s_reg = std::stod(it->second);
+        }
         
         std::cout << "Using reg_smooth values: k_reg=" << opts.k_reg << ", s_reg=" << opts.s_reg << std::endl;
         
         return true;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Error parsing reg smooth options: " << e.what() << std::endl;
         return false;
     }
 }
 
-} // namespace global_racetrajectory_optimization::utils
\ No newline at end of file
+bool parseCurvCalcOptions(const std::map<std::string, std::string>& config, CurvCalcOptions& opts) {
+    try {
+        auto get_double = [&config](const std::string& key, double default_val) -> double {
+            auto it = config.find(key);
+            if (it != config.end() && !it->second.empty()) {
+                try {
+                    return std::stod(it->second);
+                } catch (const std::exception&) {
+                    // Invalid number, use default
+                }
+            }
+            return default_val;
+        };
+        
+        opts.d_preview_curv = get_double("GENERAL_OPTIONS.curv_calc_opts.d_preview_curv", opts.d_preview_curv);
+        opts.d_preview_curv = get_double("curv_calc_opts.d_preview_curv", opts.d_preview_curv);
+        
+        opts.d_review_curv = get_double("GENERAL_OPTIONS.curv_calc_opts.d_review_curv", opts.d_review_curv);
+        opts.d_review_curv = get_double("curv_calc_opts.d_review_curv", opts.d_review_curv);
+        
+        opts.d_preview_head = get_double("GENERAL_OPTIONS.curv_calc_opts.d_preview_head", opts.d_preview_head);
+        opts.d_preview_head = get_double("curv_calc_opts.d_preview_head", opts.d_preview_head);
+        
+        opts.d_review_head = get_double("GENERAL_OPTIONS.curv_calc_opts.d_review_head", opts.d_review_head);
+        opts.d_review_head = get_double("curv_calc_opts.d_review_head", opts.d_review_head);
+        
+        return true;
+    
+    } catch (const std::exception& e) {
+        std::cerr << "Error parsing curvature calculation options: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+} // namespace utils
+
+} // namespace global_racetrajectory_optimization
@@ -0,0 +1,278 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace global_racetrajectory_optimization {
+
+MappedFile::MappedFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+    
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        ::madvise(addr, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(addr);
+    }
+    
+    // The mapping stays valid after closing the descriptor
+    ::close(fd);
+    open_ = true;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), open_(other.open_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data_ = other.data_;
+        size_ = other.size_;
+        open_ = other.open_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+namespace utils {
+
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Data lines start with a number (after optional whitespace), everything before the first one is header
+bool isDataLine(const char* begin, const char* end) {
+    while (begin < end && isBlank(*begin)) {
+        ++begin;
+    }
+    if (begin == end || *begin == '#') {
+        return false;
+    }
+    return (*begin >= '0' && *begin <= '9') || *begin == '-' || *begin == '+' || *begin == '.';
+}
+
+const char* lineEnd(const char* begin, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+    return newline ? newline : end;
+}
+
+// Cells of one line, a trailing delimiter at the end of the line is ignored
+int countCells(const char* begin, const char* end, char delimiter) {
+    while (end > begin && isBlank(end[-1])) {
+        --end;
+    }
+    if (end > begin && end[-1] == delimiter) {
+        --end;
+    }
+    return 1 + static_cast<int>(std::count(begin, end, delimiter));
+}
+
+[[noreturn]] void throwParseError(const std::string& source, size_t line_number, const std::string& message) {
+    throw std::runtime_error(source + ":" + std::to_string(line_number) + ": " + message);
+}
+
+// Parses complete lines starting at line first_line. n_cols == 0: header lines before the first data line are
+// skipped and the column count is taken from it, otherwise every non-comment line must be a data line
+MatrixXd parseLines(const char* data, size_t size, char delimiter, const std::string& source, size_t first_line,
+                    int& n_cols) {
+    const char* end = data + size;
+    
+    // Upper bound of the row count, so that cells are written into their final column-major position directly
+    size_t n_lines = static_cast<size_t>(std::count(data, end, '\n')) + 1;
+    
+    const char* pos = data;
+    size_t line_number = first_line;
+    size_t n_skipped = 0;
+    
+    // Header and comment lines before the first data line
+    while (n_cols == 0 && pos < end) {
+        const char* eol = lineEnd(pos, end);
+        if (isDataLine(pos, eol)) {
+            n_cols = countCells(pos, eol, delimiter);
+            break;
+        }
+        pos = (eol < end) ? eol + 1 : end;
+        line_number++;
+        n_skipped++;
+    }
+    
+    if (n_cols == 0) {
+        return MatrixXd();
+    }
+    
+    MatrixXd table(static_cast<Eigen::Index>(n_lines - n_skipped), n_cols);
+    Eigen::Index n_rows_cap = table.rows();
+    double* out = table.data();
+    Eigen::Index row = 0;
+    
+    while (pos < end) {
+        const char* eol = lineEnd(pos, end);
+        const char* cell = pos;
+        
+        while (cell < eol && isBlank(*cell)) {
+            ++cell;
+        }
+        
+        // Blank and comment lines
+        if (cell == eol || *cell == '#') {
+            pos = (eol < end) ? eol + 1 : end;
+            line_number++;
+            continue;
+        }
+        
+        int col = 0;
+        while (true) {
+            while (cell < eol && isBlank(*cell)) {
+                ++cell;
+            }
+            if (cell < eol && *cell == '+') {
+                ++cell;
+            }
+            
+            if (col >= n_cols) {
+                throwParseError(source, line_number, "expected " + std::to_string(n_cols) + " cells");
+            }
+            
+            double value;
+            std::from_chars_result res = std::from_chars(cell, eol, value);
+            if (res.ec != std::errc()) {
+                const char* cell_end = std::find(cell, eol, delimiter);
+                throwParseError(source, line_number, "cannot parse cell " + std::to_string(col + 1) + " '"
+                                + std::string(cell, cell_end) + "'");
+            }
+            out[static_cast<Eigen::Index>(col) * n_rows_cap + row] = value;
+            col++;
+            
+            cell = res.ptr;
+            while (cell < eol && isBlank(*cell)) {
+                ++cell;
+            }
+            if (cell == eol) {
+                break;
+            }
+            if (*cell != delimiter) {
+                const char* cell_end = std::find(cell, eol, delimiter);
+                throwParseError(source, line_number, "unexpected characters '" + std::string(cell, cell_end)
+                                + "' in cell " + std::to_string(col));
+            }
+            ++cell;
+            
+            // Trailing delimiter
+            const char* rest = cell;
+            while (rest < eol && isBlank(*rest)) {
+                ++rest;
+            }
+            if (rest == eol) {
+                break;
+            }
+        }
+        
+        if (col != n_cols) {
+            throwParseError(source, line_number, "expected " + std::to_string(n_cols) + " cells, found "
+                            + std::to_string(col));
+        }
+        
+        row++;
+        pos = (eol < end) ? eol + 1 : end;
+        line_number++;
+    }
+    
+    if (row < n_rows_cap) {
+        table.conservativeResize(row, Eigen::NoChange);
+    }
+    
+    return table;
+}
+
+} // namespace
+
+MatrixXd parseCSV(const char* data, size_t size, char delimiter, const std::string& source) {
+    int n_cols = 0;
+    return parseLines(data, size, delimiter, source, 1, n_cols);
+}
+
+MatrixXd readCSV(const std::string& filename, char delimiter) {
+    MappedFile file(filename);
+    return parseCSV(file.data(), file.size(), delimiter, filename);
+}
+
+} // namespace utils
+
+CsvChunkReader::CsvChunkReader(const std::string& filename, char delimiter, size_t chunk_bytes)
+    : file_(filename, std::ios::binary), source_(filename), delimiter_(delimiter),
+      chunk_bytes_(std::max<size_t>(chunk_bytes, 4096)) {
+    if (!file_.is_open()) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+}
+
+MatrixXd CsvChunkReader::next() {
+    while (!done()) {
+        // Carry-over of the last partial line plus the next block of the file
+        std::string block = std::move(carry_);
+        carry_.clear();
+        size_t n_old = block.size();
+        block.resize(n_old + chunk_bytes_);
+        file_.read(&block[n_old], static_cast<std::streamsize>(chunk_bytes_));
+        block.resize(n_old + static_cast<size_t>(file_.gcount()));
+        
+        // Only complete lines are parsed, the file end completes the last one
+        size_t cut = block.size();
+        if (!file_.eof()) {
+            size_t last_newline = block.rfind('\n');
+            cut = (last_newline == std::string::npos) ? 0 : last_newline + 1;
+        }
+        carry_.assign(block, cut, std::string::npos);
+        
+        MatrixXd rows = utils::parseLines(block.data(), cut, delimiter_, source_, line_number_, n_cols_);
+        line_number_ += static_cast<size_t>(std::count(block.data(), block.data() + cut, '\n'));
+        
+        if (rows.rows() > 0) {
+            return rows;
+        }
+    }
+    
+    return MatrixXd();
+}
+
+} // namespace global_racetrajectory_optimization
@@ -0,0 +1,83 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace global_racetrajectory_optimization {
+
+namespace {
+
+// Longest number std::to_chars writes for a double (shortest or up to 17 significant digits)
+constexpr size_t MAX_NUMBER_CHARS = 32;
+
+} // namespace
+
+CsvWriter::CsvWriter(const std::string& filename, int precision, char delimiter, size_t buffer_size)
+    : file_(filename, std::ios::binary | std::ios::trunc),
+      buffer_(std::max<size_t>(buffer_size, 4 * MAX_NUMBER_CHARS)),
+      precision_(std::min(precision, 17)),
+      delimiter_(delimiter) {}
+
+CsvWriter::~CsvWriter() {
+    close();
+}
+
+void CsvWriter::put(char c) {
+    if (used_ == buffer_.size()) {
+        flush();
+    }
+    buffer_[used_++] = c;
+}
+
+void CsvWriter::flush() {
+    if (used_ > 0 && file_.is_open()) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(used_));
+    }
+    used_ = 0;
+}
+
+void CsvWriter::writeText(const std::string& text) {
+    if (text.size() > buffer_.size() - used_) {
+        flush();
+    }
+    if (text.size() > buffer_.size()) {
+        file_.write(text.data(), static_cast<std::streamsize>(text.size()));
+        return;
+    }
+    std::memcpy(buffer_.data() + used_, text.data(), text.size());
+    used_ += text.size();
+}
+
+void CsvWriter::writeValue(double value) {
+    if (buffer_.size() - used_ < MAX_NUMBER_CHARS) {
+        flush();
+    }
+    
+    char* first = buffer_.data() + used_;
+    char* last = buffer_.data() + buffer_.size();
+    std::to_chars_result res = (precision_ > 0) ? std::to_chars(first, last, value, std::chars_format::general, precision_)
+                                                : std::to_chars(first, last, value);
+    used_ = static_cast<size_t>(res.ptr - buffer_.data());
+}
+
+void CsvWriter::writeRow(const MatrixXd& data, int row) {
+    for (int j = 0; j < data.cols(); ++j) {
+        if (j > 0) {
+            writeSeparator();
+        }
+        writeValue(data(row, j));
+    }
+    endRow();
+}
+
+bool CsvWriter::close() {
+    if (!file_.is_open()) {
+        return false;
+    }
+    
+    flush();
+    file_.close();
+    return !file_.fail();
+}
+
+} // namespace global_racetrajectory_optimization
@@ -0,0 +1,154 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization::utils {
+
+CorridorDistanceField calculateCorridorDistanceField(const TrackData& track, const TrackBoundaries& boundaries,
+                                                     double d_alpha, int n_threads) {
+    ConstMatrixMap reftrack = track.reftrack();
+    int n_points = reftrack.rows();
+    
+    if (n_points < 2 || reftrack.cols() < 4 || track.normvectors.rows() != n_points) {
+        throw std::runtime_error("Corridor distance field requires a prepared track");
+    }
+    
+    if (d_alpha <= 0.0) {
+        throw std::runtime_error("Corridor distance field resolution must be positive");
+    }
+    
+    // Common lateral range of all points, so that the field is one dense matrix (alpha = 0 lies on the grid)
+    CorridorDistanceField field;
+    field.d_alpha = d_alpha;
+    field.alpha_min = -std::ceil(reftrack.col(2).maxCoeff() / d_alpha) * d_alpha;
+    double alpha_max = reftrack.col(3).maxCoeff();
+    int n_alpha = static_cast<int>(std::ceil((alpha_max - field.alpha_min) / d_alpha)) + 1;
+    
+    field.distance.resize(n_points, n_alpha);
+    
+    trajectory_planning_helpers::parallel_for(n_points, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Vector2d point = reftrack.row(i).head<2>().transpose();
+            Vector2d normal = track.normvectors.row(i).transpose();
+            
+            // Exact distances within the own corridor of the point (plus one sample), beyond it only the distance
+            // along the normal is stored, which is enough to mark these samples as outside
+            double alpha_lo = -reftrack(i, 2) - d_alpha;
+            double alpha_hi = reftrack(i, 3) + d_alpha;
+            
+            for (int j = 0; j < n_alpha; ++j) {
+                double alpha = field.alpha_min + j * d_alpha;
+                if (alpha < alpha_lo) {
+                    field.distance(i, j) = alpha - alpha_lo - d_alpha;
+                } else if (alpha > alpha_hi) {
+                    field.distance(i, j) = alpha_hi - alpha - d_alpha;
+                } else {
+                    field.distance(i, j) = boundaries.query(point + alpha * normal).signed_distance;
+                }
+            }
+        }
+    }, n_threads, 64);
+    
+    return field;
+}
+
+MatrixXd calculateFootprintBounds(const TrackData& track, const CorridorDistanceField& field,
+                                  const VehicleParameters& veh_params, double margin) {
+    ConstMatrixMap reftrack = track.reftrack();
+    int n_points = field.distance.rows();
+    int n_alpha = field.distance.cols();
+    
+    if (n_points != reftrack.rows() || n_alpha < 2) {
+        throw std::runtime_error("Corridor distance field does not match the track");
+    }
+    
+    // Cover the vehicle rectangle with n_circles circles along its length axis
+    int n_circles = std::max(1, static_cast<int>(std::ceil(veh_params.length / veh_params.width)));
+    double half_length_circle = 0.5 * veh_params.length / n_circles;
+    double radius = std::sqrt(0.25 * veh_params.width * veh_params.width + half_length_circle * half_length_circle)
+                    + margin;
+    
+    double el_length_mean = (track.el_lengths.size() > 0) ? track.el_lengths.mean() : 1.0;
+    
+    // Clearance of every circle for a vehicle aligned with the reference line: circle c at a longitudinal offset maps
+    // onto the field row shifted by the corresponding number of points (closed track)
+    Eigen::ArrayXXd clearance = field.distance.array() - radius;
+    
+    for (int c = 0; c < n_circles; ++c) {
+        double offset = -0.5 * veh_params.length + (2 * c + 1) * half_length_circle;
+        int shift = static_cast<int>(std::round(offset / el_length_mean));
+        shift = ((shift % n_points) + n_points) % n_points;
+        
+        if (shift == 0) {
+            continue;
+        }
+        
+        Eigen::ArrayXXd shifted(n_points, n_alpha);
+        shifted.topRows(n_points - shift) = field.distance.bottomRows(n_points - shift).array();
+        shifted.bottomRows(shift) = field.distance.topRows(shift).array();
+        clearance = clearance.min(shifted - radius);
+    }
+    
+    // Largest feasible interval around alpha = 0 per point (boundaries interpolated between samples), never wider than
+    // the own track widths shrunk by the footprint radius
+    MatrixXd bounds(n_points, 2);
+    int j_zero = std::clamp(static_cast<int>(std::round(-field.alpha_min / field.d_alpha)), 0, n_alpha - 1);
+    
+    auto alpha_at = [&field](int j) { return field.alpha_min + j * field.d_alpha; };
+    
+    for (int i = 0; i < n_points; ++i) {
+        if (clearance(i, j_zero) < 0.0) {
+            // Vehicle does not fit at the reference line, collapse the bounds onto the best lateral position
+            Eigen::Index j_best;
+            clearance.row(i).maxCoeff(&j_best);
+            bounds(i, 0) = bounds(i, 1) = alpha_at(static_cast<int>(j_best));
+            continue;
+        }
+        
+        int j_hi = j_zero;
+        while (j_hi + 1 < n_alpha && clearance(i, j_hi + 1) >= 0.0) {
+            j_hi++;
+        }
+        bounds(i, 1) = alpha_at(j_hi);
+        if (j_hi + 1 < n_alpha) {
+            bounds(i, 1) += field.d_alpha * clearance(i, j_hi) / (clearance(i, j_hi) - clearance(i, j_hi + 1));
+        }
+        
+        int j_lo = j_zero;
+        while (j_lo - 1 >= 0 && clearance(i, j_lo - 1) >= 0.0) {
+            j_lo--;
+        }
+        bounds(i, 0) = alpha_at(j_lo);
+        if (j_lo - 1 >= 0) {
+            bounds(i, 0) -= field.d_alpha * clearance(i, j_lo) / (clearance(i, j_lo) - clearance(i, j_lo - 1));
+        }
+        
+        bounds(i, 0) = std::max(bounds(i, 0), std::min(0.0, radius - reftrack(i, 2)));
+        bounds(i, 1) = std::min(bounds(i, 1), std::max(0.0, reftrack(i, 3) - radius));
+    }
+    
+    return bounds;
+}
+
+int applyFootprintBounds(MatrixXd& reftrack, const MatrixXd& bounds) {
+    if (bounds.rows() != reftrack.rows() || bounds.cols() != 2 || reftrack.cols() < 4) {
+        throw std::runtime_error("Footprint bounds do not match the track");
+    }
+    
+    // Collapsed bounds away from the reference line would give a negative width on one side, which the QP cannot
+    // satisfy at alpha = 0
+    int n_clamped = 0;
+    for (int i = 0; i < reftrack.rows(); ++i) {
+        if (bounds(i, 0) > 0.0 || bounds(i, 1) < 0.0) {
+            n_clamped++;
+        }
+        reftrack(i, 2) = std::max(-bounds(i, 0), 0.0);
+        reftrack(i, 3) = std::max(bounds(i, 1), 0.0);
+    }
+    
+    return n_clamped;
+}
+
+} // namespace global_racetrajectory_optimization::utils
@@ -2,13 +2,29 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <algorithm>
 #include <cmath>
 #include <chrono>
+#include <vector>
 
 namespace global_racetrajectory_optimization {
 
+namespace {
+
+// Changes whenever the table layout expected by loadVehicleDynamics changes
+constexpr uint32_t TABLES_KEY_VERSION = 1;
+
+// Changes whenever a pipeline stage computes different results for the same inputs, so that no cache entry of an
+// older build is used
+constexpr uint32_t PIPELINE_VERSION = 1;
+
+// Cache key of a pipeline stage from its options and the key of the stage it starts from
+uint64_t stageKey(const std::vector<double>& values, uint64_t seed) {
+    return utils::hashValues(values, utils::hashBytes(&PIPELINE_VERSION, sizeof(PIPELINE_VERSION), seed));
+}
+
+} // namespace
+
 GlobalRaceTrajectoryOptimizer::GlobalRaceTrajectoryOptimizer() 
     : config_loaded_(false), track_loaded_(false), veh_dynamics_loaded_(false), track_prepared_(false) {
     // Initialize with default values
@@ -18,17 +34,15 @@ GlobalRaceTrajectoryOptimizer::~GlobalRaceTrajectoryOptimizer() = default;
 
 bool GlobalRaceTrajectoryOptimizer::loadConfig(const std::string& config_file) {
     try {
-        auto config_map = utils::parseConfigFile(config_file);
+        Config config(config_file);
         
-        if (!utils::parseVehicleParams(config_map, veh_params_) ||
-            !utils::parseOptimizationOptions(config_map, optim_opts_) ||
-            !utils::parseStepsizeOptions(config_map, stepsize_opts_) ||
-            !utils::parseRegSmoothOptions(config_map, reg_smooth_opts_)) {
-            return false;
-        }
+        std::cout << "Using stepsize values: prep=" << config.stepsize.stepsize_prep
+                  << ", reg=" << config.stepsize.stepsize_reg
+                  << ", interp=" << config.stepsize.stepsize_interp_after_opt << std::endl;
+        std::cout << "Using reg_smooth values: k_reg=" << config.reg_smooth.k_reg
+                  << ", s_reg=" << config.reg_smooth.s_reg << std::endl;
         
-        config_loaded_ = validateConfiguration();
-        return config_loaded_;
+        return applyConfig(config);
         
     } catch (const std::exception& e) {
         std::cerr << "Error loading config: " << e.what() << std::endl;
@@ -36,25 +50,75 @@ bool GlobalRaceTrajectoryOptimizer::loadConfig(const std::string& config_file) {
     }
 }
 
+bool GlobalRaceTrajectoryOptimizer::applyConfig(const Config& config) {
+    // A prepared track stays valid unless the options its preparation depends on changed
+    if (track_prepared_ && utils::hashPreparationOptions(config.stepsize, config.reg_smooth)
+                           != utils::hashPreparationOptions(stepsize_opts_, reg_smooth_opts_)) {
+        track_prepared_ = false;
+    }
+    
+    veh_params_ = config.vehicle;
+    optim_opts_ = config.optimization;
+    stepsize_opts_ = config.stepsize;
+    reg_smooth_opts_ = config.reg_smooth;
+    curv_calc_opts_ = config.curv_calc;
+    
+    config_loaded_ = validateConfiguration();
+    return config_loaded_;
+}
+
+void GlobalRaceTrajectoryOptimizer::setPendingConfig(const Config& config) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_config_ = config;
+}
+
+bool GlobalRaceTrajectoryOptimizer::applyPendingConfig(bool reprepare) {
+    std::optional<Config> config;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        config.swap(pending_config_);
+    }
+    if (!config) {
+        return true;
+    }
+    
+    bool was_prepared = track_prepared_;
+    if (!applyConfig(*config)) {
+        std::cerr << "Pending config from " << config->source() << " is invalid" << std::endl;
+        return false;
+    }
+    std::cout << "Config applied: " << config->source() << std::endl;
+    
+    if (reprepare && was_prepared && !track_prepared_) {
+        return prepareTrack(false);
+    }
+    return true;
+}
+
 bool GlobalRaceTrajectoryOptimizer::loadTrack(const std::string& track_file) {
     try {
-        track_data_.reftrack = utils::importTrack(track_file);
+        MatrixXd reftrack = utils::importTrack(track_file);
         
-        if (track_data_.reftrack.rows() == 0) {
+        if (reftrack.rows() == 0) {
             std::cerr << "Failed to load track data" << std::endl;
             return false;
         }
         
-        if (!utils::checkTrackValidity(track_data_.reftrack)) {
+        if (!utils::checkTrackValidity(reftrack)) {
             std::cerr << "Invalid track data" << std::endl;
             return false;
         }
         
+        track_data_.setReftrack(reftrack);
+        raw_reftrack_ = track_data_.reftrackTables();
         track_data_.track_name = track_file;
+        track_data_.source_hash = utils::hashFile(track_file);
+        start_point_.reset();
+        reversed_ = false;
         track_loaded_ = true;
         track_prepared_ = false;  // Need to prepare track after loading
         
-        std::cout << "Track loaded: " << track_data_.reftrack.rows() << " points" << std::endl;
+        std::cout << "Track loaded: " << reftrack.rows() << " points" << std::endl;
         return true;
         
     } catch (const std::exception& e) {
@@ -65,17 +129,51 @@ bool GlobalRaceTrajectoryOptimizer::loadTrack(const std::string& track_file) {
 
 bool GlobalRaceTrajectoryOptimizer::loadVehicleDynamics(const std::string& ggv_file, const std::string& ax_max_file) {
     try {
-        ggv_data_ = loadCSV(ggv_file);
-        ax_max_machines_ = loadCSV(ax_max_file);
+        // Tables are identified by the contents of both input files, a shared file written for them by another
+        // process is mapped as it is
+        uint64_t file_hashes[2] = {utils::hashFile(ggv_file), utils::hashFile(ax_max_file)};
+        uint64_t key = utils::hashBytes(&TABLES_KEY_VERSION, sizeof(TABLES_KEY_VERSION));
+        key = utils::hashBytes(file_hashes, sizeof(file_hashes), key);
+        
+        std::shared_ptr<SharedTables> tables;
+        if (!shared_table_file_.empty()) {
+            try {
+                tables = std::make_shared<SharedTables>(shared_table_file_);
+                if (tables->key() != key || !tables->contains("ggv") || !tables->contains("ax_max_machines")) {
+                    tables.reset();
+                }
+            } catch (const std::exception&) {
+                tables.reset();
+            }
+        }
         
-        if (ggv_data_.rows() == 0 || ax_max_machines_.rows() == 0) {
-            std::cerr << "Failed to load vehicle dynamics data" << std::endl;
-            return false;
+        if (!tables) {
+            MatrixXd ggv = loadCSV(ggv_file);
+            MatrixXd ax_max = loadCSV(ax_max_file);
+            
+            if (ggv.rows() == 0 || ax_max.rows() == 0) {
+                std::cerr << "Failed to load vehicle dynamics data" << std::endl;
+                return false;
+            }
+            
+            tables = std::make_shared<SharedTables>(SharedTables::create(
+                {{"ggv", std::move(ggv)}, {"ax_max_machines", std::move(ax_max)}}, key, shared_table_file_));
         }
         
+        // The getters map the tables held by input_tables_
+        input_tables_ = tables;
+        ConstMatrixMap ggv = tables->table("ggv");
+        ConstMatrixMap ax_max = tables->table("ax_max_machines");
+        ggv_data_ = ggv.data();
+        ggv_rows_ = ggv.rows();
+        ggv_cols_ = ggv.cols();
+        ax_max_data_ = ax_max.data();
+        ax_max_rows_ = ax_max.rows();
+        ax_max_cols_ = ax_max.cols();
+        
         veh_dynamics_loaded_ = true;
-        std::cout << "Vehicle dynamics loaded: GGV (" << ggv_data_.rows() << " points), "
-                  << "Ax_max (" << ax_max_machines_.rows() << " points)" << std::endl;
+        std::cout << "Vehicle dynamics loaded: GGV (" << ggv_rows_ << " points), "
+                  << "Ax_max (" << ax_max_rows_ << " points)" << std::endl;
         return true;
         
     } catch (const std::exception& e) {
@@ -85,19 +183,49 @@ bool GlobalRaceTrajectoryOptimizer::loadVehicleDynamics(const std::string& ggv_f
 }
 
 bool GlobalRaceTrajectoryOptimizer::prepareTrack(bool debug) {
+    applyPendingConfig(false);
+    
     if (!track_loaded_) {
         std::cerr << "Track not loaded" << std::endl;
         return false;
     }
     
     try {
+        uint64_t options_hash = utils::hashPreparationOptions(stepsize_opts_, reg_smooth_opts_);
+        uint64_t track_hashes[2] = {track_data_.source_hash, options_hash};
+        track_key_ = utils::hashBytes(track_hashes, sizeof(track_hashes),
+                                      utils::hashBytes(&PIPELINE_VERSION, sizeof(PIPELINE_VERSION)));
+        
+        // With an artifact cache the snapshot is the cache entry of the track stage
+        std::string snapshot_file = cache_ ? cache_->path("track", track_key_) : snapshot_file_;
+        
+        // The reference track of a snapshot is used from the mapping in the cache when another process already
+        // published it there
+        std::shared_ptr<const SharedTables> reftrack_tables = cache_ ? cache_->load("reftrack", track_key_) : nullptr;
+        if (!snapshot_file.empty() && utils::loadTrackSnapshot(snapshot_file, track_data_.source_hash, options_hash,
+                                                               track_data_, reftrack_tables)) {
+            track_prepared_ = true;
+            shareReftrack();
+            restoreStartAndDirection();
+            
+            if (debug) {
+                std::cout << "Track preparation loaded from snapshot: " << track_data_.reftrack().rows() << " points"
+                          << std::endl;
+            }
+            return true;
+        }
+        
         if (debug) {
             std::cout << "Preparing track..." << std::endl;
         }
         
-        // Smooth and interpolate track using trajectory_planning_helpers
+        // Smooth and interpolate track using trajectory_planning_helpers, the track widths (and any further
+        // per-point channels) are resampled together with the centerline (reftrack is passed as a zero-copy
+        // transposed view with one point per column). Preparation always starts from the imported track, so a track
+        // prepared again for new options is not resampled twice (a moved start point and a reversed direction are
+        // applied again afterwards)
         auto [track_smoothed, el_lengths] = trajectory_planning_helpers::spline_approximation(
-            track_data_.reftrack.block(0, 0, track_data_.reftrack.rows(), 2).transpose(),
+            trajectory_planning_helpers::transposed_view(raw_reftrack_->table("reftrack")),
             reg_smooth_opts_.k_reg,
             reg_smooth_opts_.s_reg,
             stepsize_opts_.stepsize_prep,
@@ -106,22 +234,18 @@ bool GlobalRaceTrajectoryOptimizer::prepareTrack(bool debug) {
         );
         
         // Update track data with smoothed version
-        track_data_.reftrack.resize(track_smoothed.rows(), 4);
-        track_data_.reftrack.block(0, 0, track_smoothed.rows(), 2) = track_smoothed;
-        
-        // Interpolate track widths (simplified - keep original widths)
-        // In a full implementation, you would interpolate the width data as well
+        track_data_.setReftrack(track_smoothed);
         
         // Calculate splines
         trajectory_planning_helpers::Matrix2Xd refpath_cl(2, track_smoothed.rows() + 1);
-        refpath_cl.leftCols(track_smoothed.rows()) = track_smoothed.transpose();
-        refpath_cl.rightCols(1) = track_smoothed.row(0).transpose(); // Close the path
+        refpath_cl.leftCols(track_smoothed.rows()) = track_smoothed.leftCols(2).transpose();
+        refpath_cl.rightCols(1) = track_smoothed.row(0).head(2).transpose(); // Close the path
         
         // Adjust el_lengths for closed path - add closing segment length
         VectorXd el_lengths_closed(el_lengths.size() + 1);
         el_lengths_closed.head(el_lengths.size()) = el_lengths;
         // Calculate length from last point back to first point
-        el_lengths_closed(el_lengths.size()) = (track_smoothed.row(0) - track_smoothed.row(track_smoothed.rows() - 1)).norm();
+        el_lengths_closed(el_lengths.size()) = (track_smoothed.row(0).head(2) - track_smoothed.row(track_smoothed.rows() - 1).head(2)).norm();
         
         auto [coeffs_x, coeffs_y, a_interp, normvectors] = trajectory_planning_helpers::calc_splines(
             refpath_cl, el_lengths_closed, 0.0, 0.0, true
@@ -134,10 +258,20 @@ bool GlobalRaceTrajectoryOptimizer::prepareTrack(bool debug) {
         track_data_.normvectors = normvectors;
         track_data_.el_lengths = el_lengths_closed;
         
+        // Spatial index over the reference line segments, reused by all later path matching queries
+        track_data_.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+            trajectory_planning_helpers::transposed_view(track_data_.reftrack().leftCols(2)), true);
+        
         track_prepared_ = true;
+        shareReftrack();
+        
+        if (!snapshot_file.empty() && !utils::saveTrackSnapshot(track_data_, options_hash, snapshot_file)) {
+            std::cerr << "Warning: Could not write track snapshot" << std::endl;
+        }
+        restoreStartAndDirection();
         
         if (debug) {
-            std::cout << "Track preparation completed: " << track_data_.reftrack.rows() 
+            std::cout << "Track preparation completed: " << track_data_.reftrack().rows() 
                       << " points, " << track_data_.normvectors.rows() << " normal vectors" << std::endl;
         }
         
@@ -149,10 +283,94 @@ bool GlobalRaceTrajectoryOptimizer::prepareTrack(bool debug) {
     }
 }
 
+void GlobalRaceTrajectoryOptimizer::restoreStartAndDirection() {
+    // The snapshot and the cache entries keep the track as prepared, the start point is moved on the new points first
+    // and the direction reversed after that (the same arrays as for either order of the original calls)
+    track_data_.start_index = 0;
+    if (start_point_) {
+        int offset = utils::setNewStartPoint(track_data_, *start_point_).offset();
+        if (offset != 0) {
+            utils::rotateTrackData(track_data_, offset);
+            track_key_ = utils::hashBytes(&offset, sizeof(offset), track_key_);
+        }
+    }
+    if (reversed_) {
+        utils::reverseTrackData(track_data_);
+        track_key_ = utils::hashBytes("reversed", 8, track_key_);
+    }
+    if (start_point_ || reversed_) {
+        shareReftrack();
+    }
+}
+
+void GlobalRaceTrajectoryOptimizer::shareReftrack() {
+    // Without a cache the reference track stays in its anonymous memfd (shared with forked processes only)
+    if (!cache_) {
+        return;
+    }
+    
+    ConstMatrixMap reftrack = track_data_.reftrack();
+    std::shared_ptr<const SharedTables> tables = cache_->load("reftrack", track_key_);
+    if (!tables && cache_->store("reftrack", track_key_, {{"reftrack", reftrack}})) {
+        tables = cache_->load("reftrack", track_key_);
+    }
+    
+    if (tables && tables->contains("reftrack") && tables->table("reftrack").rows() == reftrack.rows()
+        && tables->table("reftrack").cols() == reftrack.cols()) {
+        track_data_.setReftrack(tables);
+    }
+}
+
+void GlobalRaceTrajectoryOptimizer::setArtifactCache(const std::string& directory) {
+    cache_ = directory.empty() ? nullptr : std::make_shared<const ArtifactCache>(directory);
+}
+
+TrackView GlobalRaceTrajectoryOptimizer::setStartPoint(const Vector2d& new_start) {
+    if (!track_prepared_) {
+        std::cerr << "Track not prepared" << std::endl;
+        return TrackView();
+    }
+    
+    // The prepared arrays are rotated once, so that the optimizers, exports, caches and telemetry all see the track
+    // starting at the new start/finish line (the track is not prepared again)
+    try {
+        int offset = utils::setNewStartPoint(track_data_, new_start).offset();
+        if (offset != 0) {
+            utils::rotateTrackData(track_data_, offset);
+            track_key_ = utils::hashBytes(&offset, sizeof(offset), track_key_);
+            shareReftrack();
+        }
+        start_point_ = new_start;
+    } catch (const std::exception& e) {
+        std::cerr << "Error setting start point: " << e.what() << std::endl;
+    }
+    return TrackView(track_data_.reftrack());
+}
+
+bool GlobalRaceTrajectoryOptimizer::reverseDirection() {
+    if (!track_prepared_) {
+        std::cerr << "Track not prepared" << std::endl;
+        return false;
+    }
+    
+    try {
+        // Splines and normal vectors are transformed, the smoothing is not repeated
+        utils::reverseTrackData(track_data_);
+        track_key_ = utils::hashBytes("reversed", 8, track_key_);
+        shareReftrack();
+        reversed_ = !reversed_;
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Error reversing track: " << e.what() << std::endl;
+        return false;
+    }
+}
+
 OptimizationResult GlobalRaceTrajectoryOptimizer::optimizeShortestPath() {
     OptimizationResult result;
     result.success = false;
     
+    applyPendingConfig(true);
     if (!track_prepared_) {
         result.message = "Track not prepared";
         return result;
@@ -160,38 +378,30 @@ OptimizationResult GlobalRaceTrajectoryOptimizer::optimizeShortestPath() {
     
     try {
         // Simplified shortest path: just use the center line
-        int n_points = track_data_.reftrack.rows();
+        ConstMatrixMap reftrack = track_data_.reftrack();
+        int n_points = reftrack.rows();
         result.alpha_opt = VectorXd::Zero(n_points);
         
         // Calculate arc length
         result.s_opt.resize(n_points);
         result.s_opt(0) = 0.0;
         for (int i = 1; i < n_points; ++i) {
-            auto p1 = track_data_.reftrack.row(i-1).head(2);
-            auto p2 = track_data_.reftrack.row(i).head(2);
+            auto p1 = reftrack.row(i-1).head(2);
+            auto p2 = reftrack.row(i).head(2);
             result.s_opt(i) = result.s_opt(i-1) + (p2 - p1).norm();
         }
         
         // Generate raceline (centerline in this case)
-        result.raceline = track_data_.reftrack.leftCols(2);
+        result.raceline = reftrack.leftCols(2);
         
-        // Calculate curvature and velocity
-        result.kappa_opt = utils::calculateCurvature(result.raceline, track_data_.el_lengths);
+        // Heading and curvature from the splines of the prepared track, then the velocity profile
+        std::tie(result.psi_opt, result.kappa_opt) = utils::calculateSplineHeadingCurvature(
+            track_data_.coeffs_x, track_data_.coeffs_y);
         
-        if (veh_dynamics_loaded_) {
-            // Use trajectory_planning_helpers for velocity profile
-            auto [v_profile, ax_profile] = trajectory_planning_helpers::calc_vel_profile(
-                result.kappa_opt, track_data_.el_lengths, true, 
-                veh_params_.dragcoeff, veh_params_.mass, 
-                ggv_data_.col(0), 1.0, 0.0, 0.0
-            );
-            result.v_opt = v_profile;
-        } else {
-            // Simple constant velocity
-            result.v_opt = VectorXd::Constant(n_points, veh_params_.v_max * 0.5);
-        }
+        uint64_t path_key = stageKey({0.0, curv_calc_opts_.d_preview_curv, curv_calc_opts_.d_review_curv,
+                                      curv_calc_opts_.d_preview_head, curv_calc_opts_.d_review_head}, track_key_);
+        calculateVelocityProfile(result, path_key, 0.5);
         
-        result.lap_time = utils::calculateLapTime(result.v_opt, track_data_.el_lengths);
         result.optimization_time = 0.001; // Minimal time for centerline
         result.success = true;
         result.message = "Shortest path (centerline) completed successfully";
@@ -207,6 +417,7 @@ OptimizationResult GlobalRaceTrajectoryOptimizer::optimizeMinCurvature(bool use_
     OptimizationResult result;
     result.success = false;
     
+    applyPendingConfig(true);
     if (!track_prepared_) {
         result.message = "Track not prepared";
         return result;
@@ -215,38 +426,75 @@ OptimizationResult GlobalRaceTrajectoryOptimizer::optimizeMinCurvature(bool use_
     try {
         auto start_time = std::chrono::high_resolution_clock::now();
         
-        // Use trajectory_planning_helpers minimum curvature optimization
-        auto [alpha_opt, s_opt, opt_time] = trajectory_planning_helpers::opt_min_curv(
-            track_data_.reftrack,
-            track_data_.normvectors,
-            track_data_.a_interp,
-            veh_params_.curvlim,
-            optim_opts_.width_opt,
-            false, false, true, 0.0, 0.0, false, false
-        );
-        
-        result.alpha_opt = alpha_opt;
-        result.s_opt = s_opt;
-        
-        // Calculate raceline
-        result.raceline = utils::calculateRaceline(track_data_.reftrack, track_data_.normvectors, alpha_opt);
-        
-        // Calculate curvature
-        result.kappa_opt = utils::calculateCurvature(result.raceline, track_data_.el_lengths);
-        
-        // Calculate velocity profile
-        if (veh_dynamics_loaded_) {
-            auto [v_profile, ax_profile] = trajectory_planning_helpers::calc_vel_profile(
-                result.kappa_opt, track_data_.el_lengths, true,
-                veh_params_.dragcoeff, veh_params_.mass,
-                ggv_data_.col(0), 1.0, 0.0, 0.0
-            );
-            result.v_opt = v_profile;
+        // Path stage: depends on the prepared track and the options of the path optimization and curvature
+        uint64_t path_key = stageKey({1.0, veh_params_.curvlim, optim_opts_.width_opt,
+                                      optim_opts_.footprint_bounds ? 1.0 : 0.0, optim_opts_.footprint_margin,
+                                      optim_opts_.footprint_dalpha, veh_params_.length, veh_params_.width,
+                                      curv_calc_opts_.d_preview_curv, curv_calc_opts_.d_review_curv,
+                                      curv_calc_opts_.d_preview_head, curv_calc_opts_.d_review_head}, track_key_);
+        std::shared_ptr<const SharedTables> cached = cache_ ? cache_->load("path", path_key) : nullptr;
+        
+        if (cached) {
+            std::cout << "Optimized path loaded from cache" << std::endl;
+            result.alpha_opt = cached->table("alpha");
+            result.s_opt = cached->table("s");
+            result.raceline = cached->table("raceline");
+            result.psi_opt = cached->table("psi");
+            result.kappa_opt = cached->table("kappa");
         } else {
-            result.v_opt = VectorXd::Constant(result.raceline.rows(), veh_params_.v_max * 0.7);
+            // Lateral bounds for the QP: by default opt_min_curv shrinks the track widths by width_opt, with footprint
+            // bounds the widths are replaced once by the admissible shifts of the vehicle footprint (no further shrink)
+            MatrixXd reftrack_footprint;
+            double w_veh = optim_opts_.width_opt;
+            
+            if (optim_opts_.footprint_bounds) {
+                TrackBoundaries boundaries(track_data_);
+                CorridorDistanceField field = utils::calculateCorridorDistanceField(
+                    track_data_, boundaries, optim_opts_.footprint_dalpha);
+                MatrixXd bounds = utils::calculateFootprintBounds(
+                    track_data_, field, veh_params_, optim_opts_.footprint_margin);
+                
+                reftrack_footprint = track_data_.reftrack();
+                int n_clamped = utils::applyFootprintBounds(reftrack_footprint, bounds);
+                if (n_clamped > 0) {
+                    std::cerr << "Warning: Vehicle footprint does not fit at " << n_clamped
+                              << " points, track widths clamped to zero there" << std::endl;
+                }
+                w_veh = 0.0;
+            }
+            
+            ConstMatrixMap reftrack_opt = optim_opts_.footprint_bounds
+                ? ConstMatrixMap(reftrack_footprint.data(), reftrack_footprint.rows(), reftrack_footprint.cols())
+                : track_data_.reftrack();
+            
+            // Use trajectory_planning_helpers minimum curvature optimization (spline matrix passed sparse)
+            auto [alpha_opt, s_opt, opt_time] = trajectory_planning_helpers::opt_min_curv(
+                reftrack_opt,
+                track_data_.normvectors,
+                track_data_.a_interp,
+                veh_params_.curvlim,
+                w_veh,
+                false, false, true, 0.0, 0.0, false, false
+            );
+            
+            result.alpha_opt = alpha_opt;
+            result.s_opt = s_opt;
+            
+            // Calculate raceline
+            result.raceline = utils::calculateRaceline(track_data_.reftrack(), track_data_.normvectors, alpha_opt);
+            
+            // Calculate heading and curvature
+            std::tie(result.psi_opt, result.kappa_opt) = utils::calculateHeadingCurvature(
+                result.raceline, VectorXd(), true, curv_calc_opts_);
+            
+            if (cache_) {
+                cache_->store("path", path_key, {{"alpha", result.alpha_opt}, {"s", result.s_opt},
+                                                 {"raceline", result.raceline}, {"psi", result.psi_opt},
+                                                 {"kappa", result.kappa_opt}});
+            }
         }
         
-        result.lap_time = utils::calculateLapTime(result.v_opt, track_data_.el_lengths);
+        calculateVelocityProfile(result, path_key, 0.7);
         
         auto end_time = std::chrono::high_resolution_clock::now();
         result.optimization_time = std::chrono::duration<double>(end_time - start_time).count();
@@ -254,7 +502,7 @@ OptimizationResult GlobalRaceTrajectoryOptimizer::optimizeMinCurvature(bool use_
         result.success = true;
         result.message = use_iqp ? "Minimum curvature (IQP) completed successfully" 
                                  : "Minimum curvature completed successfully";
-        
+                                 
     } catch (const std::exception& e) {
         result.message = "Error in minimum curvature optimization: " + std::string(e.what());
     }
@@ -280,9 +528,56 @@ bool GlobalRaceTrajectoryOptimizer::exportResult(const OptimizationResult& resul
         return false;
     }
     
+    if (cache_ && result.content_key != 0) {
+        return cache_->materialize("export", utils::hashBytes("csv", 3, result.content_key), ".csv", output_path,
+                                   [&result](const std::string& file) { return utils::exportToCSV(result, file); });
+    }
+    
     return utils::exportToCSV(result, output_path);
 }
 
+void GlobalRaceTrajectoryOptimizer::calculateVelocityProfile(OptimizationResult& result, uint64_t path_key,
+                                                             double v_fallback) {
+    // Velocity stage: depends on the path, the vehicle dynamics tables and the vehicle parameters
+    uint64_t key = stageKey({veh_params_.dragcoeff, veh_params_.mass, veh_params_.v_max, v_fallback,
+                             veh_dynamics_loaded_ ? 1.0 : 0.0}, path_key);
+    if (veh_dynamics_loaded_) {
+        uint64_t tables_key = input_tables_->key();
+        key = utils::hashBytes(&tables_key, sizeof(tables_key), key);
+    }
+    result.content_key = key;
+    
+    std::shared_ptr<const SharedTables> cached = cache_ ? cache_->load("velocity", key) : nullptr;
+    if (cached) {
+        std::cout << "Velocity profile loaded from cache" << std::endl;
+        result.v_opt = cached->table("v");
+        result.ax_opt = cached->table("ax");
+        result.lap_time = cached->table("lap_time")(0, 0);
+        return;
+    }
+    
+    if (veh_dynamics_loaded_) {
+        auto [v_profile, ax_profile] = trajectory_planning_helpers::calc_vel_profile(
+            result.kappa_opt, track_data_.el_lengths, true,
+            veh_params_.dragcoeff, veh_params_.mass,
+            getGGVData().col(0), 1.0, 0.0, 0.0
+        );
+        result.v_opt = v_profile;
+        result.ax_opt = ax_profile;
+    } else {
+        // Constant velocity without vehicle dynamics
+        result.v_opt = VectorXd::Constant(result.raceline.rows(), veh_params_.v_max * v_fallback);
+        result.ax_opt = VectorXd::Zero(result.raceline.rows());
+    }
+    
+    result.lap_time = utils::calculateLapTime(result.v_opt, track_data_.el_lengths);
+    
+    if (cache_) {
+        cache_->store("velocity", key, {{"v", result.v_opt}, {"ax", result.ax_opt},
+                                        {"lap_time", MatrixXd::Constant(1, 1, result.lap_time)}});
+    }
+}
+
 bool GlobalRaceTrajectoryOptimizer::visualizeResult(const OptimizationResult& result) {
     if (!result.success) {
         std::cerr << "Cannot visualize failed optimization result" << std::endl;
@@ -318,63 +613,20 @@ bool GlobalRaceTrajectoryOptimizer::validateConfiguration() {
 }
 
 MatrixXd GlobalRaceTrajectoryOptimizer::loadCSV(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filename);
-    }
-    
-    std::vector<std::vector<double>> data;
-    std::string line;
-    
-    while (std::getline(file, line)) {
-        std::vector<double> row;
-        std::stringstream ss(line);
-        std::string cell;
-        
-        while (std::getline(ss, cell, ',')) {
-            try {
-                row.push_back(std::stod(cell));
-            } catch (const std::exception&) {
-                // Skip non-numeric values
-            }
-        }
-        
-        if (!row.empty()) {
-            data.push_back(row);
-        }
-    }
-    
-    if (data.empty()) {
-        return MatrixXd();
-    }
-    
-    MatrixXd result(data.size(), data[0].size());
-    for (size_t i = 0; i < data.size(); ++i) {
-        for (size_t j = 0; j < data[i].size() && j < data[0].size(); ++j) {
-            result(i, j) = data[i][j];
-        }
-    }
-    
-    return result;
+    return utils::readCSV(filename);
 }
 
-bool GlobalRaceTrajectoryOptimizer::saveCSV(const MatrixXd& data, const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
+bool GlobalRaceTrajectoryOptimizer::saveCSV(const MatrixXd& data, const std::string& filename, int precision) {
+    CsvWriter writer(filename, precision);
+    if (!writer.isOpen()) {
         return false;
     }
     
     for (int i = 0; i < data.rows(); ++i) {
-        for (int j = 0; j < data.cols(); ++j) {
-            file << data(i, j);
-            if (j < data.cols() - 1) {
-                file << ",";
-            }
-        }
-        file << std::endl;
+        writer.writeRow(data, i);
     }
     
-    return true;
+    return writer.close();
 }
 
 } // namespace global_racetrajectory_optimization
\ No newline at end of file
@@ -37,16 +37,21 @@ int main(int argc, char* argv[]) {
             return -1;
         }
         
-        // Load vehicle dynamics
+        // Every stage (prepared track, path, velocity profile, exports) is cached under the hash of its inputs, a
+        // rerun only recomputes the stages after the first changed input
+        optimizer.setArtifactCache("outputs/cache");
+        
+        // Load vehicle dynamics (mapped from the shared table file when concurrent runs already wrote it)
         std::string ggv_file = "inputs/veh_dyn_info/ggv.csv";
         std::string ax_max_file = "inputs/veh_dyn_info/ax_max_machines.csv";
+        optimizer.setSharedTableFile("outputs/cache/vehicle_tables.bin");
         
         std::cout << "Loading vehicle dynamics..." << std::endl;
         if (!optimizer.loadVehicleDynamics(ggv_file, ax_max_file)) {
             std::cout << "Warning: Could not load vehicle dynamics, using defaults" << std::endl;
         }
         
-        // Prepare track
+        // Prepare track (reusing the prepared track of an earlier run if the track file and options are unchanged)
         std::cout << "Preparing track..." << std::endl;
         if (!optimizer.prepareTrack(debug)) {
             std::cerr << "Failed to prepare track!" << std::endl;
@@ -94,11 +99,23 @@ int main(int argc, char* argv[]) {
                 std::cout << "Warning: Could not export results" << std::endl;
             }
             
+            // Input for the local trajectory planner (reference line, normal vectors, widths and raceline)
+            std::string ltpl_file = "outputs/" + track_name + "_" + opt_type + "_traj_ltpl_cl.csv";
+            auto write_ltpl = [&optimizer, &result](const std::string& file) {
+                return utils::exportToLTPL(optimizer.getTrackData(), result, file);
+            };
+            if (optimizer.getArtifactCache()->materialize("export", utils::hashBytes("ltpl", 4, result.content_key),
+                                                           ".csv", ltpl_file, write_ltpl)) {
+                std::cout << "LTPL trajectory exported to: " << ltpl_file << std::endl;
+            } else {
+                std::cout << "Warning: Could not export LTPL trajectory" << std::endl;
+            }
+        
         } else {
             std::cerr << "Optimization failed: " << result.message << std::endl;
             return -1;
         }
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
         return -1;
@@ -0,0 +1,151 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization {
+
+RacelineTable::RacelineTable(const OptimizationResult& result, double ds, double max_horizon) {
+    int n_points = result.raceline.rows();
+    
+    if (n_points < 2 || result.raceline.cols() < 2) {
+        throw std::runtime_error("Raceline table requires a raceline with at least two points");
+    }
+    
+    if (result.kappa_opt.size() != n_points || result.v_opt.size() != n_points) {
+        throw std::runtime_error("Dimension mismatch between raceline and kappa/velocity profiles");
+    }
+    
+    if (ds <= 0.0) {
+        throw std::runtime_error("Raceline table stepsize must be positive");
+    }
+    
+    // Source arc length of every raceline point plus the closing point (same as the first point)
+    VectorXd s_src(n_points + 1);
+    if (result.s_opt.size() == n_points) {
+        s_src.head(n_points) = result.s_opt;
+    } else {
+        s_src(0) = 0.0;
+        for (int i = 1; i < n_points; ++i) {
+            s_src(i) = s_src(i - 1) + (result.raceline.row(i) - result.raceline.row(i - 1)).norm();
+        }
+    }
+    s_src(n_points) = s_src(n_points - 1) + (result.raceline.row(0) - result.raceline.row(n_points - 1)).norm();
+    
+    // The table starts at s = 0 on the first raceline point, also for results whose s_opt does not
+    double s_first = s_src(0);
+    s_src.array() -= s_first;
+    lap_length_ = s_src(n_points);
+    
+    if (lap_length_ <= 0.0) {
+        throw std::runtime_error("Raceline has zero length");
+    }
+    
+    // Source channels, one point per column (heading and acceleration are optional in the result)
+    Samples src(N_CHANNELS, n_points + 1);
+    src.row(S) = s_src.transpose();
+    src.block(X, 0, 2, n_points) = result.raceline.leftCols(2).transpose();
+    src.row(KAPPA).head(n_points) = result.kappa_opt.transpose();
+    src.row(VX).head(n_points) = result.v_opt.transpose();
+    
+    if (result.psi_opt.size() == n_points) {
+        src.row(PSI).head(n_points) = result.psi_opt.transpose();
+    } else {
+        auto [psi, kappa] = utils::calculateHeadingCurvature(
+            result.raceline, (s_src.tail(n_points) - s_src.head(n_points)).eval(), true);
+        src.row(PSI).head(n_points) = psi.transpose();
+    }
+    
+    if (result.ax_opt.size() == n_points) {
+        src.row(AX).head(n_points) = result.ax_opt.transpose();
+    } else {
+        // Derive from the velocity profile: ax = (v_next^2 - v^2) / (2 * el_length)
+        for (int i = 0; i < n_points; ++i) {
+            int i_next = (i + 1) % n_points;
+            double el_length = std::max(s_src(i + 1) - s_src(i), 1e-6);
+            src(AX, i) = (result.v_opt(i_next) * result.v_opt(i_next) - result.v_opt(i) * result.v_opt(i)) / (2.0 * el_length);
+        }
+    }
+    
+    src.block(X, n_points, N_CHANNELS - 1, 1) = src.block(X, 0, N_CHANNELS - 1, 1);
+    
+    // Uniform grid dividing the lap length exactly, so that sample n_lap coincides with sample 0
+    n_lap_ = std::max(2, static_cast<int>(std::round(lap_length_ / ds)));
+    ds_ = lap_length_ / n_lap_;
+    
+    double horizon = (max_horizon > 0.0) ? max_horizon : lap_length_;
+    int n_ext = static_cast<int>(std::ceil(horizon / ds_)) + 1;
+    
+    samples_.resize(N_CHANNELS, n_lap_ + n_ext);
+    
+    // Resample one lap in a single forward sweep over the source points
+    int j = 0;
+    for (int k = 0; k < n_lap_; ++k) {
+        double s = k * ds_;
+        while (j < n_points - 1 && s_src(j + 1) <= s) {
+            j++;
+        }
+        
+        double el_length = s_src(j + 1) - s_src(j);
+        double t = (el_length > 1e-9) ? (s - s_src(j)) / el_length : 0.0;
+        
+        samples_.col(k) = src.col(j) + t * (src.col(j + 1) - src.col(j));
+        samples_(S, k) = k * ds_;
+        samples_(PSI, k) = trajectory_planning_helpers::normalize_psi(
+            src(PSI, j) + t * trajectory_planning_helpers::normalize_psi(src(PSI, j + 1) - src(PSI, j)));
+    }
+    
+    // Horizon extension: repeat the lap with continuing s
+    for (int k = n_lap_; k < n_lap_ + n_ext; ++k) {
+        samples_.col(k) = samples_.col(k % n_lap_);
+        samples_(S, k) = k * ds_;
+    }
+}
+
+double RacelineTable::wrap(double s) const {
+    s = std::fmod(s, lap_length_);
+    return (s < 0.0) ? s + lap_length_ : s;
+}
+
+RacelineTable::Sample RacelineTable::at(double s) const {
+    if (n_lap_ == 0) {
+        throw std::runtime_error("Raceline table is empty");
+    }
+    
+    double s_wrapped = wrap(s);
+    double pos = s_wrapped / ds_;
+    int i = std::min(static_cast<int>(pos), n_lap_ - 1);
+    double t = pos - i;
+    
+    Eigen::Matrix<double, N_CHANNELS, 1> value = samples_.col(i) + t * (samples_.col(i + 1) - samples_.col(i));
+    
+    Sample sample;
+    sample.s = s_wrapped;
+    sample.x = value(X);
+    sample.y = value(Y);
+    sample.psi = trajectory_planning_helpers::normalize_psi(
+        samples_(PSI, i) + t * trajectory_planning_helpers::normalize_psi(samples_(PSI, i + 1) - samples_(PSI, i)));
+    sample.kappa = value(KAPPA);
+    sample.vx = value(VX);
+    sample.ax = value(AX);
+    return sample;
+}
+
+RacelineTable::HorizonView RacelineTable::horizon(double s, double length) const {
+    if (n_lap_ == 0) {
+        throw std::runtime_error("Raceline table is empty");
+    }
+    
+    int i_start = std::min(static_cast<int>(wrap(s) / ds_), n_lap_ - 1);
+    int n_samples = static_cast<int>(std::ceil(std::max(length, 0.0) / ds_)) + 1;
+    
+    // Every start sample within the lap has samples_.cols() - n_lap_ samples ahead of it
+    if (n_samples > samples_.cols() - n_lap_) {
+        throw std::runtime_error("Horizon exceeds the maximum horizon of the raceline table");
+    }
+    
+    return HorizonView(samples_.data() + static_cast<Eigen::Index>(i_start) * N_CHANNELS, N_CHANNELS, n_samples);
+}
+
+} // namespace global_racetrajectory_optimization
@@ -0,0 +1,366 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization {
+
+namespace {
+
+constexpr char ARCHIVE_MAGIC[8] = {'G', 'T', 'O', 'R', 'E', 'S', 'L', 'T'};
+constexpr uint32_t ARCHIVE_VERSION = 1;
+constexpr int N_CHANNELS = RacelineTable::N_CHANNELS;
+
+// File layout: header, result records (n_points, success, lap time, optimization time, parameters; 8 byte fields),
+// one chunk per channel (8 byte aligned), directory
+struct ArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_channels;
+    uint64_t n_results;
+    uint32_t n_parameters;
+    uint32_t delta_encoding;
+    uint64_t n_points_total;
+    uint64_t records_offset;
+    uint64_t directory_offset;
+    uint64_t file_size;
+};
+
+uint64_t recordSize(uint64_t n_parameters) {
+    return 8 * (4 + n_parameters);
+}
+
+uint64_t aligned(uint64_t size) {
+    return (size + 7) & ~uint64_t(7);
+}
+
+void putVarint(std::vector<char>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Channel values of a result, missing optional profiles (psi, ax) are written as zeros
+double channelValue(const OptimizationResult& result, int channel, int i) {
+    switch (channel) {
+        case RacelineTable::S: return result.s_opt(i);
+        case RacelineTable::X: return result.raceline(i, 0);
+        case RacelineTable::Y: return result.raceline(i, 1);
+        case RacelineTable::PSI: return (i < result.psi_opt.size()) ? result.psi_opt(i) : 0.0;
+        case RacelineTable::KAPPA: return result.kappa_opt(i);
+        case RacelineTable::VX: return result.v_opt(i);
+        default: return (i < result.ax_opt.size()) ? result.ax_opt(i) : 0.0;
+    }
+}
+
+} // namespace
+
+ResultArchiveWriter::ResultArchiveWriter(const std::string& filename, int n_parameters, bool delta_encoding)
+    : filename_(filename), n_parameters_(std::max(n_parameters, 0)), delta_encoding_(delta_encoding),
+      chunks_(N_CHANNELS), chunk_offsets_(N_CHANNELS, std::vector<uint64_t>(1, 0)) {}
+
+ResultArchiveWriter::~ResultArchiveWriter() {
+    if (!closed_) {
+        close();
+    }
+}
+
+void ResultArchiveWriter::add(const OptimizationResult& result, const VectorXd& parameters) {
+    int n_points = result.raceline.rows();
+    
+    if (n_points > 0 && (result.raceline.cols() < 2 || result.s_opt.size() != n_points
+                         || result.kappa_opt.size() != n_points || result.v_opt.size() != n_points)) {
+        throw std::runtime_error("Dimension mismatch between raceline and s/kappa/velocity profiles");
+    }
+    
+    if (parameters.size() != 0 && parameters.size() != n_parameters_) {
+        throw std::runtime_error("Result archive expects " + std::to_string(n_parameters_) + " parameters per result");
+    }
+    
+    Entry entry;
+    entry.n_points = static_cast<uint64_t>(n_points);
+    entry.success = result.success;
+    entry.lap_time = result.lap_time;
+    entry.optimization_time = result.optimization_time;
+    entry.parameters = (parameters.size() != 0) ? parameters : VectorXd::Zero(n_parameters_);
+    entries_.push_back(entry);
+    
+    for (int c = 0; c < N_CHANNELS; ++c) {
+        std::vector<char>& chunk = chunks_[c];
+        
+        if (!delta_encoding_) {
+            size_t start = chunk.size();
+            chunk.resize(start + sizeof(double) * n_points);
+            for (int i = 0; i < n_points; ++i) {
+                double value = channelValue(result, c, i);
+                std::memcpy(chunk.data() + start + sizeof(double) * i, &value, sizeof(double));
+            }
+        } else {
+            // Differences of the bit patterns (wrapping), zigzag mapped so that small negative steps stay short
+            uint64_t previous = 0;
+            for (int i = 0; i < n_points; ++i) {
+                double value = channelValue(result, c, i);
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                int64_t delta = static_cast<int64_t>(bits - previous);
+                putVarint(chunk, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+                previous = bits;
+            }
+        }
+        
+        chunk_offsets_[c].push_back(chunk.size());
+    }
+}
+
+bool ResultArchiveWriter::close() {
+    if (closed_) {
+        return false;
+    }
+    closed_ = true;
+    
+    uint64_t n_results = entries_.size();
+    uint64_t n_points_total = 0;
+    for (const Entry& entry : entries_) {
+        n_points_total += entry.n_points;
+    }
+    
+    ArchiveHeader header;
+    std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(header.magic));
+    header.version = ARCHIVE_VERSION;
+    header.n_channels = N_CHANNELS;
+    header.n_results = n_results;
+    header.n_parameters = static_cast<uint32_t>(n_parameters_);
+    header.delta_encoding = delta_encoding_ ? 1 : 0;
+    header.n_points_total = n_points_total;
+    header.records_offset = sizeof(ArchiveHeader);
+    
+    // Chunk positions, then the directory after the last chunk
+    std::vector<uint64_t> chunk_start(N_CHANNELS);
+    uint64_t offset = header.records_offset + n_results * recordSize(n_parameters_);
+    for (int c = 0; c < N_CHANNELS; ++c) {
+        chunk_start[c] = offset;
+        offset += aligned(chunks_[c].size());
+    }
+    header.directory_offset = offset;
+    header.file_size = offset + sizeof(uint64_t) * N_CHANNELS * (n_results + 3);
+    
+    std::ofstream file(filename_, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Cannot create result archive: " << filename_ << std::endl;
+        return false;
+    }
+    
+    auto write = [&file](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    
+    write(&header, sizeof(header));
+    
+    for (const Entry& entry : entries_) {
+        uint64_t success = entry.success ? 1 : 0;
+        write(&entry.n_points, sizeof(uint64_t));
+        write(&success, sizeof(uint64_t));
+        write(&entry.lap_time, sizeof(double));
+        write(&entry.optimization_time, sizeof(double));
+        write(entry.parameters.data(), sizeof(double) * n_parameters_);
+    }
+    
+    const char padding[8] = {};
+    for (int c = 0; c < N_CHANNELS; ++c) {
+        write(chunks_[c].data(), chunks_[c].size());
+        write(padding, aligned(chunks_[c].size()) - chunks_[c].size());
+    }
+    
+    for (int c = 0; c < N_CHANNELS; ++c) {
+        uint64_t chunk_size = chunks_[c].size();
+        write(&chunk_start[c], sizeof(uint64_t));
+        write(&chunk_size, sizeof(uint64_t));
+        write(chunk_offsets_[c].data(), sizeof(uint64_t) * chunk_offsets_[c].size());
+    }
+    
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Cannot write result archive: " << filename_ << std::endl;
+        return false;
+    }
+    
+    return true;
+}
+
+ResultArchiveReader::ResultArchiveReader(const std::string& filename)
+    : file_(filename) {
+    ArchiveHeader header;
+    if (file_.size() < sizeof(header)) {
+        throw std::runtime_error("Result archive too short: " + filename);
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, ARCHIVE_MAGIC, sizeof(header.magic)) != 0 || header.version != ARCHIVE_VERSION
+        || header.n_channels != N_CHANNELS) {
+        throw std::runtime_error("Unknown result archive format: " + filename);
+    }
+    
+    // Counts are bounded by the file size first, so that the sizes derived from them cannot overflow
+    uint64_t size = file_.size();
+    if (header.file_size != size || header.n_results > size / (sizeof(uint64_t) * N_CHANNELS)
+        || header.n_parameters > size / 8 || header.records_offset != sizeof(header)
+        || header.directory_offset % 8 != 0 || header.directory_offset > size) {
+        throw std::runtime_error("Corrupt result archive: " + filename);
+    }
+    
+    uint64_t directory_size = sizeof(uint64_t) * N_CHANNELS * (header.n_results + 3);
+    uint64_t records_end = header.records_offset + header.n_results * recordSize(header.n_parameters);
+    if (header.directory_offset + directory_size != size || records_end > header.directory_offset) {
+        throw std::runtime_error("Corrupt result archive: " + filename);
+    }
+    
+    n_results_ = static_cast<int>(header.n_results);
+    n_parameters_ = static_cast<int>(header.n_parameters);
+    delta_encoding_ = header.delta_encoding != 0;
+    n_points_total_ = header.n_points_total;
+    records_ = file_.data() + header.records_offset;
+    directory_ = reinterpret_cast<const uint64_t*>(file_.data() + header.directory_offset);
+    
+    // Point counts of the records add up to the total
+    std::vector<uint64_t> n_points(n_results_);
+    uint64_t n_points_sum = 0;
+    for (int r = 0; r < n_results_; ++r) {
+        std::memcpy(&n_points[r], records_ + static_cast<uint64_t>(r) * recordSize(n_parameters_), sizeof(uint64_t));
+        if (n_points[r] > header.n_points_total || n_points[r] > static_cast<uint64_t>(INT32_MAX)) {
+            throw std::runtime_error("Corrupt result archive: " + filename);
+        }
+        n_points_sum += n_points[r];
+    }
+    if (n_points_sum != header.n_points_total) {
+        throw std::runtime_error("Corrupt result archive: " + filename);
+    }
+    
+    // Chunks lie 8 byte aligned between the records and the directory, result offsets run from 0 to the chunk size
+    // without decreasing. Raw chunks hold exactly 8 bytes per point, delta encoded ones at least one byte per point
+    for (int c = 0; c < N_CHANNELS; ++c) {
+        const uint64_t* dir = channelDirectory(static_cast<RacelineTable::Channel>(c));
+        bool valid = dir[0] % 8 == 0 && dir[0] >= records_end && dir[0] <= header.directory_offset
+                     && dir[1] <= header.directory_offset - dir[0] && dir[2] == 0 && dir[2 + n_results_] == dir[1];
+        if (!delta_encoding_) {
+            valid = valid && dir[1] / 8 == n_points_total_ && dir[1] % 8 == 0;
+        }
+        for (int r = 0; valid && r < n_results_; ++r) {
+            uint64_t begin = dir[2 + r];
+            uint64_t end = dir[3 + r];
+            valid = end >= begin && (delta_encoding_ ? end - begin >= n_points[r] : end - begin == 8 * n_points[r]);
+        }
+        if (!valid) {
+            throw std::runtime_error("Corrupt result archive: " + filename);
+        }
+    }
+}
+
+const uint64_t* ResultArchiveReader::channelDirectory(RacelineTable::Channel channel) const {
+    if (channel < 0 || channel >= N_CHANNELS) {
+        throw std::runtime_error("Invalid result archive channel");
+    }
+    return directory_ + static_cast<uint64_t>(channel) * (n_results_ + 3);
+}
+
+ResultArchiveReader::ResultInfo ResultArchiveReader::info(int result) const {
+    if (result < 0 || result >= n_results_) {
+        throw std::runtime_error("Result index out of range");
+    }
+    
+    const char* record = records_ + static_cast<uint64_t>(result) * recordSize(n_parameters_);
+    uint64_t fields[2];
+    double times[2];
+    std::memcpy(fields, record, sizeof(fields));
+    std::memcpy(times, record + sizeof(fields), sizeof(times));
+    
+    return ResultInfo{static_cast<int>(fields[0]), fields[1] != 0, times[0], times[1],
+                      Eigen::Map<const VectorXd>(reinterpret_cast<const double*>(record + 32), n_parameters_)};
+}
+
+void ResultArchiveReader::decode(RacelineTable::Channel channel, int result, double* out) const {
+    const uint64_t* dir = channelDirectory(channel);
+    const char* begin = file_.data() + dir[0] + dir[2 + result];
+    const char* end = file_.data() + dir[0] + dir[3 + result];
+    int n_points = info(result).n_points;
+    
+    if (!delta_encoding_) {
+        if (end - begin != static_cast<std::ptrdiff_t>(sizeof(double) * n_points)) {
+            throw std::runtime_error("Corrupt result archive chunk");
+        }
+        std::memcpy(out, begin, sizeof(double) * n_points);
+        return;
+    }
+    
+    uint64_t bits = 0;
+    const char* pos = begin;
+    for (int i = 0; i < n_points; ++i) {
+        uint64_t zigzag = 0;
+        int shift = 0;
+        while (true) {
+            if (pos >= end || shift > 63) {
+                throw std::runtime_error("Corrupt result archive chunk");
+            }
+            uint8_t byte = static_cast<uint8_t>(*pos++);
+            zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+            shift += 7;
+        }
+        bits += (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        std::memcpy(out + i, &bits, sizeof(double));
+    }
+}
+
+VectorXd ResultArchiveReader::column(RacelineTable::Channel channel, int result) const {
+    VectorXd values(info(result).n_points);
+    decode(channel, result, values.data());
+    return values;
+}
+
+VectorXd ResultArchiveReader::column(RacelineTable::Channel channel) const {
+    if (!delta_encoding_) {
+        return columnView(channel);
+    }
+    
+    VectorXd values(n_points_total_);
+    uint64_t offset = 0;
+    for (int r = 0; r < n_results_; ++r) {
+        decode(channel, r, values.data() + offset);
+        offset += info(r).n_points;
+    }
+    return values;
+}
+
+Eigen::Map<const VectorXd> ResultArchiveReader::columnView(RacelineTable::Channel channel) const {
+    if (delta_encoding_) {
+        throw std::runtime_error("Column views require a raw (not delta encoded) result archive");
+    }
+    
+    const uint64_t* dir = channelDirectory(channel);
+    return Eigen::Map<const VectorXd>(reinterpret_cast<const double*>(file_.data() + dir[0]), n_points_total_);
+}
+
+OptimizationResult ResultArchiveReader::result(int result) const {
+    ResultInfo header = info(result);
+    
+    OptimizationResult out;
+    out.success = header.success;
+    out.lap_time = header.lap_time;
+    out.optimization_time = header.optimization_time;
+    out.raceline.resize(header.n_points, 2);
+    out.s_opt = column(RacelineTable::S, result);
+    out.raceline.col(0) = column(RacelineTable::X, result);
+    out.raceline.col(1) = column(RacelineTable::Y, result);
+    out.psi_opt = column(RacelineTable::PSI, result);
+    out.kappa_opt = column(RacelineTable::KAPPA, result);
+    out.v_opt = column(RacelineTable::VX, result);
+    out.ax_opt = column(RacelineTable::AX, result);
+    return out;
+}
+
+} // namespace global_racetrajectory_optimization
@@ -1,10 +1,109 @@
 #include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
-#include <fstream>
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <atomic>
+#include <cstdio>
 #include <iostream>
 
-namespace global_racetrajectory_optimization {
+namespace global_racetrajectory_optimization::utils {
 
-// Additional result export and visualization functions
-// Could include plotting capabilities with matplotlib-cpp or similar
+bool exportToCSV(const OptimizationResult& result, const std::string& filename, int precision) {
+    CsvWriter writer(filename, precision);
+    if (!writer.isOpen()) {
+        return false;
+    }
+    
+    // Write header
+    writer.writeText("x_m,y_m,psi_rad,kappa_radpm,vx_mps,ax_mps2,s_m\n");
+    
+    int n_points = result.raceline.rows();
+    
+    for (int i = 0; i < n_points; ++i) {
+        writer.writeValue(result.raceline(i, 0));
+        writer.writeSeparator();
+        writer.writeValue(result.raceline(i, 1));
+        writer.writeSeparator();
+        writer.writeValue(i < result.psi_opt.size() ? result.psi_opt(i) : 0.0);
+        writer.writeSeparator();
+        writer.writeValue(result.kappa_opt(i));
+        writer.writeSeparator();
+        writer.writeValue(result.v_opt(i));
+        writer.writeSeparator();
+        writer.writeValue(i < result.ax_opt.size() ? result.ax_opt(i) : 0.0);
+        writer.writeSeparator();
+        writer.writeValue(result.s_opt(i));
+        writer.endRow();
+    }
+    
+    return writer.close();
+}
 
-} // namespace global_racetrajectory_optimization
\ No newline at end of file
+bool exportToCSV(const std::vector<OptimizationResult>& results, const std::vector<std::string>& filenames,
+                 int precision, int n_threads) {
+    if (results.size() != filenames.size()) {
+        std::cerr << "Number of results and output files differ" << std::endl;
+        return false;
+    }
+    
+    // One file per task, each writer formats into its own buffer
+    std::atomic<bool> success(true);
+    trajectory_planning_helpers::parallel_for(static_cast<int>(results.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            if (!exportToCSV(results[i], filenames[i], precision)) {
+                std::cerr << "Could not export result to: " << filenames[i] << std::endl;
+                success = false;
+            }
+        }
+    }, n_threads, 1);
+    
+    return success;
+}
+
+bool exportToLTPL(const TrackData& track, const OptimizationResult& result, const std::string& filename,
+                  int precision) {
+    ConstMatrixMap reftrack = track.reftrack();
+    int n_points = reftrack.rows();
+    
+    if (n_points == 0 || reftrack.cols() < 4 || track.normvectors.rows() != n_points) {
+        std::cerr << "LTPL export requires a prepared track" << std::endl;
+        return false;
+    }
+    
+    if (result.raceline.rows() != n_points || result.alpha_opt.size() != n_points || result.s_opt.size() != n_points
+        || result.psi_opt.size() != n_points || result.kappa_opt.size() != n_points
+        || result.v_opt.size() != n_points || result.ax_opt.size() != n_points) {
+        std::cerr << "LTPL export requires one raceline point per reference point" << std::endl;
+        return false;
+    }
+    
+    CsvWriter writer(filename, precision, ';');
+    if (!writer.isOpen()) {
+        return false;
+    }
+    
+    // Header: hash of the source track file (identifies the track the trajectory belongs to), then column names
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(track.source_hash));
+    writer.writeText("# " + std::string(hash) + "\n");
+    writer.writeText("# x_ref_m;y_ref_m;width_right_m;width_left_m;x_normvec_m;y_normvec_m;alpha_m;s_racetraj_m;"
+                     "psi_racetraj_rad;kappa_racetraj_radpm;vx_racetraj_mps;ax_racetraj_mps2\n");
+    
+    for (int i = 0; i < n_points; ++i) {
+        const double row[12] = {
+            reftrack(i, 0), reftrack(i, 1), reftrack(i, 2), reftrack(i, 3),
+            track.normvectors(i, 0), track.normvectors(i, 1), result.alpha_opt(i),
+            result.s_opt(i), result.psi_opt(i), result.kappa_opt(i), result.v_opt(i), result.ax_opt(i)
+        };
+        
+        for (int j = 0; j < 12; ++j) {
+            if (j > 0) {
+                writer.writeSeparator();
+            }
+            writer.writeValue(row[j]);
+        }
+        writer.endRow();
+    }
+    
+    return writer.close();
+}
+
+} // namespace global_racetrajectory_optimization::utils
@@ -0,0 +1,192 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace global_racetrajectory_optimization {
+
+namespace {
+
+// Coefficients of p(1 - t) for the cubic p(t) = c0 + c1 t + c2 t^2 + c3 t^3
+Eigen::Vector4d reflectSpline(const Eigen::Vector4d& c) {
+    return Eigen::Vector4d(c(0) + c(1) + c(2) + c(3), -(c(1) + 2.0 * c(2) + 3.0 * c(3)), c(2) + 3.0 * c(3), -c(3));
+}
+
+// Spline system of the reversed track: equations and unknowns reordered by spline (spline_rev: reversed index of every
+// original spline), cubic coefficient blocks reflected (c = D c_rev)
+SparseMatrixXd reverseSplineSystem(const SparseMatrixXd& a_interp, const std::vector<int>& spline_rev) {
+    int n_points = static_cast<int>(spline_rev.size());
+    if (a_interp.rows() == 0 || a_interp.rows() % n_points != 0 || a_interp.cols() % n_points != 0) {
+        return SparseMatrixXd();
+    }
+    
+    int block_rows = a_interp.rows() / n_points;
+    int block_cols = a_interp.cols() / n_points;
+    
+    Eigen::Matrix4d reflect;
+    reflect << 1, 1, 1, 1,
+               0, -1, -2, -3,
+               0, 0, 1, 3,
+               0, 0, 0, -1;
+    
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(a_interp.nonZeros() * ((block_cols == 4) ? 2 : 1));
+    
+    for (int col = 0; col < a_interp.outerSize(); ++col) {
+        int col_rev = spline_rev[col / block_cols] * block_cols;
+        int l = col % block_cols;
+        
+        for (SparseMatrixXd::InnerIterator it(a_interp, col); it; ++it) {
+            int row_rev = spline_rev[it.row() / block_rows] * block_rows + it.row() % block_rows;
+            
+            if (block_cols != 4) {
+                triplets.emplace_back(row_rev, col_rev + l, it.value());
+                continue;
+            }
+            for (int m = 0; m < 4; ++m) {
+                if (reflect(l, m) != 0.0) {
+                    triplets.emplace_back(row_rev, col_rev + m, it.value() * reflect(l, m));
+                }
+            }
+        }
+    }
+    
+    SparseMatrixXd reversed(a_interp.rows(), a_interp.cols());
+    reversed.setFromTriplets(triplets.begin(), triplets.end());
+    return reversed;
+}
+
+} // namespace
+
+ReversedTrackView::ReversedTrackView(const TrackData& track)
+    : track_(&track), reftrack_(track.reftrack(), 0, true) {
+    int n_points = track.reftrack().rows();
+    
+    if (n_points < 2 || track.reftrack().cols() < 4) {
+        throw std::runtime_error("Reversed track view requires a reftrack [x, y, w_tr_right, w_tr_left]");
+    }
+    
+    if (track.normvectors.rows() != n_points || track.coeffs_x.rows() != n_points || track.coeffs_y.rows() != n_points
+        || track.el_lengths.size() != n_points) {
+        throw std::runtime_error("Reversed track view requires a prepared closed track");
+    }
+}
+
+Vector2d ReversedTrackView::point(int i) const {
+    return track_->reftrack().row(pointIndex(i)).head<2>().transpose();
+}
+
+Vector2d ReversedTrackView::normal(int i) const {
+    return -track_->normvectors.row(pointIndex(i)).transpose();
+}
+
+double ReversedTrackView::elLength(int i) const {
+    return track_->el_lengths(splineIndex(i));
+}
+
+Eigen::Vector4d ReversedTrackView::coeffsX(int i) const {
+    return reflectSpline(track_->coeffs_x.row(splineIndex(i)).head<4>().transpose());
+}
+
+Eigen::Vector4d ReversedTrackView::coeffsY(int i) const {
+    return reflectSpline(track_->coeffs_y.row(splineIndex(i)).head<4>().transpose());
+}
+
+Vector2d ReversedTrackView::toFrenet(const Vector2d& pos) const {
+    const auto& index = track_->segment_index;
+    if (!index || index->numSegments() != size()) {
+        throw std::runtime_error("Reversed track view requires the segment index of the track");
+    }
+    
+    // Arc length runs backwards from the start point (row 0), left and right are swapped
+    trajectory_planning_helpers::PathMatch<double> match = index->match(pos);
+    double s = (match.s > 0.0) ? index->length() - match.s : 0.0;
+    return Vector2d(s, -match.d);
+}
+
+MatrixXd ReversedTrackView::toFrenet(const MatrixXd& points, int n_threads) const {
+    MatrixXd result(points.rows(), 2);
+    
+    trajectory_planning_helpers::parallel_for(static_cast<int>(points.rows()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            result.row(i) = toFrenet(Vector2d(points.row(i).head<2>().transpose())).transpose();
+        }
+    }, n_threads);
+    
+    return result;
+}
+
+TrackData ReversedTrackView::toTrackData() const {
+    int n_points = size();
+    
+    TrackData reversed;
+    reversed.setReftrack(reftrack_.toMatrix());
+    reversed.normvectors.resize(n_points, 2);
+    reversed.coeffs_x.resize(n_points, 4);
+    reversed.coeffs_y.resize(n_points, 4);
+    reversed.el_lengths.resize(n_points);
+    
+    for (int i = 0; i < n_points; ++i) {
+        reversed.normvectors.row(i) = normal(i).transpose();
+        reversed.coeffs_x.row(i) = coeffsX(i).transpose();
+        reversed.coeffs_y.row(i) = coeffsY(i).transpose();
+        reversed.el_lengths(i) = elLength(i);
+    }
+    
+    // Reversed spline of every original spline
+    std::vector<int> spline_rev(n_points);
+    for (int i = 0; i < n_points; ++i) {
+        spline_rev[splineIndex(i)] = i;
+    }
+    reversed.a_interp = reverseSplineSystem(track_->a_interp, spline_rev);
+    
+    reversed.track_name = track_->track_name;
+    reversed.source_hash = track_->source_hash;
+    reversed.start_index = track_->start_index;
+    reversed.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+        trajectory_planning_helpers::transposed_view(reversed.reftrack().leftCols(2)), true);
+    return reversed;
+}
+
+namespace utils {
+
+void reverseTrackData(TrackData& track) {
+    int n_points = track.reftrack().rows();
+    
+    if (n_points < 2 || track.reftrack().cols() < 4 || track.normvectors.rows() != n_points
+        || track.coeffs_x.rows() != n_points || track.coeffs_y.rows() != n_points
+        || track.el_lengths.size() != n_points) {
+        throw std::runtime_error("Reversing requires a prepared closed track");
+    }
+    
+    // Same order as ReversedTrackView: point i is point -i mod n (row 0 stays), spline and element i are spline
+    // n - 1 - i, reflected. The shared reference track is read-only, the reversed copy goes into a new mapping
+    MatrixXd reftrack = track.reftrack();
+    reftrack.bottomRows(n_points - 1).colwise().reverseInPlace();
+    reftrack.col(2).swap(reftrack.col(3));
+    track.setReftrack(reftrack);
+    track.normvectors.bottomRows(n_points - 1).colwise().reverseInPlace();
+    track.normvectors *= -1.0;
+    track.el_lengths.reverseInPlace();
+    
+    track.coeffs_x.colwise().reverseInPlace();
+    track.coeffs_y.colwise().reverseInPlace();
+    for (int i = 0; i < n_points; ++i) {
+        track.coeffs_x.row(i).head<4>() = reflectSpline(track.coeffs_x.row(i).head<4>().transpose()).transpose();
+        track.coeffs_y.row(i).head<4>() = reflectSpline(track.coeffs_y.row(i).head<4>().transpose()).transpose();
+    }
+    
+    std::vector<int> spline_rev(n_points);
+    for (int i = 0; i < n_points; ++i) {
+        spline_rev[i] = n_points - 1 - i;
+    }
+    track.a_interp = reverseSplineSystem(track.a_interp, spline_rev);
+    
+    track.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+        trajectory_planning_helpers::transposed_view(track.reftrack().leftCols(2)), true);
+}
+
+} // namespace utils
+
+} // namespace global_racetrajectory_optimization
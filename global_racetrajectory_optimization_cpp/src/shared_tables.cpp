@@ -0,0 +1,222 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace global_racetrajectory_optimization {
+
+namespace {
+
+constexpr char TABLES_MAGIC[8] = {'G', 'T', 'O', 'T', 'A', 'B', 'L', 'E'};
+constexpr uint32_t TABLES_VERSION = 1;
+constexpr size_t TABLE_NAME_SIZE = 48;
+
+// File layout: header, one directory entry per table, then the tables (doubles, column-major) at the offsets given
+// in the directory, every table 8 byte aligned
+struct TablesHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_tables;
+    uint64_t key;
+    uint64_t file_size;
+};
+
+struct TableEntry {
+    char name[TABLE_NAME_SIZE];  // zero terminated
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t offset;             // from the start of the file
+};
+
+std::vector<char> serialize(const std::vector<std::pair<std::string, MatrixXd>>& tables, uint64_t key) {
+    TablesHeader header;
+    std::memcpy(header.magic, TABLES_MAGIC, sizeof(header.magic));
+    header.version = TABLES_VERSION;
+    header.n_tables = static_cast<uint32_t>(tables.size());
+    header.key = key;
+    
+    std::vector<TableEntry> entries(tables.size());
+    uint64_t offset = sizeof(TablesHeader) + sizeof(TableEntry) * tables.size();
+    for (size_t i = 0; i < tables.size(); ++i) {
+        const std::string& name = tables[i].first;
+        if (name.empty() || name.size() >= TABLE_NAME_SIZE) {
+            throw std::runtime_error("Invalid shared table name: '" + name + "'");
+        }
+        std::memset(entries[i].name, 0, TABLE_NAME_SIZE);
+        std::memcpy(entries[i].name, name.data(), name.size());
+        entries[i].rows = static_cast<uint64_t>(tables[i].second.rows());
+        entries[i].cols = static_cast<uint64_t>(tables[i].second.cols());
+        entries[i].offset = offset;
+        offset += sizeof(double) * tables[i].second.size();
+    }
+    header.file_size = offset;
+    
+    std::vector<char> buffer(offset);
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    std::memcpy(buffer.data() + sizeof(header), entries.data(), sizeof(TableEntry) * entries.size());
+    for (size_t i = 0; i < tables.size(); ++i) {
+        std::memcpy(buffer.data() + entries[i].offset, tables[i].second.data(),
+                    sizeof(double) * tables[i].second.size());
+    }
+    return buffer;
+}
+
+bool writeAll(int fd, const std::vector<char>& buffer) {
+    size_t written = 0;
+    while (written < buffer.size()) {
+        ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+        if (n <= 0) {
+            return false;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+SharedTables::SharedTables(const std::string& filename) {
+    map(filename);
+}
+
+SharedTables::~SharedTables() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+SharedTables::SharedTables(SharedTables&& other) noexcept
+    : file_(std::move(other.file_)), fd_(other.fd_), key_(other.key_), path_(std::move(other.path_)),
+      entries_(std::move(other.entries_)) {
+    other.fd_ = -1;
+}
+
+SharedTables& SharedTables::operator=(SharedTables&& other) noexcept {
+    if (this != &other) {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        file_ = std::move(other.file_);
+        fd_ = other.fd_;
+        key_ = other.key_;
+        path_ = std::move(other.path_);
+        entries_ = std::move(other.entries_);
+        other.fd_ = -1;
+    }
+    return *this;
+}
+
+SharedTables SharedTables::create(const std::vector<std::pair<std::string, MatrixXd>>& tables, uint64_t key,
+                                  const std::string& filename) {
+    std::vector<char> buffer = serialize(tables, key);
+    SharedTables result;
+    
+    if (filename.empty()) {
+        // Sealed after writing, so no process holding the descriptor can modify the shared pages
+        int fd = ::memfd_create("global_racetrajectory_tables", MFD_ALLOW_SEALING);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot create memfd for shared tables");
+        }
+        if (!writeAll(fd, buffer)
+            || ::fcntl(fd, F_ADD_SEALS, F_SEAL_WRITE | F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot write shared tables to memfd");
+        }
+        result.fd_ = fd;
+        result.map("/proc/" + std::to_string(::getpid()) + "/fd/" + std::to_string(fd));
+        return result;
+    }
+    
+    std::string tmp_filename = filename + ".tmp" + std::to_string(::getpid());
+    int fd = ::open(tmp_filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create shared table file: " + filename);
+    }
+    bool ok = writeAll(fd, buffer);
+    ok = (::close(fd) == 0) && ok;
+    
+    if (!ok || std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        std::remove(tmp_filename.c_str());
+        throw std::runtime_error("Cannot write shared table file: " + filename);
+    }
+    
+    result.map(filename);
+    return result;
+}
+
+void SharedTables::map(const std::string& filename) {
+    MappedFile file(filename);
+    
+    TablesHeader header;
+    if (file.size() < sizeof(header)) {
+        throw std::runtime_error("Shared table file too short: " + filename);
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, TABLES_MAGIC, sizeof(header.magic)) != 0 || header.version != TABLES_VERSION) {
+        throw std::runtime_error("Unknown shared table format: " + filename);
+    }
+    
+    if (header.file_size != file.size()
+        || sizeof(TablesHeader) + sizeof(TableEntry) * static_cast<uint64_t>(header.n_tables) > file.size()) {
+        throw std::runtime_error("Corrupt shared table file: " + filename);
+    }
+    
+    std::vector<Entry> entries;
+    const char* directory = file.data() + sizeof(TablesHeader);
+    for (uint32_t i = 0; i < header.n_tables; ++i) {
+        TableEntry entry;
+        std::memcpy(&entry, directory + sizeof(TableEntry) * i, sizeof(TableEntry));
+        
+        if (entry.name[TABLE_NAME_SIZE - 1] != '\0' || entry.offset % 8 != 0 || entry.offset > file.size()
+            || (entry.cols > 0 && entry.rows > (file.size() - entry.offset) / sizeof(double) / entry.cols)) {
+            throw std::runtime_error("Corrupt shared table file: " + filename);
+        }
+        
+        entries.push_back({entry.name, static_cast<Eigen::Index>(entry.rows), static_cast<Eigen::Index>(entry.cols),
+                           reinterpret_cast<const double*>(file.data() + entry.offset)});
+    }
+    
+    file_ = std::move(file);
+    key_ = header.key;
+    path_ = filename;
+    entries_ = std::move(entries);
+}
+
+bool SharedTables::contains(const std::string& name) const {
+    for (const Entry& entry : entries_) {
+        if (entry.name == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ConstMatrixMap SharedTables::table(const std::string& name) const {
+    for (const Entry& entry : entries_) {
+        if (entry.name == name) {
+            return ConstMatrixMap(entry.data, entry.rows, entry.cols);
+        }
+    }
+    throw std::runtime_error("Shared table not found: " + name);
+}
+
+void TrackData::setReftrack(const MatrixXd& table) {
+    setReftrack(std::make_shared<const SharedTables>(SharedTables::create({{"reftrack", table}}, source_hash)));
+}
+
+void TrackData::setReftrack(std::shared_ptr<const SharedTables> tables) {
+    if (!tables) {
+        throw std::runtime_error("Shared table not found: reftrack");
+    }
+    ConstMatrixMap table = tables->table("reftrack");
+    reftrack_data_ = table.data();
+    reftrack_rows_ = table.rows();
+    reftrack_cols_ = table.cols();
+    reftrack_tables_ = std::move(tables);
+}
+
+} // namespace global_racetrajectory_optimization
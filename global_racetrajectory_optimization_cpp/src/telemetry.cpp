@@ -0,0 +1,334 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization::utils {
+
+namespace {
+
+// Records of binary logs matched per path_matching_global call
+constexpr int BINARY_CHUNK_ROWS = 65536;
+
+using RowMajorMap = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+struct Sample {
+    double t, x, y, v, s, d;
+};
+
+Sample interpolate(const Sample& a, const Sample& b, double f) {
+    return {a.t + f * (b.t - a.t), a.x + f * (b.x - a.x), a.y + f * (b.y - a.y), a.v + f * (b.v - a.v),
+            a.s, a.d + f * (b.d - a.d)};
+}
+
+// Linear interpolation of the columns of values (rows at strictly increasing s) at the positions s_query, clamped to
+// the first and last row
+MatrixXd interpolateAt(const VectorXd& s, const MatrixXd& values, const VectorXd& s_query) {
+    MatrixXd result(s_query.size(), values.cols());
+    Eigen::Index j = 0;
+    
+    for (Eigen::Index k = 0; k < s_query.size(); ++k) {
+        double s_k = std::min(std::max(s_query(k), s(0)), s(s.size() - 1));
+        while (j + 2 < s.size() && s(j + 1) < s_k) {
+            ++j;
+        }
+        double f = (s.size() > 1) ? (s_k - s(j)) / (s(j + 1) - s(j)) : 0.0;
+        f = std::min(std::max(f, 0.0), 1.0);
+        result.row(k) = values.row(j) + f * (values.row(std::min(j + 1, s.size() - 1)) - values.row(j));
+    }
+    
+    return result;
+}
+
+void resampleLap(TelemetryLap& lap, double ds) {
+    double s_first = lap.s(0);
+    double s_last = lap.s(lap.s.size() - 1);
+    
+    // Uniform grid from the first sample, the last sample closes the grid with a shorter step
+    Eigen::Index n_steps = static_cast<Eigen::Index>(std::ceil((s_last - s_first) / ds - 1e-9));
+    VectorXd s_grid(n_steps + 1);
+    for (Eigen::Index k = 0; k < n_steps; ++k) {
+        s_grid(k) = s_first + k * ds;
+    }
+    s_grid(n_steps) = s_last;
+    
+    MatrixXd values(lap.s.size(), 5);
+    values << lap.t, lap.d, lap.v, lap.xy;
+    MatrixXd resampled = interpolateAt(lap.s, values, s_grid);
+    
+    lap.s = s_grid;
+    lap.t = resampled.col(0);
+    lap.d = resampled.col(1);
+    lap.v = resampled.col(2);
+    lap.xy = resampled.rightCols(2);
+}
+
+// Splits the matched samples of a log into laps at the start line (s wrapping from the track length back to 0). A
+// crossing is interpolated between the samples on both sides and closes one lap and starts the next, so complete
+// laps cover s = [0, length]. Samples that do not advance along the reference line (standstill, noise) are dropped
+class LapSplitter {
+public:
+    LapSplitter(double length, const TelemetryOptions& opts, TelemetryLog& log)
+        : length_(length), opts_(opts), log_(log) {}
+    
+    void add(const Sample& sample) {
+        log_.n_samples++;
+        
+        if (!have_prev_) {
+            startLap(sample, false);
+            prev_ = sample;
+            have_prev_ = true;
+            return;
+        }
+        
+        double dt = sample.t - prev_.t;
+        if (dt <= 0.0) {
+            return;
+        }
+        
+        Sample current = sample;
+        double dist = std::hypot(current.x - prev_.x, current.y - prev_.y);
+        if (opts_.col_v < 0) {
+            current.v = dist / dt;
+            if (speed_pending_) {
+                lap_v_.front() = current.v;
+                speed_pending_ = false;
+            }
+        }
+        
+        // Arc length travelled, across the start line in either direction
+        double ds = current.s - prev_.s;
+        bool crossing = ds < -0.5 * length_;
+        bool backwards = ds > 0.5 * length_;
+        if (crossing) {
+            ds += length_;
+        } else if (backwards) {
+            ds -= length_;
+        }
+        
+        bool invalid = backwards || dt > opts_.max_gap || std::abs(current.d) > opts_.max_offset
+                       || std::abs(ds) > 2.0 * dist + opts_.match_tol;
+        if (invalid) {
+            lap_valid_ = false;
+        }
+        
+        if (crossing) {
+            Sample at_line = interpolate(prev_, current, (length_ - prev_.s) / ds);
+            at_line.s = length_;
+            push(at_line);
+            closeLap(true);
+            crossings_++;
+            
+            at_line.s = 0.0;
+            startLap(at_line, true);
+            lap_valid_ = !invalid;
+        }
+        
+        if (current.s > lap_s_.back()) {
+            push(current);
+        }
+        prev_ = current;
+    }
+    
+    void finish() {
+        if (have_prev_) {
+            closeLap(false);
+        }
+    }
+
+private:
+    double length_;
+    const TelemetryOptions& opts_;
+    TelemetryLog& log_;
+    
+    bool have_prev_ = false;
+    bool speed_pending_ = false;  // speed of the first sample, known with the second
+    Sample prev_{};
+    int crossings_ = 0;
+    
+    // Current lap
+    bool lap_from_line_ = false;
+    bool lap_valid_ = true;
+    double lap_t0_ = 0.0;
+    std::vector<double> lap_s_, lap_t_, lap_d_, lap_v_, lap_x_, lap_y_;
+    
+    void startLap(const Sample& sample, bool from_line) {
+        lap_from_line_ = from_line;
+        lap_valid_ = std::abs(sample.d) <= opts_.max_offset;
+        lap_t0_ = sample.t;
+        lap_s_.clear();
+        lap_t_.clear();
+        lap_d_.clear();
+        lap_v_.clear();
+        lap_x_.clear();
+        lap_y_.clear();
+        speed_pending_ = !have_prev_ && opts_.col_v < 0;
+        push(sample);
+    }
+    
+    void push(const Sample& sample) {
+        lap_s_.push_back(sample.s);
+        lap_t_.push_back(sample.t - lap_t0_);
+        lap_d_.push_back(sample.d);
+        lap_v_.push_back(sample.v);
+        lap_x_.push_back(sample.x);
+        lap_y_.push_back(sample.y);
+    }
+    
+    void closeLap(bool at_line) {
+        bool complete = lap_from_line_ && at_line;
+        
+        if (!lap_valid_) {
+            log_.n_rejected++;
+            return;
+        }
+        if ((!complete && !opts_.keep_partial) || lap_s_.size() < 2) {
+            return;
+        }
+        
+        Eigen::Index n = static_cast<Eigen::Index>(lap_s_.size());
+        TelemetryLap lap;
+        lap.lap = crossings_;
+        lap.complete = complete;
+        lap.t_start = lap_t0_;
+        lap.lap_time = lap_t_.back();
+        lap.s = Eigen::Map<const VectorXd>(lap_s_.data(), n);
+        lap.t = Eigen::Map<const VectorXd>(lap_t_.data(), n);
+        lap.d = Eigen::Map<const VectorXd>(lap_d_.data(), n);
+        lap.v = Eigen::Map<const VectorXd>(lap_v_.data(), n);
+        lap.xy.resize(n, 2);
+        lap.xy.col(0) = Eigen::Map<const VectorXd>(lap_x_.data(), n);
+        lap.xy.col(1) = Eigen::Map<const VectorXd>(lap_y_.data(), n);
+        
+        if (opts_.ds_resample > 0.0) {
+            resampleLap(lap, opts_.ds_resample);
+        }
+        
+        log_.laps.push_back(std::move(lap));
+    }
+};
+
+// Matches one block of log rows onto the track and feeds the samples to the splitter. Rows with non-finite values
+// (logging glitches) are skipped, the segment index does not accept them
+template <typename Rows>
+void processRows(const Rows& rows, const trajectory_planning_helpers::SegmentIndex<double>& index,
+                 const TelemetryOptions& opts, LapSplitter& splitter, TelemetryLog& log) {
+    std::vector<Eigen::Index> valid;
+    valid.reserve(rows.rows());
+    for (Eigen::Index i = 0; i < rows.rows(); ++i) {
+        if (std::isfinite(rows(i, opts.col_t)) && std::isfinite(rows(i, opts.col_x))
+            && std::isfinite(rows(i, opts.col_y)) && (opts.col_v < 0 || std::isfinite(rows(i, opts.col_v)))) {
+            valid.push_back(i);
+        }
+    }
+    log.n_invalid += static_cast<int>(rows.rows()) - static_cast<int>(valid.size());
+    if (valid.empty()) {
+        return;
+    }
+    
+    Eigen::Index n_valid = static_cast<Eigen::Index>(valid.size());
+    Matrix2Xd positions(2, n_valid);
+    for (Eigen::Index k = 0; k < n_valid; ++k) {
+        positions.col(k) << rows(valid[k], opts.col_x), rows(valid[k], opts.col_y);
+    }
+    
+    auto [s, d] = trajectory_planning_helpers::path_matching_global<double>(positions, index);
+    
+    for (Eigen::Index k = 0; k < n_valid; ++k) {
+        double v = (opts.col_v >= 0) ? rows(valid[k], opts.col_v) : 0.0;
+        splitter.add({rows(valid[k], opts.col_t), positions(0, k), positions(1, k), v, s(k), d(k)});
+    }
+}
+
+void checkColumns(int n_cols, const TelemetryOptions& opts, const std::string& filename) {
+    int max_col = std::max({opts.col_t, opts.col_x, opts.col_y, opts.col_v});
+    if (std::min({opts.col_t, opts.col_x, opts.col_y}) < 0 || max_col >= n_cols) {
+        throw std::runtime_error(filename + ": log has " + std::to_string(n_cols) + " columns, column "
+                                 + std::to_string(max_col) + " requested");
+    }
+}
+
+bool isBinaryLog(const std::string& filename, const TelemetryOptions& opts) {
+    if (opts.format != TelemetryFormat::AUTO) {
+        return opts.format == TelemetryFormat::BINARY;
+    }
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+} // namespace
+
+TelemetryLog ingestTelemetry(const std::string& filename, const TrackData& track, const TelemetryOptions& opts) {
+    TelemetryLog log;
+    log.source = filename;
+    
+    try {
+        if (!track.segment_index || track.segment_index->empty()) {
+            throw std::runtime_error("Track not prepared");
+        }
+        if (!track.segment_index->closed()) {
+            throw std::runtime_error("Lap segmentation requires a closed track");
+        }
+        
+        const auto& index = *track.segment_index;
+        LapSplitter splitter(index.length(), opts, log);
+        
+        if (isBinaryLog(filename, opts)) {
+            // Records are read in place from the mapping
+            MappedFile file(filename);
+            size_t record_size = sizeof(double) * std::max(opts.binary_cols, 1);
+            if (file.size() % record_size != 0) {
+                throw std::runtime_error(filename + ": size is not a multiple of the record size ("
+                                         + std::to_string(record_size) + " bytes)");
+            }
+            checkColumns(opts.binary_cols, opts, filename);
+            
+            const double* records = reinterpret_cast<const double*>(file.data());
+            Eigen::Index n_records = static_cast<Eigen::Index>(file.size() / record_size);
+            for (Eigen::Index first = 0; first < n_records; first += BINARY_CHUNK_ROWS) {
+                Eigen::Index n_rows = std::min<Eigen::Index>(BINARY_CHUNK_ROWS, n_records - first);
+                processRows(RowMajorMap(records + first * opts.binary_cols, n_rows, opts.binary_cols), index, opts,
+                            splitter, log);
+            }
+        } else {
+            CsvChunkReader reader(filename, opts.delimiter, opts.chunk_bytes);
+            for (MatrixXd rows = reader.next(); rows.rows() > 0; rows = reader.next()) {
+                checkColumns(reader.cols(), opts, filename);
+                processRows(rows, index, opts, splitter, log);
+            }
+        }
+        
+        splitter.finish();
+        log.success = true;
+        log.message = std::to_string(log.laps.size()) + " laps";
+    } catch (const std::exception& e) {
+        log.laps.clear();
+        log.message = e.what();
+    }
+    
+    return log;
+}
+
+std::vector<TelemetryLog> ingestTelemetryLogs(const std::vector<std::string>& filenames, const TrackData& track,
+                                              const TelemetryOptions& opts, int n_threads) {
+    // One log per task, each is parsed, matched and split independently
+    std::vector<TelemetryLog> logs(filenames.size());
+    trajectory_planning_helpers::parallel_for(static_cast<int>(filenames.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            logs[i] = ingestTelemetry(filenames[i], track, opts);
+        }
+    }, n_threads, 1);
+    
+    return logs;
+}
+
+VectorXd calculateDeltaTime(const TelemetryLap& lap, const TelemetryLap& reference) {
+    if (lap.s.size() == 0 || reference.s.size() == 0) {
+        return VectorXd();
+    }
+    
+    MatrixXd t_lap = interpolateAt(lap.s, lap.t, reference.s);
+    return t_lap.col(0) - reference.t;
+}
+
+} // namespace global_racetrajectory_optimization::utils
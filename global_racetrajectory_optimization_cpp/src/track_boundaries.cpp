@@ -0,0 +1,82 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization {
+
+TrackBoundaries::TrackBoundaries(const TrackData& track, double cell_size) {
+    ConstMatrixMap reftrack = track.reftrack();
+    int n_points = reftrack.rows();
+    
+    if (n_points < 2 || reftrack.cols() < 4) {
+        throw std::runtime_error("Track boundaries require a reftrack [x, y, w_tr_right, w_tr_left]");
+    }
+    
+    if (track.normvectors.rows() != n_points || track.normvectors.cols() != 2) {
+        throw std::runtime_error("Dimension mismatch between reftrack and normvectors");
+    }
+    
+    // Normal vectors point to the left of the driving direction
+    bound_left_ = reftrack.leftCols(2) + track.normvectors.cwiseProduct(reftrack.col(3).replicate(1, 2));
+    bound_right_ = reftrack.leftCols(2) - track.normvectors.cwiseProduct(reftrack.col(2).replicate(1, 2));
+    
+    index_left_ = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+        trajectory_planning_helpers::transposed_view(bound_left_), true, cell_size);
+    index_right_ = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+        trajectory_planning_helpers::transposed_view(bound_right_), true, cell_size);
+}
+
+TrackBoundaries::Query TrackBoundaries::query(const Vector2d& pos) const {
+    if (!index_left_ || !index_right_) {
+        throw std::runtime_error("Track boundaries are not initialized");
+    }
+    
+    // Positive lateral offsets are to the left, so the interior is right of the left and left of the right boundary
+    Query result;
+    result.d_left = -index_left_->match(pos).d;
+    result.d_right = index_right_->match(pos).d;
+    result.signed_distance = std::min(result.d_left, result.d_right);
+    result.inside = result.signed_distance >= 0.0;
+    return result;
+}
+
+Eigen::Array<bool, Eigen::Dynamic, 1> TrackBoundaries::inside(const MatrixXd& points, int n_threads) const {
+    Eigen::Array<bool, Eigen::Dynamic, 1> result(points.rows());
+    
+    trajectory_planning_helpers::parallel_for(static_cast<int>(points.rows()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            result(i) = query(points.row(i).head<2>().transpose()).inside;
+        }
+    }, n_threads);
+    
+    return result;
+}
+
+VectorXd TrackBoundaries::signedDistance(const MatrixXd& points, int n_threads) const {
+    VectorXd result(points.rows());
+    
+    trajectory_planning_helpers::parallel_for(static_cast<int>(points.rows()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            result(i) = query(points.row(i).head<2>().transpose()).signed_distance;
+        }
+    }, n_threads);
+    
+    return result;
+}
+
+MatrixXd TrackBoundaries::boundaryDistances(const MatrixXd& points, int n_threads) const {
+    MatrixXd result(points.rows(), 2);
+    
+    trajectory_planning_helpers::parallel_for(static_cast<int>(points.rows()), [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            Query q = query(points.row(i).head<2>().transpose());
+            result(i, 0) = q.d_left;
+            result(i, 1) = q.d_right;
+        }
+    }, n_threads);
+    
+    return result;
+}
+
+} // namespace global_racetrajectory_optimization
@@ -1,92 +1,306 @@
 #include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
-#include <fstream>
-#include <sstream>
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <set>
+#include <limits>
+#include <type_traits>
+#include <vector>
 
 namespace global_racetrajectory_optimization::utils {
 
 MatrixXd importTrack(const std::string& filename, bool flip_track) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Cannot open track file: " << filename << std::endl;
+    MatrixXd track;
+    try {
+        track = readCSV(filename);
+    } catch (const std::exception& e) {
+        std::cerr << "Cannot import track: " << e.what() << std::endl;
+        return MatrixXd();
+    }
+    
+    if (track.rows() == 0) {
+        std::cerr << "No valid track data found in file: " << filename << std::endl;
+        return MatrixXd();
+    }
+    
+    // Columns beyond the track widths (e.g. friction or banking) are kept as extra channels, only x, y provided: add
+    // default track widths
+    if (track.cols() == 2) {
+        track.conservativeResize(Eigen::NoChange, 4);
+        track.rightCols(2).setConstant(3.0);
+    } else if (track.cols() < 4) {
+        std::cerr << "Track file must have columns [x, y] or [x, y, w_tr_right, w_tr_left]: " << filename << std::endl;
         return MatrixXd();
     }
     
-    std::vector<std::vector<double>> data;
-    std::string line;
-    bool skip_header = true;
+    // Flip track if requested (last point first, left and right track widths swapped), in place
+    if (flip_track) {
+        track.colwise().reverseInPlace();
+        track.col(2).swap(track.col(3));
+    }
     
-    while (std::getline(file, line)) {
-        // Skip header line if it contains non-numeric data
-        if (skip_header && (line.find_first_of("0123456789-") != 0)) {
-            continue;
+    std::cout << "Track imported: " << track.rows() << " points" << std::endl;
+    return track;
+}
+
+namespace {
+
+// Segment of one of the checked polylines (line 0: centerline, 1: left boundary, 2: right boundary)
+struct SweepSegment {
+    Vector2d p;                  // left endpoint (smaller x, then smaller y)
+    Vector2d q;                  // right endpoint
+    int line;
+    int index;                   // point index of the segment start
+    int rank;                    // position among the non-degenerate segments of its line
+};
+
+double orientation(const Vector2d& a, const Vector2d& b, const Vector2d& c) {
+    return (b(0) - a(0)) * (c(1) - a(1)) - (b(1) - a(1)) * (c(0) - a(0));
+}
+
+bool onSegment(const Vector2d& a, const Vector2d& b, const Vector2d& c) {
+    return std::min(a(0), b(0)) <= c(0) && c(0) <= std::max(a(0), b(0))
+        && std::min(a(1), b(1)) <= c(1) && c(1) <= std::max(a(1), b(1));
+}
+
+bool segmentsIntersect(const SweepSegment& s, const SweepSegment& t) {
+    double d1 = orientation(t.p, t.q, s.p);
+    double d2 = orientation(t.p, t.q, s.q);
+    double d3 = orientation(s.p, s.q, t.p);
+    double d4 = orientation(s.p, s.q, t.q);
+    
+    if (((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0))) {
+        return true;
+    }
+    
+    // Touching and collinear cases
+    return (d1 == 0 && onSegment(t.p, t.q, s.p)) || (d2 == 0 && onSegment(t.p, t.q, s.q))
+        || (d3 == 0 && onSegment(s.p, s.q, t.p)) || (d4 == 0 && onSegment(s.p, s.q, t.q));
+}
+
+// Shamos-Hoey sweep over all segments: O(n log n), stops at the first intersection of two segments that are not
+// neighbours on the same polyline and not excluded by ignore(a, b). Segments of a tolerated crossing leave the sweep
+// status, since their order flips at the crossing. Returns false and the intersecting pair if one is found
+template <typename IgnoreFn>
+bool sweepLineCheck(const std::vector<SweepSegment>& segments, const std::vector<int>& line_sizes, bool closed,
+                    IgnoreFn&& ignore, int& hit_a, int& hit_b) {
+    int n_segments = static_cast<int>(segments.size());
+    
+    // Events: insertion at the left endpoint, removal at the right endpoint (insertions first at equal x, so that
+    // touching segments are neighbours once)
+    struct Event {
+        double x;
+        double y;
+        bool remove;
+        int segment;
+    };
+    
+    std::vector<Event> events;
+    events.reserve(2 * n_segments);
+    for (int k = 0; k < n_segments; ++k) {
+        events.push_back({segments[k].p(0), segments[k].p(1), false, k});
+        events.push_back({segments[k].q(0), segments[k].q(1), true, k});
+    }
+    
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        if (a.x != b.x) return a.x < b.x;
+        if (a.remove != b.remove) return !a.remove;
+        return a.y < b.y;
+    });
+    
+    // Sweep status ordered by the y coordinate at the current sweep position, ties broken by slope and index
+    double sweep_x = 0.0;
+    auto y_at = [&segments, &sweep_x](int k) {
+        const SweepSegment& seg = segments[k];
+        double dx = seg.q(0) - seg.p(0);
+        if (dx <= 0.0) {
+            return seg.p(1);
         }
-        skip_header = false;
-        
-        std::vector<double> row;
-        std::stringstream ss(line);
-        std::string cell;
+        double t = std::clamp((sweep_x - seg.p(0)) / dx, 0.0, 1.0);
+        return seg.p(1) + t * (seg.q(1) - seg.p(1));
+    };
+    auto slope = [&segments](int k) {
+        const SweepSegment& seg = segments[k];
+        double dx = seg.q(0) - seg.p(0);
+        return (dx <= 0.0) ? std::numeric_limits<double>::infinity() : (seg.q(1) - seg.p(1)) / dx;
+    };
+    auto compare = [&](int a, int b) {
+        double ya = y_at(a);
+        double yb = y_at(b);
+        if (ya != yb) return ya < yb;
+        double sa = slope(a);
+        double sb = slope(b);
+        if (sa != sb) return sa < sb;
+        return a < b;
+    };
+    
+    // Consecutive segments of a line share an endpoint (degenerate segments are not part of the sweep, so adjacency
+    // follows the rank among the remaining ones), the last and first segment only on closed lines
+    auto neighbours = [&segments, &line_sizes, closed](int a, int b) {
+        const SweepSegment& s = segments[a];
+        const SweepSegment& t = segments[b];
+        if (s.line != t.line) {
+            return false;
+        }
+        int diff = std::abs(s.rank - t.rank);
+        return diff == 1 || (closed && diff == line_sizes[s.line] - 1);
+    };
+    
+    std::vector<int> dropped;
+    auto check = [&](int a, int b) {
+        if (neighbours(a, b) || !segmentsIntersect(segments[a], segments[b])) {
+            return false;
+        }
+        if (ignore(a, b)) {
+            dropped.push_back(a);
+            dropped.push_back(b);
+            return false;
+        }
+        hit_a = a;
+        hit_b = b;
+        return true;
+    };
+    
+    using StatusSet = std::set<int, decltype(compare)>;
+    StatusSet status(compare);
+    std::vector<typename StatusSet::iterator> position(n_segments);
+    std::vector<bool> active(n_segments, false);
+    
+    // Removes a segment from the status, its former neighbours become adjacent
+    auto remove = [&](int k) {
+        auto it = position[k];
+        active[k] = false;
+        if (it != status.begin() && std::next(it) != status.end() && check(*std::prev(it), *std::next(it))) {
+            return false;
+        }
+        status.erase(it);
+        return true;
+    };
+    
+    for (const Event& event : events) {
+        sweep_x = event.x;
         
-        while (std::getline(ss, cell, ',')) {
-            try {
-                // Remove whitespace
-                cell.erase(0, cell.find_first_not_of(" \t"));
-                cell.erase(cell.find_last_not_of(" \t") + 1);
-                
-                if (!cell.empty()) {
-                    row.push_back(std::stod(cell));
-                }
-            } catch (const std::exception&) {
-                std::cerr << "Warning: Could not parse cell: " << cell << std::endl;
+        if (!event.remove) {
+            auto it = status.insert(event.segment).first;
+            position[event.segment] = it;
+            active[event.segment] = true;
+            
+            if (it != status.begin() && check(*std::prev(it), event.segment)) {
+                return false;
+            }
+            if (std::next(it) != status.end() && check(*std::next(it), event.segment)) {
+                return false;
             }
+        } else if (active[event.segment] && !remove(event.segment)) {
+            return false;
         }
         
-        // Ensure we have at least 4 columns (x, y, w_tr_right, w_tr_left)
-        if (row.size() >= 4) {
-            data.push_back(row);
-        } else if (row.size() == 2) {
-            // If only x, y provided, add default track widths
-            row.push_back(3.0); // Default right width
-            row.push_back(3.0); // Default left width
-            data.push_back(row);
+        // Segments of tolerated crossings (removing them may expose further ones)
+        while (!dropped.empty()) {
+            int k = dropped.back();
+            dropped.pop_back();
+            if (active[k] && !remove(k)) {
+                return false;
+            }
         }
     }
     
-    if (data.empty()) {
-        std::cerr << "No valid track data found in file: " << filename << std::endl;
-        return MatrixXd();
+    return true;
+}
+
+} // namespace
+
+bool checkTrackIntersections(const MatrixXd& track) {
+    int n_points = track.rows();
+    
+    if (n_points < 3 || track.cols() < 4) {
+        return false;
     }
     
-    // Convert to Eigen matrix
-    MatrixXd track(data.size(), 4);
-    for (size_t i = 0; i < data.size(); ++i) {
-        for (size_t j = 0; j < 4 && j < data[i].size(); ++j) {
-            track(i, j) = data[i][j];
-        }
-        // Fill missing columns with default values
-        if (data[i].size() < 4) {
-            for (size_t j = data[i].size(); j < 4; ++j) {
-                track(i, j) = 3.0; // Default track width
+    // Closed unless the track is clearly open (same criterion as the note in checkTrackValidity)
+    bool closed = (track.row(0).head(2) - track.row(n_points - 1).head(2)).norm() <= 10.0;
+    
+    // Boundaries from central-difference normals (the spline normals are not available before preparation)
+    MatrixXd lines[3];
+    lines[0] = track.leftCols(2);
+    lines[1].resize(n_points, 2);
+    lines[2].resize(n_points, 2);
+    
+    for (int i = 0; i < n_points; ++i) {
+        int i_prev = (i > 0) ? i - 1 : (closed ? n_points - 1 : 0);
+        int i_next = (i + 1 < n_points) ? i + 1 : (closed ? 0 : n_points - 1);
+        Vector2d tangent = track.row(i_next).head(2) - track.row(i_prev).head(2);
+        double norm = tangent.norm();
+        Vector2d normal = (norm > 1e-9) ? Vector2d(-tangent(1) / norm, tangent(0) / norm) : Vector2d(0.0, 0.0);
+        
+        lines[1].row(i) = track.row(i).head(2) + track(i, 3) * normal.transpose();
+        lines[2].row(i) = track.row(i).head(2) - track(i, 2) * normal.transpose();
+    }
+    
+    // Collect non-degenerate segments with their endpoints ordered along the sweep direction
+    std::vector<SweepSegment> segments;
+    segments.reserve(3 * n_points);
+    int n_line_segments = closed ? n_points : n_points - 1;
+    
+    std::vector<int> line_sizes(3, 0);
+    
+    for (int line = 0; line < 3; ++line) {
+        for (int i = 0; i < n_line_segments; ++i) {
+            Vector2d a = lines[line].row(i).transpose();
+            Vector2d b = lines[line].row((i + 1) % n_points).transpose();
+            if ((a - b).squaredNorm() < 1e-18) {
+                continue;
             }
+            bool a_first = (a(0) < b(0)) || (a(0) == b(0) && a(1) < b(1));
+            segments.push_back({a_first ? a : b, a_first ? b : a, line, i, line_sizes[line]++});
         }
     }
     
-    // Flip track if requested
-    if (flip_track) {
-        MatrixXd flipped_track(track.rows(), track.cols());
-        for (int i = 0; i < track.rows(); ++i) {
-            flipped_track.row(i) = track.row(track.rows() - 1 - i);
-            // Swap left and right track widths
-            std::swap(flipped_track(i, 2), flipped_track(i, 3));
+    // Local folds of a boundary (track width above the corner radius, typically on the inside of hairpins) are
+    // tolerated since the optimization clips them, overlaps of distant track parts are not
+    VectorXd s_points(n_points + 1);
+    s_points(0) = 0.0;
+    for (int i = 0; i < n_points; ++i) {
+        s_points(i + 1) = s_points(i) + (lines[0].row((i + 1) % n_points) - lines[0].row(i)).norm();
+    }
+    double s_total = closed ? s_points(n_points) : std::numeric_limits<double>::infinity();
+    
+    int n_folds = 0;
+    auto local_fold = [&](int a, int b) {
+        const SweepSegment& sa = segments[a];
+        const SweepSegment& sb = segments[b];
+        if (sa.line != sb.line || sa.line == 0) {
+            return false;
         }
-        track = flipped_track;
+        int width_col = (sa.line == 1) ? 3 : 2;
+        double ds = std::abs(s_points(sa.index) - s_points(sb.index));
+        ds = std::min(ds, s_total - ds);
+        bool fold = ds <= 2.0 * (track(sa.index, width_col) + track(sb.index, width_col));
+        n_folds += fold;
+        return fold;
+    };
+    
+    int hit_a = -1;
+    int hit_b = -1;
+    bool valid = sweepLineCheck(segments, line_sizes, closed, local_fold, hit_a, hit_b);
+    
+    if (n_folds > 0) {
+        std::cout << "Note: Track boundaries fold locally at " << n_folds
+                  << " location(s) (track width exceeds corner radius)" << std::endl;
     }
     
-    std::cout << "Track imported: " << track.rows() << " points" << std::endl;
-    return track;
+    if (!valid) {
+        static const char* line_names[3] = {"centerline", "left boundary", "right boundary"};
+        const SweepSegment& s = segments[hit_a];
+        const SweepSegment& t = segments[hit_b];
+        std::cerr << "Track " << line_names[s.line] << " (segment " << s.index << ") intersects "
+                  << line_names[t.line] << " (segment " << t.index << ") near (" << s.p(0) << ", " << s.p(1) << ")"
+                  << std::endl;
+        return false;
+    }
+    
+    return true;
 }
 
 bool checkTrackValidity(const MatrixXd& track) {
@@ -121,43 +335,108 @@ bool checkTrackValidity(const MatrixXd& track) {
         std::cout << "Note: Track appears to be open (start-end distance: " << distance << " m)" << std::endl;
     }
     
+    // Crossing boundaries or a self-intersecting centerline
+    if (!checkTrackIntersections(track)) {
+        return false;
+    }
+    
     return true;
 }
 
-MatrixXd setNewStartPoint(const MatrixXd& track, const Vector2d& new_start) {
+TrackView setNewStartPoint(const MatrixXd& track, const Vector2d& new_start) {
+    return setNewStartPoint(ConstMatrixMap(track.data(), track.rows(), track.cols()), new_start);
+}
+
+TrackView setNewStartPoint(const ConstMatrixMap& track, const Vector2d& new_start) {
     if (track.rows() == 0) {
-        return track;
+        return TrackView(track);
     }
     
     // Find closest point to new_start
-    int closest_idx = 0;
-    double min_dist = (track.row(0).head(2) - new_start.transpose()).norm();
-    
-    for (int i = 1; i < track.rows(); ++i) {
-        double dist = (track.row(i).head(2) - new_start.transpose()).norm();
-        if (dist < min_dist) {
-            min_dist = dist;
-            closest_idx = i;
-        }
+    Eigen::Index closest_idx = 0;
+    (track.leftCols(2).rowwise() - new_start.transpose()).rowwise().squaredNorm().minCoeff(&closest_idx);
+    
+    return TrackView(track, static_cast<int>(closest_idx));
+}
+
+TrackView setNewStartPoint(const TrackData& track, const Vector2d& new_start) {
+    if (!track.segment_index || track.segment_index->numSegments() != track.reftrack().rows()) {
+        return setNewStartPoint(track.reftrack(), new_start);
     }
     
-    if (closest_idx == 0) {
-        return track; // Already at the desired start point
+    // Closest segment from the spatial index, then the closer one of its two points
+    trajectory_planning_helpers::PathMatch<double> match = track.segment_index->match(new_start);
+    int closest_idx = (match.t < 0.5) ? match.index : (match.index + 1) % static_cast<int>(track.reftrack().rows());
+    
+    return TrackView(track.reftrack(), closest_idx);
+}
+
+void rotateTrackData(TrackData& track, int offset) {
+    int n_points = track.reftrack().rows();
+    
+    if (n_points < 2 || track.normvectors.rows() != n_points || track.coeffs_x.rows() != n_points
+        || track.coeffs_y.rows() != n_points || track.el_lengths.size() != n_points) {
+        throw std::runtime_error("Rotating the start point requires a prepared closed track");
     }
     
-    // Reorder track to start at closest_idx
-    MatrixXd reordered_track(track.rows(), track.cols());
+    offset = ((offset % n_points) + n_points) % n_points;
+    if (offset == 0) {
+        return;
+    }
     
-    for (int i = 0; i < track.rows(); ++i) {
-        int src_idx = (closest_idx + i) % track.rows();
-        reordered_track.row(i) = track.row(src_idx);
+    // Row i of the rotated arrays is row (i + offset) mod n of the current ones
+    auto rotateRows = [n_points, offset](auto& m) {
+        using Matrix = std::decay_t<decltype(m)>;
+        Matrix rotated(m.rows(), m.cols());
+        rotated.topRows(n_points - offset) = m.bottomRows(n_points - offset);
+        rotated.bottomRows(offset) = m.topRows(offset);
+        m.swap(rotated);
+    };
+    
+    // The shared reference track is read-only, the rotated copy goes into a new mapping
+    MatrixXd reftrack = track.reftrack();
+    rotateRows(reftrack);
+    track.setReftrack(reftrack);
+    rotateRows(track.coeffs_x);
+    rotateRows(track.coeffs_y);
+    rotateRows(track.normvectors);
+    rotateRows(track.el_lengths);
+    
+    // Spline system: equations and unknowns are grouped in blocks per spline, the blocks move with their spline
+    const SparseMatrixXd& a_interp = track.a_interp;
+    if (a_interp.rows() > 0 && a_interp.rows() % n_points == 0 && a_interp.cols() % n_points == 0) {
+        int block_rows = a_interp.rows() / n_points;
+        int block_cols = a_interp.cols() / n_points;
+        auto rotated_index = [n_points, offset](int i, int block) {
+            return ((i / block - offset + n_points) % n_points) * block + i % block;
+        };
+        
+        std::vector<Eigen::Triplet<double>> triplets;
+        triplets.reserve(a_interp.nonZeros());
+        for (int col = 0; col < a_interp.outerSize(); ++col) {
+            for (SparseMatrixXd::InnerIterator it(a_interp, col); it; ++it) {
+                triplets.emplace_back(rotated_index(it.row(), block_rows), rotated_index(col, block_cols), it.value());
+            }
+        }
+        
+        SparseMatrixXd rotated(a_interp.rows(), a_interp.cols());
+        rotated.setFromTriplets(triplets.begin(), triplets.end());
+        track.a_interp = std::move(rotated);
     }
     
-    std::cout << "New start point set: moved from index 0 to " << closest_idx << std::endl;
-    return reordered_track;
+    // The segment index only shifts its arc lengths and renumbers its segments, the grid is kept
+    if (track.segment_index && track.segment_index->closed() && track.segment_index->numSegments() == n_points) {
+        track.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+            track.segment_index->rotated(offset));
+    } else {
+        track.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+            trajectory_planning_helpers::transposed_view(track.reftrack().leftCols(2)), true);
+    }
+    track.start_index = (track.start_index + offset) % n_points;
 }
 
-MatrixXd calculateRaceline(const MatrixXd& reftrack, const MatrixXd& normvectors, const VectorXd& alpha) {
+MatrixXd calculateRaceline(const Eigen::Ref<const MatrixXd>& reftrack, const MatrixXd& normvectors,
+                           const VectorXd& alpha) {
     if (reftrack.rows() != normvectors.rows() || reftrack.rows() != alpha.size()) {
         throw std::runtime_error("Dimension mismatch in raceline calculation");
     }
@@ -174,66 +453,53 @@ MatrixXd calculateRaceline(const MatrixXd& reftrack, const MatrixXd& normvectors
     return raceline;
 }
 
-VectorXd calculateCurvature(const MatrixXd& raceline, const VectorXd& el_lengths, bool closed) {
+VectorXd calculateCurvature(const MatrixXd& raceline, const VectorXd& el_lengths, bool closed,
+                            const CurvCalcOptions& curv_opts) {
+    auto [psi, kappa] = calculateHeadingCurvature(raceline, el_lengths, closed, curv_opts);
+    return kappa;
+}
+
+std::tuple<VectorXd, VectorXd> calculateHeadingCurvature(const MatrixXd& raceline, const VectorXd& el_lengths,
+                                                         bool closed, const CurvCalcOptions& curv_opts) {
+    // The raceline is handed over as a transposed view (2 x N) without copying it
+    auto path = trajectory_planning_helpers::transposed_view(raceline.leftCols(2));
+    
+    if (!closed) {
+        // Open lines have no headings for the end conditions of the splines, heading and curvature are calculated
+        // numerically with the configured preview/review distances
+        return trajectory_planning_helpers::calc_head_curv_num(
+            path, el_lengths, closed,
+            curv_opts.d_preview_head, curv_opts.d_review_head,
+            curv_opts.d_preview_curv, curv_opts.d_review_curv,
+            true
+        );
+    }
+    
+    // Closed lines: cubic splines through the points, evaluated in closed form at every point
     int n_points = raceline.rows();
-    VectorXd curvature(n_points);
+    if (el_lengths.size() > 0 && el_lengths.size() != n_points) {
+        throw std::runtime_error("Closed raceline requires one element length per point");
+    }
     
-    // Use trajectory_planning_helpers for curvature calculation
-    trajectory_planning_helpers::Matrix2Xd path_2xn = raceline.transpose();
+    trajectory_planning_helpers::Matrix2Xd path_cl(2, n_points + 1);
+    path_cl.leftCols(n_points) = path;
+    path_cl.col(n_points) = path.col(0);
     
-    try {
-        auto [psi, kappa] = trajectory_planning_helpers::calc_head_curv_num(
-            path_2xn, el_lengths, closed, 1.0, 1.0, 2.0, 2.0, true
-        );
-        
-        curvature = kappa;
-        
-    } catch (const std::exception& e) {
-        std::cerr << "Warning: Could not calculate curvature using TPH, using fallback method" << std::endl;
-        
-        // Fallback: simple finite difference approximation
-        for (int i = 0; i < n_points; ++i) {
-            Vector2d p1, p2, p3;
-            
-            if (closed) {
-                p1 = raceline.row((i - 1 + n_points) % n_points);
-                p2 = raceline.row(i);
-                p3 = raceline.row((i + 1) % n_points);
-            } else {
-                if (i == 0) {
-                    p1 = raceline.row(0);
-                    p2 = raceline.row(1);
-                    p3 = raceline.row(2);
-                } else if (i == n_points - 1) {
-                    p1 = raceline.row(n_points - 3);
-                    p2 = raceline.row(n_points - 2);
-                    p3 = raceline.row(n_points - 1);
-                } else {
-                    p1 = raceline.row(i - 1);
-                    p2 = raceline.row(i);
-                    p3 = raceline.row(i + 1);
-                }
-            }
-            
-            // Calculate curvature using three-point method
-            Vector2d v1 = p2 - p1;
-            Vector2d v2 = p3 - p2;
-            
-            double cross = v1(0) * v2(1) - v1(1) * v2(0);
-            double dot = v1.dot(v2);
-            double norm_product = v1.norm() * v2.norm();
-            
-            if (norm_product > 1e-10) {
-                double angle_change = std::atan2(cross, dot);
-                double arc_length = (v1.norm() + v2.norm()) * 0.5;
-                curvature(i) = (arc_length > 1e-10) ? angle_change / arc_length : 0.0;
-            } else {
-                curvature(i) = 0.0;
-            }
-        }
+    VectorXd el_lengths_cl = el_lengths;
+    if (el_lengths_cl.size() == 0) {
+        el_lengths_cl = (path_cl.rightCols(n_points) - path_cl.leftCols(n_points)).colwise().norm().transpose();
     }
     
-    return curvature;
+    auto [coeffs_x, coeffs_y, a_interp, normvectors] = trajectory_planning_helpers::calc_splines(
+        path_cl, el_lengths_cl, 0.0, 0.0, true);
+    return calculateSplineHeadingCurvature(coeffs_x, coeffs_y);
+}
+
+std::tuple<VectorXd, VectorXd> calculateSplineHeadingCurvature(const MatrixXd& coeffs_x, const MatrixXd& coeffs_y) {
+    // Start of every spline (t = 0), i.e. at the points the splines were calculated for
+    VectorXd ind_spls = VectorXd::LinSpaced(coeffs_x.rows(), 0.0, static_cast<double>(coeffs_x.rows() - 1));
+    VectorXd t_spls = VectorXd::Zero(coeffs_x.rows());
+    return trajectory_planning_helpers::calc_head_curv_an(coeffs_x, coeffs_y, ind_spls, t_spls, true);
 }
 
 double calculateLapTime(const VectorXd& v_profile, const VectorXd& el_lengths) {
@@ -254,33 +520,4 @@ double calculateLapTime(const VectorXd& v_profile, const VectorXd& el_lengths) {
     return total_time;
 }
 
-bool exportToCSV(const OptimizationResult& result, const std::string& filename) {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    // Write header
-    file << "x_m,y_m,psi_rad,kappa_radpm,vx_mps,ax_mps2,s_m" << std::endl;
-    
-    int n_points = result.raceline.rows();
-    
-    for (int i = 0; i < n_points; ++i) {
-        file << result.raceline(i, 0) << ","
-             << result.raceline(i, 1) << ","
-             << "0.0,"  // psi (would need to calculate from raceline)
-             << result.kappa_opt(i) << ","
-             << result.v_opt(i) << ","
-             << "0.0,"  // ax (would need to calculate from velocity profile)
-             << result.s_opt(i) << std::endl;
-    }
-    
-    return true;
-}
-
-bool exportToLTPL(const OptimizationResult& result, const std::string& filename) {
-    // LTPL format export (simplified)
-    return exportToCSV(result, filename);
-}
-
 } // namespace global_racetrajectory_optimization::utils
\ No newline at end of file
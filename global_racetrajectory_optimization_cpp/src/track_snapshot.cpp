@@ -0,0 +1,235 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace global_racetrajectory_optimization::utils {
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'G', 'T', 'O', 'T', 'R', 'A', 'C', 'K'};
+constexpr uint32_t SNAPSHOT_VERSION = 3;  // 3: a_interp is the spline system from calc_splines (no placeholder)
+
+static_assert(sizeof(SparseMatrixXd::StorageIndex) == 4, "Snapshot format stores 32 bit sparse indices");
+
+// File layout: header, then reftrack, coeffs_x, coeffs_y, normvectors, el_lengths (doubles, column-major) and a_interp
+// in Eigen's compressed column storage (int32 outer index, int32 inner index, double values). Every section starts
+// 8 byte aligned
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t n_points;
+    uint32_t n_cols;             // reftrack columns
+    uint32_t n_coeffs;           // spline coefficients per row
+    uint64_t source_hash;
+    uint64_t options_hash;
+    uint64_t a_rows;
+    uint64_t a_cols;
+    uint64_t a_nnz;
+    uint64_t payload_size;       // bytes following the header
+};
+
+uint64_t aligned(uint64_t size) {
+    return (size + 7) & ~uint64_t(7);
+}
+
+uint64_t payloadSize(const SnapshotHeader& header) {
+    uint64_t n = header.n_points;
+    uint64_t n_doubles = n * header.n_cols + 2 * n * header.n_coeffs + 2 * n + n + header.a_nnz;
+    return 8 * n_doubles + aligned(4 * (header.a_cols + 1)) + aligned(4 * header.a_nnz);
+}
+
+} // namespace
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t hashFile(const std::string& filename) {
+    MappedFile file(filename);
+    return hashBytes(file.data(), file.size());
+}
+
+uint64_t hashPreparationOptions(const StepsizeOptions& stepsize_opts, const RegSmoothOptions& reg_smooth_opts) {
+    // Field by field, so that struct padding does not enter the hash
+    uint64_t hash = hashBytes(&SNAPSHOT_VERSION, sizeof(SNAPSHOT_VERSION));
+    hash = hashBytes(&stepsize_opts.stepsize_prep, sizeof(double), hash);
+    hash = hashBytes(&stepsize_opts.stepsize_reg, sizeof(double), hash);
+    hash = hashBytes(&reg_smooth_opts.k_reg, sizeof(int), hash);
+    hash = hashBytes(&reg_smooth_opts.s_reg, sizeof(double), hash);
+    return hash;
+}
+
+uint64_t hashValues(const std::vector<double>& values, uint64_t seed) {
+    return hashBytes(values.data(), sizeof(double) * values.size(), seed);
+}
+
+bool saveTrackSnapshot(const TrackData& track, uint64_t options_hash, const std::string& filename) {
+    ConstMatrixMap reftrack = track.reftrack();
+    int n_points = reftrack.rows();
+    
+    if (n_points == 0 || track.coeffs_x.rows() != n_points || track.coeffs_y.rows() != n_points
+        || track.coeffs_x.cols() != track.coeffs_y.cols() || track.normvectors.rows() != n_points
+        || track.normvectors.cols() != 2 || track.el_lengths.size() != n_points) {
+        std::cerr << "Cannot write snapshot of an unprepared track" << std::endl;
+        return false;
+    }
+    
+    SparseMatrixXd a_interp = track.a_interp;
+    a_interp.makeCompressed();
+    
+    SnapshotHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.n_points = static_cast<uint32_t>(n_points);
+    header.n_cols = static_cast<uint32_t>(reftrack.cols());
+    header.n_coeffs = static_cast<uint32_t>(track.coeffs_x.cols());
+    header.source_hash = track.source_hash;
+    header.options_hash = options_hash;
+    header.a_rows = static_cast<uint64_t>(a_interp.rows());
+    header.a_cols = static_cast<uint64_t>(a_interp.cols());
+    header.a_nnz = static_cast<uint64_t>(a_interp.nonZeros());
+    header.payload_size = payloadSize(header);
+    
+    // Written to a temporary file first, so that readers never see a partial snapshot
+    std::string tmp_filename = filename + ".tmp";
+    std::ofstream file(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Cannot create snapshot file: " << filename << std::endl;
+        return false;
+    }
+    
+    auto write = [&file](const void* data, size_t size) {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    
+    write(&header, sizeof(header));
+    write(reftrack.data(), sizeof(double) * reftrack.size());
+    write(track.coeffs_x.data(), sizeof(double) * track.coeffs_x.size());
+    write(track.coeffs_y.data(), sizeof(double) * track.coeffs_y.size());
+    write(track.normvectors.data(), sizeof(double) * track.normvectors.size());
+    write(track.el_lengths.data(), sizeof(double) * track.el_lengths.size());
+    write(a_interp.valuePtr(), sizeof(double) * header.a_nnz);
+    
+    const char padding[8] = {};
+    write(a_interp.outerIndexPtr(), 4 * (header.a_cols + 1));
+    write(padding, aligned(4 * (header.a_cols + 1)) - 4 * (header.a_cols + 1));
+    write(a_interp.innerIndexPtr(), 4 * header.a_nnz);
+    write(padding, aligned(4 * header.a_nnz) - 4 * header.a_nnz);
+    file.close();
+    
+    if (!file || std::rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Cannot write snapshot file: " << filename << std::endl;
+        std::remove(tmp_filename.c_str());
+        return false;
+    }
+    
+    return true;
+}
+
+bool loadTrackSnapshot(const std::string& filename, uint64_t source_hash, uint64_t options_hash, TrackData& track,
+                       std::shared_ptr<const SharedTables> reftrack_tables) {
+    MappedFile file;
+    try {
+        file = MappedFile(filename);
+    } catch (const std::exception&) {
+        return false;
+    }
+    
+    SnapshotHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Snapshot file too short: " << filename << std::endl;
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION) {
+        std::cerr << "Unknown snapshot format: " << filename << std::endl;
+        return false;
+    }
+    
+    if (header.source_hash != source_hash || header.options_hash != options_hash) {
+        return false;
+    }
+    
+    if (header.payload_size != payloadSize(header) || file.size() != sizeof(header) + header.payload_size) {
+        std::cerr << "Corrupt snapshot file: " << filename << std::endl;
+        return false;
+    }
+    
+    // Sections are read in place from the mapping, only copied into the result arrays
+    const char* pos = file.data() + sizeof(header);
+    auto read = [&pos](double* dest, size_t count) {
+        std::memcpy(dest, pos, sizeof(double) * count);
+        pos += sizeof(double) * count;
+    };
+    
+    int n_points = static_cast<int>(header.n_points);
+    TrackData result;
+    MatrixXd reftrack;
+    result.coeffs_x.resize(n_points, header.n_coeffs);
+    result.coeffs_y.resize(n_points, header.n_coeffs);
+    result.normvectors.resize(n_points, 2);
+    result.el_lengths.resize(n_points);
+    
+    // The reference track is taken from the given mapping when it holds the same table, otherwise it is copied into
+    // a new one
+    ConstMatrixMap shared = (reftrack_tables && reftrack_tables->contains("reftrack"))
+                            ? reftrack_tables->table("reftrack") : ConstMatrixMap(nullptr, 0, 0);
+    ConstMatrixMap stored(reinterpret_cast<const double*>(pos), n_points, header.n_cols);
+    if (shared.rows() == n_points && shared.cols() == header.n_cols
+        && std::memcmp(shared.data(), pos, sizeof(double) * stored.size()) == 0) {
+        result.setReftrack(reftrack_tables);
+    } else {
+        reftrack = stored;
+    }
+    pos += sizeof(double) * stored.size();
+    read(result.coeffs_x.data(), result.coeffs_x.size());
+    read(result.coeffs_y.data(), result.coeffs_y.size());
+    read(result.normvectors.data(), result.normvectors.size());
+    read(result.el_lengths.data(), result.el_lengths.size());
+    
+    const int32_t* outer = reinterpret_cast<const int32_t*>(pos + sizeof(double) * header.a_nnz);
+    const int32_t* inner = reinterpret_cast<const int32_t*>(pos + sizeof(double) * header.a_nnz
+                                                            + aligned(4 * (header.a_cols + 1)));
+    
+    bool valid = (outer[0] == 0 && outer[header.a_cols] == static_cast<int64_t>(header.a_nnz));
+    for (uint64_t j = 0; valid && j < header.a_cols; ++j) {
+        valid = outer[j + 1] >= outer[j];
+    }
+    for (uint64_t k = 0; valid && k < header.a_nnz; ++k) {
+        valid = inner[k] >= 0 && static_cast<uint64_t>(inner[k]) < header.a_rows;
+    }
+    
+    if (!valid) {
+        std::cerr << "Corrupt snapshot file: " << filename << std::endl;
+        return false;
+    }
+    
+    result.a_interp.resize(header.a_rows, header.a_cols);
+    result.a_interp.resizeNonZeros(header.a_nnz);
+    read(result.a_interp.valuePtr(), header.a_nnz);
+    std::memcpy(result.a_interp.outerIndexPtr(), outer, 4 * (header.a_cols + 1));
+    std::memcpy(result.a_interp.innerIndexPtr(), inner, 4 * header.a_nnz);
+    
+    result.track_name = track.track_name;
+    result.source_hash = header.source_hash;
+    if (!result.reftrackTables()) {
+        result.setReftrack(reftrack);
+    }
+    result.segment_index = std::make_shared<const trajectory_planning_helpers::SegmentIndex<double>>(
+        trajectory_planning_helpers::transposed_view(result.reftrack().leftCols(2)), true);
+    
+    track = std::move(result);
+    return true;
+}
+
+} // namespace global_racetrajectory_optimization::utils
@@ -0,0 +1,232 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace global_racetrajectory_optimization {
+
+namespace {
+
+// Splines computed per calc_splines call
+constexpr int SPLINE_BLOCK = 64;
+
+// Heading of the chord a -> b (0 = north, as in trajectory_planning_helpers). calc_splines takes a heading of exactly
+// 0.0 as "not given", so a chord pointing exactly north is nudged by one ulp
+double chordHeading(const MatrixXd& points, int a, int b) {
+    double psi = trajectory_planning_helpers::normalize_psi(
+        std::atan2(points(b, 1) - points(a, 1), points(b, 0) - points(a, 0)) - M_PI / 2.0);
+    return (psi == 0.0) ? std::nextafter(0.0, 1.0) : psi;
+}
+
+} // namespace
+
+TrackStreamPreparer::TrackStreamPreparer(const StepsizeOptions& stepsize_opts, SegmentCallback callback,
+                                         int segment_points, int overlap, bool closed)
+    : stepsize_(stepsize_opts.stepsize_reg), callback_(std::move(callback)), segment_points_(segment_points),
+      overlap_(overlap), closed_(closed) {
+    if (stepsize_ <= 0.0) {
+        throw std::runtime_error("Streaming preparation requires a positive stepsize_reg");
+    }
+    
+    if (overlap_ < 1 || segment_points_ < overlap_) {
+        throw std::runtime_error("Streaming preparation requires segment_points >= overlap >= 1");
+    }
+}
+
+void TrackStreamPreparer::add(const MatrixXd& points) {
+    if (finished_) {
+        throw std::runtime_error("Points added to a finished track stream");
+    }
+    
+    if (points.rows() == 0) {
+        return;
+    }
+    
+    // Same column handling as importTrack: only x, y provided gets default track widths
+    int n_cols = (points.cols() == 2) ? 4 : static_cast<int>(points.cols());
+    if (points.cols() != 2 && points.cols() < 4) {
+        throw std::runtime_error("Track stream must have columns [x, y] or [x, y, w_tr_right, w_tr_left]");
+    }
+    
+    if (window_.cols() == 0) {
+        window_.resize(segment_points_ + 4 * overlap_, n_cols);
+        head_.resize(2 * overlap_, n_cols);
+        
+        // The splines of the first points of a closed track need the end of the track as left context: these points
+        // are held back as left context of the first segment and emitted after the closing point
+        n_left_ = closed_ ? overlap_ : 0;
+    } else if (window_.cols() != n_cols) {
+        throw std::runtime_error("Track stream chunks have different numbers of columns");
+    }
+    
+    VectorXd point(n_cols);
+    for (Eigen::Index i = 0; i < points.rows(); ++i) {
+        if (points.cols() == 2) {
+            point << points(i, 0), points(i, 1), 3.0, 3.0;
+        } else {
+            point = points.row(i).transpose();
+        }
+        
+        if (raw_prev_.size() == 0) {
+            raw_prev_ = point;
+            addSample(point);
+            last_sample_s_ = 0.0;
+            n_samples_ = 1;
+            continue;
+        }
+        
+        double seg_length = (point.head<2>() - raw_prev_.head<2>()).norm();
+        if (seg_length < 1e-10) {
+            continue;
+        }
+        
+        // Samples at multiples of stepsize_reg along the raw polyline, all channels interpolated linearly
+        double s_sample = n_samples_ * stepsize_;
+        while (s_sample <= raw_s_ + seg_length) {
+            double t = (s_sample - raw_s_) / seg_length;
+            addSample((1.0 - t) * raw_prev_ + t * point);
+            last_sample_s_ = s_sample;
+            n_samples_++;
+            s_sample = n_samples_ * stepsize_;
+        }
+        
+        raw_prev_ = point;
+        raw_s_ += seg_length;
+    }
+}
+
+void TrackStreamPreparer::finish() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+    
+    // The last raw point ends the resampled track (shorter last step)
+    if (raw_prev_.size() > 0 && raw_s_ - last_sample_s_ > 1e-6) {
+        addSample(raw_prev_);
+    }
+    
+    if (n_points_ < (closed_ ? 3 : 2)) {
+        throw std::runtime_error("Track stream contains too few points");
+    }
+    
+    if (!closed_) {
+        emit(n_window_ - n_left_, 0);
+        return;
+    }
+    
+    // Explicitly closed input repeats the first point at the end
+    if ((window_.row(n_window_ - 1).head<2>() - head_.row(0).head<2>()).norm() < 1e-6) {
+        n_window_--;
+        n_points_--;
+    }
+    
+    // Closing segment: the end of the track, the held back first points (a track shorter than the overlap holds
+    // back all of them) and the points after them as right context (wrapping again on very short tracks)
+    n_left_ = std::min(n_left_, n_window_);
+    int n_core = n_window_ - n_left_;
+    int n_held = (n_segments_ == 0) ? n_left_ : overlap_;
+    
+    window_.middleRows(n_window_, n_held) = head_.topRows(n_held);
+    n_window_ += n_held;
+    for (int k = 0; k < overlap_; ++k) {
+        window_.row(n_window_++) = head_.row((n_held + k) % n_points_);
+    }
+    emit(n_core + n_held, overlap_);
+}
+
+void TrackStreamPreparer::addSample(const VectorXd& sample) {
+    if (closed_ && n_head_ < 2 * overlap_) {
+        head_.row(n_head_++) = sample.transpose();
+    }
+    
+    window_.row(n_window_++) = sample.transpose();
+    n_points_++;
+    
+    if (n_window_ == n_left_ + segment_points_ + overlap_) {
+        emit(segment_points_, overlap_);
+        
+        // The last overlap core points become the left context, the right context becomes the next core
+        int keep_from = n_left_ + segment_points_ - overlap_;
+        int n_keep = n_window_ - keep_from;
+        window_.topRows(n_keep) = window_.middleRows(keep_from, n_keep).eval();
+        n_window_ = n_keep;
+        n_left_ = overlap_;
+    }
+}
+
+void TrackStreamPreparer::emit(int n_core, int n_right) {
+    // Splines of the core points, the last point of an open track has none
+    int n_splines = (n_right > 0) ? n_core : n_core - 1;
+    int n_rows = n_left_ + n_core + n_right;
+    
+    // A closed track starts with the point after the held back ones
+    if (closed_ && n_segments_ == 0 && n_left_ < n_points_) {
+        n_emitted_ = n_left_;
+        s_emitted_ = (window_.middleRows(1, n_left_).leftCols(2) - window_.topRows(n_left_).leftCols(2))
+                         .rowwise().norm().sum();
+        s_first_ = s_emitted_;
+    }
+    
+    TrackSegment segment;
+    segment.index = n_segments_;
+    segment.first_point = n_emitted_;
+    segment.s_start = s_emitted_;
+    segment.reftrack = window_.middleRows(n_left_, n_core);
+    segment.coeffs_x.resize(n_splines, 4);
+    segment.coeffs_y.resize(n_splines, 4);
+    segment.normvectors.resize(n_splines, 2);
+    segment.el_lengths.resize(n_splines);
+    
+    // Open splines over blocks of the core plus the overlap context around them, with the chord headings at the
+    // block ends. Only the core splines are kept: the effect of the clamped block ends on the cubic splines decays
+    // by a factor of about 3.7 per context point, so they agree with the splines of the whole track no matter where
+    // the window was cut. The block size bounds the cost of calc_splines (which also sets up the sparse spline
+    // system)
+    for (int b0 = 0; b0 < n_splines; b0 += SPLINE_BLOCK) {
+        int b1 = std::min(b0 + SPLINE_BLOCK, n_splines);
+        int row_begin = std::max(0, n_left_ + b0 - overlap_);
+        int row_end = std::min(n_rows, n_left_ + b1 + overlap_);
+        int n_block = row_end - row_begin;
+        
+        MatrixXd path = window_.middleRows(row_begin, n_block).leftCols(2);
+        VectorXd el_lengths = (path.bottomRows(n_block - 1) - path.topRows(n_block - 1)).rowwise().norm();
+        
+        auto [coeffs_x, coeffs_y, a_interp, normvectors] = trajectory_planning_helpers::calc_splines(
+            trajectory_planning_helpers::transposed_view(path), el_lengths,
+            chordHeading(path, 0, 1), chordHeading(path, n_block - 2, n_block - 1), true);
+        
+        int offset = n_left_ + b0 - row_begin;
+        segment.coeffs_x.middleRows(b0, b1 - b0) = coeffs_x.middleRows(offset, b1 - b0);
+        segment.coeffs_y.middleRows(b0, b1 - b0) = coeffs_y.middleRows(offset, b1 - b0);
+        segment.normvectors.middleRows(b0, b1 - b0) = normvectors.middleRows(offset, b1 - b0);
+        segment.el_lengths.segment(b0, b1 - b0) = el_lengths.segment(offset, b1 - b0);
+    }
+    
+    callback_(segment);
+    
+    n_segments_++;
+    n_emitted_ += n_core;
+    s_emitted_ += segment.el_lengths.sum();
+}
+
+namespace utils {
+
+int prepareTrackStreaming(const std::string& filename, const StepsizeOptions& stepsize_opts,
+                          const TrackStreamPreparer::SegmentCallback& callback, int segment_points, bool closed,
+                          size_t chunk_bytes) {
+    CsvChunkReader reader(filename, ',', chunk_bytes);
+    TrackStreamPreparer preparer(stepsize_opts, callback, segment_points, 8, closed);
+    
+    for (MatrixXd chunk = reader.next(); chunk.rows() > 0; chunk = reader.next()) {
+        preparer.add(chunk);
+    }
+    
+    preparer.finish();
+    return preparer.numPoints();
+}
+
+} // namespace utils
+
+} // namespace global_racetrajectory_optimization
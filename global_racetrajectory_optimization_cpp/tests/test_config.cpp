@@ -0,0 +1,186 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+
+// Message of the std::runtime_error thrown by fn, empty if nothing is thrown
+template <typename Fn>
+std::string errorMessage(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+std::string configError(const std::string& text) {
+    return errorMessage([&] { Config::fromString(text, "test.ini"); });
+}
+
+Config stepsizeConfig(double stepsize_reg) {
+    return Config::fromString("[GENERAL_OPTIONS]\nstepsize_reg=" + std::to_string(stepsize_reg) + "\n", "test.ini");
+}
+
+} // namespace
+
+TEST(Config, ParsesTypedEntries) {
+    Config config = Config::fromString("[GENERAL_OPTIONS]\n# comment\nstepsize_reg=0.7\n"
+                                       "veh_params = {\"v_max\": 55.0,\n              \"mass\": 900}\n", "test.ini");
+    
+    EXPECT_DOUBLE_EQ(config.stepsize.stepsize_reg, 0.7);
+    EXPECT_DOUBLE_EQ(config.vehicle.v_max, 55.0);
+    EXPECT_DOUBLE_EQ(config.vehicle.mass, 900.0);
+    EXPECT_DOUBLE_EQ(config.number("GENERAL_OPTIONS.veh_params.mass"), 900.0);
+    ASSERT_NE(config.find("GENERAL_OPTIONS.veh_params.v_max"), nullptr);
+    EXPECT_EQ(config.find("GENERAL_OPTIONS.veh_params.v_max")->line, 4);
+    EXPECT_EQ(config.find("GENERAL_OPTIONS.veh_params.width"), nullptr);
+}
+
+TEST(Config, ErrorsReportFileAndLine) {
+    EXPECT_EQ(configError("[GENERAL_OPTIONS]\nveh_params = {\"v_max\": 70.0,\n              \"mas\": 1200.0}\n"),
+              "test.ini:3: unknown key 'GENERAL_OPTIONS.veh_params.mas'");
+    EXPECT_EQ(configError("[GENERAL_OPTIONS]\nstepsize_reg=fast\n"),
+              "test.ini:2: GENERAL_OPTIONS.stepsize_reg: expected a number, found 'fast'");
+    EXPECT_EQ(configError("[GENERAL_OPTIONS]\nstepsize_reg=-1.0\n"),
+              "test.ini:2: GENERAL_OPTIONS.stepsize_reg must be positive");
+    EXPECT_EQ(configError("[GENERAL_OPTIONS]\nstepsize_reg=1.0\nstepsize_reg=2.0\n"),
+              "test.ini:3: duplicate key 'GENERAL_OPTIONS.stepsize_reg' (first set on line 2)");
+    EXPECT_NE(configError("[GENERAL_OPTIONS]\nveh_params = {\"v_max\": 70.0\n"), "");
+}
+
+TEST(Config, MissingEntriesThrow) {
+    Config config = Config::fromString("[GENERAL_OPTIONS]\nggv_file=\"ggv.csv\"\n", "test.ini");
+    
+    EXPECT_EQ(errorMessage([&] { config.number("GENERAL_OPTIONS.v_max"); }),
+              "test.ini: missing key 'GENERAL_OPTIONS.v_max'");
+    EXPECT_EQ(errorMessage([&] { config.number("GENERAL_OPTIONS.ggv_file"); }),
+              "test.ini:2: GENERAL_OPTIONS.ggv_file: expected a number, found 'ggv.csv'");
+    EXPECT_THROW(Config(testing::TempDir() + "does_not_exist.ini"), std::runtime_error);
+}
+
+TEST(Config, NewPreparationOptionsPrepareFromTheImportedTrack) {
+    GlobalRaceTrajectoryOptimizer fresh;
+    ASSERT_TRUE(fresh.applyConfig(stepsizeConfig(2.0)));
+    ASSERT_TRUE(fresh.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(fresh.prepareTrack(false));
+    
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.applyConfig(stepsizeConfig(1.0)));
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    EXPECT_NE(optimizer.getTrackData().reftrack().rows(), fresh.getTrackData().reftrack().rows());
+    
+    // Options without influence on the preparation keep the prepared track
+    ASSERT_TRUE(optimizer.applyConfig(stepsizeConfig(1.0)));
+    EXPECT_TRUE(optimizer.optimizeShortestPath().success);
+    
+    ASSERT_TRUE(optimizer.applyConfig(stepsizeConfig(2.0)));
+    EXPECT_FALSE(optimizer.optimizeShortestPath().success);
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    EXPECT_EQ(optimizer.getTrackData().reftrack(), fresh.getTrackData().reftrack());
+    EXPECT_EQ(optimizer.getTrackData().normvectors, fresh.getTrackData().normvectors);
+}
+
+TEST(Config, PendingConfigIsAppliedByTheNextOptimization) {
+    GlobalRaceTrajectoryOptimizer fresh;
+    ASSERT_TRUE(fresh.applyConfig(stepsizeConfig(2.0)));
+    ASSERT_TRUE(fresh.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(fresh.prepareTrack(false));
+    
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.applyConfig(stepsizeConfig(1.0)));
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    
+    // Handed over from another thread, nothing changes until the optimizer thread reaches the next call
+    std::thread([&] { optimizer.setPendingConfig(stepsizeConfig(2.0)); }).join();
+    EXPECT_NE(optimizer.getTrackData().reftrack().rows(), fresh.getTrackData().reftrack().rows());
+    
+    OptimizationResult result = optimizer.optimizeShortestPath();
+    ASSERT_TRUE(result.success);
+    EXPECT_EQ(result.raceline.rows(), fresh.getTrackData().reftrack().rows());
+    EXPECT_EQ(optimizer.getTrackData().reftrack(), fresh.getTrackData().reftrack());
+}
+
+TEST(Config, PreparingAgainKeepsStartPointAndDirection) {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.applyConfig(stepsizeConfig(1.0)));
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    Vector2d new_start = optimizer.getTrackData().reftrack().row(250).head<2>().transpose();
+    optimizer.setStartPoint(new_start);
+    ASSERT_TRUE(optimizer.reverseDirection());
+    ASSERT_EQ(optimizer.getTrackData().start_index, 250);
+    
+    // Same calls on a track prepared for the new options right away
+    GlobalRaceTrajectoryOptimizer fresh;
+    ASSERT_TRUE(fresh.applyConfig(stepsizeConfig(2.0)));
+    ASSERT_TRUE(fresh.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(fresh.prepareTrack(false));
+    fresh.setStartPoint(new_start);
+    ASSERT_TRUE(fresh.reverseDirection());
+    ASSERT_NE(fresh.getTrackData().start_index, 0);
+    
+    optimizer.setPendingConfig(stepsizeConfig(2.0));
+    ASSERT_TRUE(optimizer.optimizeShortestPath().success);
+    
+    const TrackData& track = optimizer.getTrackData();
+    EXPECT_EQ(track.reftrack(), fresh.getTrackData().reftrack());
+    EXPECT_EQ(track.normvectors, fresh.getTrackData().normvectors);
+    EXPECT_EQ(track.coeffs_x, fresh.getTrackData().coeffs_x);
+    EXPECT_EQ(track.start_index, fresh.getTrackData().start_index);
+    EXPECT_LT((track.reftrack().row(0).head<2>().transpose() - new_start).norm(), 1.0);
+    
+    // Without start point and direction the preparation starts at the first imported point again
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    EXPECT_EQ(optimizer.getTrackData().start_index, 0);
+    EXPECT_GT((optimizer.getTrackData().reftrack().row(0).head<2>().transpose() - new_start).norm(), 10.0);
+}
+
+TEST(ConfigWatcher, PassesValidChangesOnly) {
+    std::string path = testing::TempDir() + "config_watcher_test.ini";
+    std::ofstream(path, std::ios::trunc) << "[GENERAL_OPTIONS]\nstepsize_reg=1.0\n";
+    
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<double> seen;
+    
+    auto waitForChanges = [&](size_t n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return changed.wait_for(lock, std::chrono::seconds(5), [&] { return seen.size() >= n; });
+    };
+    
+    {
+        ConfigWatcher watcher(path, [&](const Config& config) {
+            std::lock_guard<std::mutex> lock(mutex);
+            seen.push_back(config.stepsize.stepsize_reg);
+            changed.notify_all();
+        }, 10);
+        
+        // Invalid versions are skipped, the next valid one is passed on
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::ofstream(path, std::ios::trunc) << "[GENERAL_OPTIONS]\nstepsize_reg=fast\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::ofstream(path, std::ios::trunc) << "[GENERAL_OPTIONS]\nstepsize_reg=2.5\n";
+        EXPECT_TRUE(waitForChanges(1));
+    }
+    
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_DOUBLE_EQ(seen[0], 2.5);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,129 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+std::string writeFile(const std::string& name, const std::string& content) {
+    std::string path = testing::TempDir() + name;
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+MatrixXd parse(const std::string& text, char delimiter = ',') {
+    return utils::parseCSV(text.data(), text.size(), delimiter, "test.csv");
+}
+
+// Message of the std::runtime_error thrown by fn, empty if nothing is thrown
+template <typename Fn>
+std::string errorMessage(Fn fn) {
+    try {
+        fn();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+} // namespace
+
+TEST(CsvReader, SkipsHeaderCommentsAndBlankLines) {
+    MatrixXd table = parse("# x_m, y_m\nx,y,w\n\n1.5,-2,+3\n  # comment\n4, 5 ,6,\r\n7e1,8,9");
+    
+    ASSERT_EQ(table.rows(), 3);
+    ASSERT_EQ(table.cols(), 3);
+    EXPECT_DOUBLE_EQ(table(0, 0), 1.5);
+    EXPECT_DOUBLE_EQ(table(0, 1), -2.0);
+    EXPECT_DOUBLE_EQ(table(0, 2), 3.0);
+    EXPECT_DOUBLE_EQ(table(1, 1), 5.0);
+    EXPECT_DOUBLE_EQ(table(1, 2), 6.0);
+    EXPECT_DOUBLE_EQ(table(2, 0), 70.0);
+}
+
+TEST(CsvReader, OtherDelimiter) {
+    MatrixXd table = parse("1;2\n3;4\n", ';');
+    
+    ASSERT_EQ(table.rows(), 2);
+    EXPECT_DOUBLE_EQ(table(1, 0), 3.0);
+    EXPECT_DOUBLE_EQ(table(1, 1), 4.0);
+}
+
+TEST(CsvReader, HeaderOnlyIsEmpty) {
+    EXPECT_EQ(parse("x,y\n# nothing\n").size(), 0);
+    EXPECT_EQ(parse("").size(), 0);
+}
+
+TEST(CsvReader, RaggedRowsReportTheLine) {
+    EXPECT_EQ(errorMessage([] { parse("x,y,z\n1,2,3\n4,5\n"); }), "test.csv:3: expected 3 cells, found 2");
+    EXPECT_EQ(errorMessage([] { parse("1,2\n3,4,5\n"); }), "test.csv:2: expected 2 cells");
+}
+
+TEST(CsvReader, MalformedCellsReportTheLine) {
+    EXPECT_EQ(errorMessage([] { parse("1,2\n3,abc\n"); }), "test.csv:2: cannot parse cell 2 'abc'");
+    EXPECT_EQ(errorMessage([] { parse("1,2\n3,4x\n"); }), "test.csv:2: unexpected characters 'x' in cell 2");
+    EXPECT_EQ(errorMessage([] { parse("1,2\n,4\n"); }), "test.csv:2: cannot parse cell 1 ''");
+}
+
+TEST(CsvReader, MissingFileThrows) {
+    std::string path = testing::TempDir() + "does_not_exist.csv";
+    EXPECT_EQ(errorMessage([&] { utils::readCSV(path); }), "Cannot open file: " + path);
+    EXPECT_THROW(CsvChunkReader reader(path), std::runtime_error);
+}
+
+TEST(CsvReader, ReadsMappedFile) {
+    std::string path = writeFile("mapped.csv", "x,y\n1,2\n3,4\n");
+    MatrixXd table = utils::readCSV(path);
+    
+    ASSERT_EQ(table.rows(), 2);
+    EXPECT_DOUBLE_EQ(table(1, 1), 4.0);
+    std::remove(path.c_str());
+}
+
+TEST(CsvReader, ChunksMatchWholeFile) {
+    // Lines split across the minimum block size of 4096 bytes
+    std::string content = "# t, x, y\nt,x,y\n";
+    for (int i = 0; i < 2000; ++i) {
+        content += std::to_string(i) + "," + std::to_string(0.25 * i) + "," + std::to_string(-1.5 * i) + "\n";
+    }
+    std::string path = writeFile("chunks.csv", content);
+    MatrixXd whole = utils::readCSV(path);
+    
+    CsvChunkReader reader(path, ',', 1);
+    MatrixXd joined(0, 3);
+    int n_chunks = 0;
+    for (MatrixXd rows = reader.next(); rows.rows() > 0; rows = reader.next()) {
+        EXPECT_EQ(reader.cols(), 3);
+        joined.conservativeResize(joined.rows() + rows.rows(), Eigen::NoChange);
+        joined.bottomRows(rows.rows()) = rows;
+        n_chunks++;
+    }
+    
+    EXPECT_GT(n_chunks, 1);
+    EXPECT_TRUE(reader.done());
+    ASSERT_EQ(joined.rows(), 2000);
+    EXPECT_EQ(joined, whole);
+    std::remove(path.c_str());
+}
+
+TEST(CsvReader, ChunkErrorsReportTheFileLine) {
+    std::string content = "t,x\n";
+    for (int i = 0; i < 1000; ++i) {
+        content += std::to_string(i) + "," + std::to_string(i) + "\n";
+    }
+    content += "1000,bad\n";
+    std::string path = writeFile("chunk_error.csv", content);
+    
+    CsvChunkReader reader(path, ',', 1);
+    std::string message = errorMessage([&] {
+        while (reader.next().rows() > 0) {
+        }
+    });
+    
+    EXPECT_EQ(message, path + ":1002: cannot parse cell 2 'bad'");
+    std::remove(path.c_str());
+}
@@ -0,0 +1,213 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::vector<double> VALUES = {M_PI, -1.0 / 3.0, 0.1 + 0.2, 1e-300, -2.5e17, 123456789.0, 0.0, 1.0e6, 42.0,
+                                    std::numeric_limits<double>::max(), -7.25e-5};
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+// Circle result with one raceline point per reference point
+void circleTrackAndResult(int n, TrackData& track, OptimizationResult& result) {
+    MatrixXd reftrack(n, 4);
+    track.normvectors.resize(n, 2);
+    result.raceline.resize(n, 2);
+    result.alpha_opt.resize(n);
+    result.s_opt.resize(n);
+    result.psi_opt.resize(n);
+    result.kappa_opt = VectorXd::Constant(n, 1.0 / 30.0);
+    result.v_opt.resize(n);
+    result.ax_opt.resize(n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        reftrack.row(i) << 30.0 * std::cos(a), 30.0 * std::sin(a), 2.0 + 0.01 * i, 2.5;
+        track.normvectors.row(i) << -std::cos(a), -std::sin(a);
+        result.alpha_opt(i) = 0.3 * std::sin(3.0 * a);
+        result.raceline.row(i) = reftrack.row(i).head<2>() + result.alpha_opt(i) * track.normvectors.row(i);
+        result.s_opt(i) = 30.0 * a;
+        result.psi_opt(i) = std::remainder(a + 0.5 * M_PI, 2.0 * M_PI);
+        result.v_opt(i) = 20.0 + std::sqrt(i);
+        result.ax_opt(i) = std::cos(a) / 7.0;
+    }
+    track.setReftrack(reftrack);
+    track.source_hash = 0x00c0ffee12345678ULL;
+    result.success = true;
+}
+
+class CsvWriterTest : public testing::Test {
+protected:
+    std::string path_ = testing::TempDir() + "csv_writer_test.csv";
+    
+    // All values in one row
+    void writeValues(CsvWriter& writer) {
+        for (size_t k = 0; k < VALUES.size(); ++k) {
+            if (k > 0) {
+                writer.writeSeparator();
+            }
+            writer.writeValue(VALUES[k]);
+        }
+        writer.endRow();
+    }
+    
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+};
+
+} // namespace
+
+TEST_F(CsvWriterTest, ShortestRepresentationReadsBackExactly) {
+    for (int precision : {0, -1}) {
+        {
+            CsvWriter writer(path_, precision);
+            ASSERT_TRUE(writer.isOpen());
+            writeValues(writer);
+            ASSERT_TRUE(writer.close());
+        }
+        
+        MatrixXd table = utils::readCSV(path_);
+        ASSERT_EQ(table.rows(), 1);
+        ASSERT_EQ(table.cols(), static_cast<Eigen::Index>(VALUES.size()));
+        for (size_t k = 0; k < VALUES.size(); ++k) {
+            EXPECT_EQ(table(0, k), VALUES[k]) << "value " << k;
+        }
+    }
+}
+
+TEST_F(CsvWriterTest, DefaultPrecisionMatchesStreamOutput) {
+    {
+        CsvWriter writer(path_);
+        writeValues(writer);
+        ASSERT_TRUE(writer.close());
+    }
+    
+    // Default stream formatting: 6 significant digits, general notation
+    std::ostringstream expected;
+    for (size_t k = 0; k < VALUES.size(); ++k) {
+        expected << (k > 0 ? "," : "") << VALUES[k];
+    }
+    expected << "\n";
+    EXPECT_EQ(readFile(path_), expected.str());
+}
+
+TEST_F(CsvWriterTest, SmallBufferWrapsWithoutChangingTheOutput) {
+    std::string long_text = "# " + std::string(1000, 'x') + "\n";  // comment line, skipped when reading back
+    
+    // Reference with one large buffer, then with the smallest one (a few numbers per buffer, texts larger than it)
+    std::string contents[2];
+    for (size_t buffer_size : {size_t(1) << 20, size_t(1)}) {
+        {
+            CsvWriter writer(path_, 0, ';', buffer_size);
+            writer.writeText("# header\n");
+            for (int row = 0; row < 300; ++row) {
+                writeValues(writer);
+                if (row % 50 == 7) {
+                    writer.writeText(long_text);
+                }
+            }
+            ASSERT_TRUE(writer.close());
+        }
+        contents[buffer_size == 1] = readFile(path_);
+    }
+    
+    EXPECT_EQ(contents[0], contents[1]);
+    EXPECT_EQ(contents[1].compare(0, 9, "# header\n"), 0);
+    EXPECT_NE(contents[1].find(long_text), std::string::npos);
+    
+    MatrixXd table = utils::readCSV(path_, ';');
+    ASSERT_EQ(table.rows(), 300);
+    EXPECT_EQ(table(299, 0), VALUES[0]);
+    EXPECT_EQ(table(123, VALUES.size() - 1), VALUES.back());
+}
+
+TEST_F(CsvWriterTest, BatchExportMatchesSingleExports) {
+    TrackData track;
+    std::vector<OptimizationResult> results(3);
+    for (size_t k = 0; k < results.size(); ++k) {
+        circleTrackAndResult(40 + 10 * k, track, results[k]);
+    }
+    
+    std::vector<std::string> files;
+    for (size_t k = 0; k < results.size(); ++k) {
+        files.push_back(testing::TempDir() + "csv_writer_batch_" + std::to_string(k) + ".csv");
+    }
+    ASSERT_TRUE(utils::exportToCSV(results, files, 0, 2));
+    
+    for (size_t k = 0; k < results.size(); ++k) {
+        ASSERT_TRUE(utils::exportToCSV(results[k], path_, 0));
+        EXPECT_EQ(readFile(files[k]), readFile(path_));
+        
+        MatrixXd table = utils::readCSV(files[k]);
+        ASSERT_EQ(table.rows(), results[k].raceline.rows());
+        ASSERT_EQ(table.cols(), 7);
+        EXPECT_EQ(MatrixXd(table.leftCols(2)), results[k].raceline);
+        EXPECT_EQ(VectorXd(table.col(4)), results[k].v_opt);
+        EXPECT_EQ(VectorXd(table.col(6)), results[k].s_opt);
+        std::remove(files[k].c_str());
+    }
+    
+    files.pop_back();
+    EXPECT_FALSE(utils::exportToCSV(results, files, 0, 2));
+}
+
+TEST_F(CsvWriterTest, LtplExportRoundTrips) {
+    TrackData track;
+    OptimizationResult result;
+    circleTrackAndResult(60, track, result);
+    ASSERT_TRUE(utils::exportToLTPL(track, result, path_));
+    
+    std::istringstream lines(readFile(path_));
+    std::string line;
+    std::getline(lines, line);
+    EXPECT_EQ(line, "# 00c0ffee12345678");
+    std::getline(lines, line);
+    EXPECT_EQ(line.rfind("# x_ref_m;", 0), 0u);
+    std::getline(lines, line);
+    EXPECT_EQ(std::count(line.begin(), line.end(), ';'), 11);
+    
+    MatrixXd table = utils::readCSV(path_, ';');
+    ASSERT_EQ(table.rows(), 60);
+    ASSERT_EQ(table.cols(), 12);
+    EXPECT_EQ(MatrixXd(table.leftCols(4)), MatrixXd(track.reftrack()));
+    EXPECT_EQ(MatrixXd(table.middleCols(4, 2)), track.normvectors);
+    EXPECT_EQ(VectorXd(table.col(6)), result.alpha_opt);
+    EXPECT_EQ(VectorXd(table.col(7)), result.s_opt);
+    EXPECT_EQ(VectorXd(table.col(8)), result.psi_opt);
+    EXPECT_EQ(VectorXd(table.col(9)), result.kappa_opt);
+    EXPECT_EQ(VectorXd(table.col(10)), result.v_opt);
+    EXPECT_EQ(VectorXd(table.col(11)), result.ax_opt);
+}
+
+TEST_F(CsvWriterTest, LtplExportRejectsRowCountMismatch) {
+    TrackData track;
+    OptimizationResult result;
+    circleTrackAndResult(60, track, result);
+    
+    OptimizationResult shorter = result;
+    shorter.v_opt.conservativeResize(59);
+    EXPECT_FALSE(utils::exportToLTPL(track, shorter, path_));
+    EXPECT_FALSE(std::ifstream(path_).good());
+    
+    OptimizationResult resampled = result;
+    resampled.raceline.conservativeResize(120, 2);
+    EXPECT_FALSE(utils::exportToLTPL(track, resampled, path_));
+    
+    TrackData no_normals = track;
+    no_normals.normvectors.resize(0, 2);
+    EXPECT_FALSE(utils::exportToLTPL(no_normals, result, path_));
+}
@@ -0,0 +1,61 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+// Counter-clockwise circle, normals pointing left (to the centre), widths [right, left] per point
+TrackData circleTrack(int n, double radius, double w_right, double w_left) {
+    TrackData track;
+    MatrixXd reftrack(n, 4);
+    track.normvectors.resize(n, 2);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        reftrack.row(i) << radius * std::cos(a), radius * std::sin(a), w_right, w_left;
+        track.normvectors.row(i) << -std::cos(a), -std::sin(a);
+    }
+    track.setReftrack(reftrack);
+    track.el_lengths = VectorXd::Constant(n, 2.0 * M_PI * radius / n);
+    return track;
+}
+
+} // namespace
+
+TEST(FootprintBounds, WideTrackKeepsReferenceLineInside) {
+    TrackData track = circleTrack(300, 60.0, 4.0, 4.0);
+    TrackBoundaries boundaries(track);
+    CorridorDistanceField field = utils::calculateCorridorDistanceField(track, boundaries, 0.05);
+    MatrixXd bounds = utils::calculateFootprintBounds(track, field, VehicleParameters());
+    
+    MatrixXd reftrack = track.reftrack();
+    EXPECT_EQ(utils::applyFootprintBounds(reftrack, bounds), 0);
+    for (int i = 0; i < reftrack.rows(); ++i) {
+        EXPECT_GT(reftrack(i, 2), 0.0);
+        EXPECT_GT(reftrack(i, 3), 0.0);
+        EXPECT_LT(reftrack(i, 2), 4.0);
+        EXPECT_LT(reftrack(i, 3), 4.0);
+    }
+}
+
+TEST(FootprintBounds, CollapsedBoundsAreClampedToZeroWidth) {
+    // Too narrow on the right for the vehicle at the reference line: the bounds collapse onto a shift to the left
+    TrackData track = circleTrack(300, 60.0, 0.4, 5.0);
+    TrackBoundaries boundaries(track);
+    CorridorDistanceField field = utils::calculateCorridorDistanceField(track, boundaries, 0.05);
+    MatrixXd bounds = utils::calculateFootprintBounds(track, field, VehicleParameters());
+    ASSERT_GT(bounds(0, 0), 0.0);
+    
+    MatrixXd reftrack = track.reftrack();
+    EXPECT_EQ(utils::applyFootprintBounds(reftrack, bounds), reftrack.rows());
+    EXPECT_GE(reftrack.col(2).minCoeff(), 0.0);
+    EXPECT_GE(reftrack.col(3).minCoeff(), 0.0);
+    EXPECT_EQ(reftrack(0, 2), 0.0);
+}
+
+TEST(FootprintBounds, RejectsMismatchedBounds) {
+    TrackData track = circleTrack(50, 20.0, 3.0, 3.0);
+    MatrixXd reftrack = track.reftrack();
+    EXPECT_THROW(utils::applyFootprintBounds(reftrack, MatrixXd::Zero(49, 2)), std::runtime_error);
+}
@@ -0,0 +1,150 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+constexpr int N_POINTS = 100;
+constexpr double RADIUS = 50.0;
+
+// Circle driven counter-clockwise, heading crossing +/-pi between points 24 and 25, speed rising by 0.1 per point
+OptimizationResult circleResult() {
+    double chord = 2.0 * RADIUS * std::sin(M_PI / N_POINTS);
+    
+    OptimizationResult result;
+    result.success = true;
+    result.raceline.resize(N_POINTS, 2);
+    result.s_opt.resize(N_POINTS);
+    result.psi_opt.resize(N_POINTS);
+    result.kappa_opt = VectorXd::Constant(N_POINTS, 1.0 / RADIUS);
+    result.v_opt.resize(N_POINTS);
+    result.ax_opt.resize(N_POINTS);
+    for (int i = 0; i < N_POINTS; ++i) {
+        double a = 2.0 * M_PI * i / N_POINTS;
+        result.raceline.row(i) << RADIUS * std::cos(a), RADIUS * std::sin(a);
+        result.s_opt(i) = i * chord;
+        result.psi_opt(i) = std::remainder(a + 0.5 * M_PI + M_PI / N_POINTS, 2.0 * M_PI);
+        result.v_opt(i) = 30.0 + 0.1 * i;
+        result.ax_opt(i) = 0.01 * i;
+    }
+    return result;
+}
+
+class RacelineTableTest : public testing::Test {
+protected:
+    OptimizationResult result_ = circleResult();
+    double chord_ = result_.s_opt(1);
+    double lap_ = N_POINTS * chord_;
+    RacelineTable table_{result_, chord_ / 4.0, 30.0};
+};
+
+} // namespace
+
+TEST_F(RacelineTableTest, InterpolatesBetweenThePoints) {
+    ASSERT_EQ(table_.numSamples(), 4 * N_POINTS);
+    EXPECT_NEAR(table_.lapLength(), lap_, 1e-9);
+    EXPECT_NEAR(table_.stepsize(), chord_ / 4.0, 1e-12);
+    
+    for (int i : {0, 7, 50, 98}) {
+        RacelineTable::Sample on_point = table_.at(i * chord_);
+        EXPECT_NEAR(on_point.x, result_.raceline(i, 0), 1e-9);
+        EXPECT_NEAR(on_point.y, result_.raceline(i, 1), 1e-9);
+        EXPECT_NEAR(on_point.vx, result_.v_opt(i), 1e-9);
+        EXPECT_NEAR(on_point.ax, result_.ax_opt(i), 1e-9);
+        EXPECT_NEAR(on_point.kappa, 1.0 / RADIUS, 1e-12);
+        
+        // Linear between the points, also between the table samples
+        RacelineTable::Sample between = table_.at((i + 0.3) * chord_);
+        Eigen::RowVector2d expected = 0.7 * result_.raceline.row(i) + 0.3 * result_.raceline.row(i + 1);
+        EXPECT_NEAR(between.x, expected(0), 1e-9);
+        EXPECT_NEAR(between.y, expected(1), 1e-9);
+        EXPECT_NEAR(between.vx, 30.0 + 0.1 * (i + 0.3), 1e-9);
+        EXPECT_NEAR(between.s, (i + 0.3) * chord_, 1e-9);
+    }
+}
+
+TEST_F(RacelineTableTest, WrapsAroundTheLap) {
+    for (double s : {0.0, 3.3, 0.5 * lap_, lap_ - 0.1}) {
+        RacelineTable::Sample base = table_.at(s);
+        for (double laps : {-2.0, -1.0, 1.0, 3.0}) {
+            RacelineTable::Sample wrapped = table_.at(s + laps * lap_);
+            EXPECT_NEAR(wrapped.s, base.s, 1e-9);
+            EXPECT_NEAR(wrapped.x, base.x, 1e-9);
+            EXPECT_NEAR(wrapped.y, base.y, 1e-9);
+            EXPECT_NEAR(wrapped.vx, base.vx, 1e-9);
+        }
+    }
+    
+    // The closing segment runs from the last point back to the first
+    RacelineTable::Sample closing = table_.at(-0.5 * chord_);
+    EXPECT_NEAR(closing.s, lap_ - 0.5 * chord_, 1e-9);
+    EXPECT_NEAR(closing.vx, 0.5 * (result_.v_opt(N_POINTS - 1) + result_.v_opt(0)), 1e-9);
+    Eigen::RowVector2d expected = 0.5 * (result_.raceline.row(N_POINTS - 1) + result_.raceline.row(0));
+    EXPECT_NEAR(closing.x, expected(0), 1e-9);
+    EXPECT_NEAR(closing.y, expected(1), 1e-9);
+}
+
+TEST_F(RacelineTableTest, HeadingInterpolatesAcrossPi) {
+    // psi is 0.99 pi at point 24 and -0.99 pi at point 25
+    EXPECT_NEAR(std::abs(table_.at(24.5 * chord_).psi), M_PI, 1e-9);
+    EXPECT_NEAR(table_.at(24.25 * chord_).psi, 0.995 * M_PI, 1e-9);
+    EXPECT_NEAR(table_.at(24.75 * chord_).psi, -0.995 * M_PI, 1e-9);
+    EXPECT_NEAR(table_.at(24.6 * chord_).psi, -0.998 * M_PI, 1e-9);
+}
+
+TEST_F(RacelineTableTest, HorizonContinuesPastTheLapEnd) {
+    double s = lap_ - 5.0;
+    RacelineTable::HorizonView horizon = table_.horizon(s, 20.0);
+    
+    int i_start = static_cast<int>(s / table_.stepsize());
+    EXPECT_EQ(horizon.data(), table_.samples().data() + i_start * RacelineTable::N_CHANNELS);
+    ASSERT_EQ(horizon.cols(), static_cast<Eigen::Index>(std::ceil(20.0 / table_.stepsize())) + 1);
+    
+    for (Eigen::Index k = 0; k < horizon.cols(); ++k) {
+        double s_k = horizon(RacelineTable::S, k);
+        EXPECT_NEAR(s_k, (i_start + k) * table_.stepsize(), 1e-9);
+        
+        RacelineTable::Sample sample = table_.at(s_k);
+        EXPECT_NEAR(horizon(RacelineTable::X, k), sample.x, 1e-9);
+        EXPECT_NEAR(horizon(RacelineTable::Y, k), sample.y, 1e-9);
+        EXPECT_NEAR(horizon(RacelineTable::VX, k), sample.vx, 1e-9);
+    }
+    EXPECT_GT(horizon(RacelineTable::S, horizon.cols() - 1), lap_ + 14.0);
+}
+
+TEST_F(RacelineTableTest, HorizonBeyondTheMaximumThrows) {
+    EXPECT_NO_THROW(table_.horizon(lap_ - 0.01, 30.0));
+    EXPECT_THROW(table_.horizon(0.0, 35.0), std::runtime_error);
+    
+    // Without a maximum one lap ahead is available
+    RacelineTable one_lap(result_, 1.0);
+    EXPECT_NO_THROW(one_lap.horizon(0.7 * lap_, lap_));
+    EXPECT_THROW(one_lap.horizon(0.0, 1.5 * lap_), std::runtime_error);
+}
+
+TEST_F(RacelineTableTest, ShiftedArcLengthStartsAtZero) {
+    OptimizationResult shifted = result_;
+    shifted.s_opt.array() += 123.0;
+    RacelineTable table(shifted, chord_ / 4.0, 30.0);
+    
+    ASSERT_EQ(table.samples().cols(), table_.samples().cols());
+    EXPECT_LT((table.samples() - table_.samples()).cwiseAbs().maxCoeff(), 1e-9);
+    EXPECT_NEAR(table.at(0.0).x, result_.raceline(0, 0), 1e-9);
+    EXPECT_NEAR(table.at(10.0 * chord_).vx, result_.v_opt(10), 1e-9);
+}
+
+TEST_F(RacelineTableTest, InvalidResultsThrow) {
+    OptimizationResult single = result_;
+    single.raceline.conservativeResize(1, 2);
+    EXPECT_THROW(RacelineTable table(single), std::runtime_error);
+    
+    OptimizationResult mismatch = result_;
+    mismatch.v_opt.conservativeResize(N_POINTS - 1);
+    EXPECT_THROW(RacelineTable table(mismatch), std::runtime_error);
+    
+    EXPECT_THROW(RacelineTable table(result_, 0.0), std::runtime_error);
+    EXPECT_THROW(RacelineTable().at(0.0), std::runtime_error);
+}
@@ -0,0 +1,197 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+// Byte offsets in the archive header
+constexpr size_t N_POINTS_TOTAL_OFFSET = 32;
+constexpr size_t DIRECTORY_OFFSET_OFFSET = 48;
+constexpr size_t RECORDS_OFFSET = 64;
+
+OptimizationResult testResult(int n, double phase) {
+    OptimizationResult result;
+    result.success = true;
+    result.lap_time = 80.0 + phase;
+    result.optimization_time = 0.5 * phase;
+    result.raceline.resize(n, 2);
+    result.s_opt.resize(n);
+    result.psi_opt.resize(n);
+    result.kappa_opt.resize(n);
+    result.v_opt.resize(n);
+    result.ax_opt.resize(n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n + phase;
+        result.raceline.row(i) << 50.0 * std::cos(a), 30.0 * std::sin(a);
+        result.s_opt(i) = 1.7 * i;
+        result.psi_opt(i) = std::remainder(a, 2.0 * M_PI);
+        result.kappa_opt(i) = 0.02 * std::sin(3.0 * a);
+        result.v_opt(i) = 40.0 + 10.0 * std::cos(a);
+        result.ax_opt(i) = -std::sin(a);
+    }
+    return result;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+uint64_t getWord(const std::string& content, size_t offset) {
+    uint64_t value;
+    std::memcpy(&value, content.data() + offset, sizeof(value));
+    return value;
+}
+
+void putWord(std::string& content, size_t offset, uint64_t value) {
+    std::memcpy(&content[offset], &value, sizeof(value));
+}
+
+class ResultArchiveTest : public testing::TestWithParam<bool> {
+protected:
+    std::string path_ = testing::TempDir() + "result_archive_test.bin";
+    std::vector<OptimizationResult> results_ = {testResult(120, 0.0), testResult(0, 1.0), testResult(75, 2.0)};
+    
+    // Archive of results_ with two parameters per result, delta encoded for GetParam()
+    std::string writeArchive() {
+        ResultArchiveWriter writer(path_, 2, GetParam());
+        for (size_t r = 0; r < results_.size(); ++r) {
+            writer.add(results_[r], Vector2d(double(r), -0.5 * r));
+        }
+        EXPECT_TRUE(writer.close());
+        return readFile(path_);
+    }
+    
+    // Offset of word k of the directory of channel c
+    size_t directoryWord(const std::string& content, int c, int k) const {
+        return getWord(content, DIRECTORY_OFFSET_OFFSET) + 8 * (c * (results_.size() + 3) + k);
+    }
+    
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+};
+
+} // namespace
+
+TEST_P(ResultArchiveTest, RoundTrip) {
+    writeArchive();
+    ResultArchiveReader reader(path_);
+    
+    ASSERT_EQ(reader.numResults(), 3);
+    EXPECT_EQ(reader.numParameters(), 2);
+    EXPECT_EQ(reader.deltaEncoded(), GetParam());
+    
+    for (int r = 0; r < 3; ++r) {
+        const OptimizationResult& expected = results_[r];
+        ResultArchiveReader::ResultInfo info = reader.info(r);
+        EXPECT_EQ(info.n_points, expected.raceline.rows());
+        EXPECT_EQ(info.lap_time, expected.lap_time);
+        EXPECT_EQ(info.optimization_time, expected.optimization_time);
+        EXPECT_EQ(info.parameters, Vector2d(r, -0.5 * r));
+        
+        // Lossless in both encodings
+        OptimizationResult loaded = reader.result(r);
+        EXPECT_EQ(loaded.raceline, expected.raceline);
+        EXPECT_EQ(loaded.s_opt, expected.s_opt);
+        EXPECT_EQ(loaded.psi_opt, expected.psi_opt);
+        EXPECT_EQ(loaded.kappa_opt, expected.kappa_opt);
+        EXPECT_EQ(loaded.v_opt, expected.v_opt);
+        EXPECT_EQ(loaded.ax_opt, expected.ax_opt);
+    }
+    
+    VectorXd v_all = reader.column(RacelineTable::VX);
+    ASSERT_EQ(v_all.size(), 195);
+    EXPECT_EQ(v_all.tail(75), results_[2].v_opt);
+    
+    if (!GetParam()) {
+        EXPECT_EQ(VectorXd(reader.columnView(RacelineTable::VX)), v_all);
+    } else {
+        EXPECT_THROW(reader.columnView(RacelineTable::VX), std::runtime_error);
+    }
+    EXPECT_THROW(reader.info(3), std::runtime_error);
+}
+
+TEST_P(ResultArchiveTest, TruncatedOrForeignFilesThrow) {
+    std::string content = writeArchive();
+    
+    writeFile(path_, content.substr(0, content.size() - 8));
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    writeFile(path_, content.substr(0, 20));
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    
+    std::string bad_magic = content;
+    bad_magic[1] = 'X';
+    writeFile(path_, bad_magic);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+}
+
+TEST_P(ResultArchiveTest, ChunkOutsideTheDataThrows) {
+    std::string content = writeArchive();
+    
+    // Chunk start past the directory
+    std::string bad = content;
+    putWord(bad, directoryWord(bad, 4, 0), getWord(bad, DIRECTORY_OFFSET_OFFSET) + 8);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    
+    // Chunk start inside the result records
+    bad = content;
+    putWord(bad, directoryWord(bad, 0, 0), RECORDS_OFFSET);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    
+    // Chunk size reaching into the directory
+    bad = content;
+    putWord(bad, directoryWord(bad, 6, 1), getWord(bad, directoryWord(bad, 6, 1)) + 16);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+}
+
+TEST_P(ResultArchiveTest, NonMonotonicResultOffsetsThrow) {
+    std::string content = writeArchive();
+    
+    // Result 2 starting before result 1 (which is empty and starts where result 0 ends)
+    std::string bad = content;
+    putWord(bad, directoryWord(bad, 2, 4), getWord(bad, directoryWord(bad, 2, 3)) - 8);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    
+    // Huge offset wrapping around the chunk start
+    bad = content;
+    putWord(bad, directoryWord(bad, 1, 3), ~uint64_t(0) - 100);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+}
+
+TEST_P(ResultArchiveTest, PointCountMismatchThrows) {
+    std::string content = writeArchive();
+    
+    // Total larger than the records add up to (raw column views would read past the chunk)
+    std::string bad = content;
+    putWord(bad, N_POINTS_TOTAL_OFFSET, getWord(bad, N_POINTS_TOTAL_OFFSET) + 1000);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+    
+    // Record point count larger than its chunk range, total adjusted to match
+    bad = content;
+    size_t n_points_offset = RECORDS_OFFSET + 2 * 8 * 6;  // record 2, records are 6 words with two parameters
+    putWord(bad, n_points_offset, 100000);
+    putWord(bad, N_POINTS_TOTAL_OFFSET, 100120);
+    writeFile(path_, bad);
+    EXPECT_THROW(ResultArchiveReader reader(path_), std::runtime_error);
+}
+
+INSTANTIATE_TEST_SUITE_P(Encodings, ResultArchiveTest, testing::Bool(),
+                         [](const testing::TestParamInfo<bool>& info) { return info.param ? "Delta" : "Raw"; });
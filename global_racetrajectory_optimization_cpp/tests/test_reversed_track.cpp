@@ -0,0 +1,99 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+
+TrackData preparedTrack() {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    EXPECT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    EXPECT_TRUE(optimizer.prepareTrack());
+    optimizer.setStartPoint(optimizer.getTrackData().reftrack().row(100).head<2>().transpose());
+    return optimizer.getTrackData();
+}
+
+} // namespace
+
+TEST(ReversedTrack, InPlaceReversalMatchesView) {
+    TrackData track = preparedTrack();
+    TrackData from_view = ReversedTrackView(track).toTrackData();
+    TrackData in_place = track;
+    utils::reverseTrackData(in_place);
+    
+    EXPECT_EQ(in_place.reftrack(), from_view.reftrack());
+    EXPECT_EQ(in_place.normvectors, from_view.normvectors);
+    EXPECT_EQ(in_place.el_lengths, from_view.el_lengths);
+    EXPECT_TRUE(in_place.coeffs_x.isApprox(from_view.coeffs_x, 1e-14));
+    EXPECT_TRUE(in_place.coeffs_y.isApprox(from_view.coeffs_y, 1e-14));
+    EXPECT_TRUE(in_place.a_interp.isApprox(from_view.a_interp));
+    EXPECT_NEAR(in_place.segment_index->length(), track.segment_index->length(), 1e-6);
+}
+
+TEST(ReversedTrack, KeepsSourceHashAndStartIndex) {
+    TrackData track = preparedTrack();
+    ASSERT_NE(track.source_hash, 0u);
+    ASSERT_EQ(track.start_index, 100);
+    
+    TrackData from_view = ReversedTrackView(track).toTrackData();
+    EXPECT_EQ(from_view.source_hash, track.source_hash);
+    EXPECT_EQ(from_view.start_index, track.start_index);
+    
+    TrackData in_place = track;
+    utils::reverseTrackData(in_place);
+    EXPECT_EQ(in_place.source_hash, track.source_hash);
+    EXPECT_EQ(in_place.start_index, track.start_index);
+}
+
+TEST(ReversedTrack, ReversingTwiceRestoresTheTrack) {
+    TrackData track = preparedTrack();
+    TrackData twice = track;
+    utils::reverseTrackData(twice);
+    utils::reverseTrackData(twice);
+    
+    EXPECT_EQ(twice.reftrack(), track.reftrack());
+    EXPECT_EQ(twice.normvectors, track.normvectors);
+    EXPECT_TRUE(twice.coeffs_x.isApprox(track.coeffs_x, 1e-12));
+    EXPECT_TRUE(twice.coeffs_y.isApprox(track.coeffs_y, 1e-12));
+}
+
+TEST(ReversedTrack, ReversedSplineSystemHoldsForReversedCoefficients) {
+    TrackData track = preparedTrack();
+    TrackData reversed = track;
+    utils::reverseTrackData(reversed);
+    int n = track.reftrack().rows();
+    ASSERT_EQ(reversed.a_interp.rows(), 4 * n);
+    
+    // Coefficients of all splines stacked [a_0, b_0, c_0, d_0, a_1, ...]
+    auto stacked = [](const MatrixXd& coeffs) {
+        VectorXd c(4 * coeffs.rows());
+        for (int i = 0; i < coeffs.rows(); ++i) {
+            c.segment<4>(4 * i) = coeffs.row(i).head<4>().transpose();
+        }
+        return c;
+    };
+    
+    // The equations of spline i become the equations of reversed spline n - 1 - i, with the same right hand side
+    for (const MatrixXd TrackData::*coeffs : {&TrackData::coeffs_x, &TrackData::coeffs_y}) {
+        VectorXd b = track.a_interp * stacked(track.*coeffs);
+        VectorXd b_reversed = reversed.a_interp * stacked(reversed.*coeffs);
+        for (int i = 0; i < n; ++i) {
+            EXPECT_LT((b_reversed.segment<4>(4 * (n - 1 - i)) - b.segment<4>(4 * i)).cwiseAbs().maxCoeff(), 1e-9);
+        }
+        
+        // Start and end point rows hold the track points, the continuity rows are zero
+        EXPECT_NEAR(b(0), (track.*coeffs)(0, 0), 1e-12);
+        EXPECT_LT(b.segment<2>(4 * 7 + 2).cwiseAbs().maxCoeff(), 1e-9);
+    }
+}
+
+TEST(ReversedTrack, FlippedImportMatchesReversedView) {
+    MatrixXd track = utils::importTrack(TRACK_FILE);
+    MatrixXd flipped = utils::importTrack(TRACK_FILE, true);
+    ASSERT_GT(track.rows(), 0);
+    
+    EXPECT_EQ(flipped, TrackView(track, static_cast<int>(track.rows()) - 1, true).toMatrix());
+}
@@ -0,0 +1,195 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+const std::string GGV_FILE = std::string(TEST_INPUTS_DIR) + "/veh_dyn_info/ggv.csv";
+const std::string AX_MAX_FILE = std::string(TEST_INPUTS_DIR) + "/veh_dyn_info/ax_max_machines.csv";
+
+MatrixXd testTable(int rows, int cols) {
+    MatrixXd table(rows, cols);
+    for (int j = 0; j < cols; ++j) {
+        for (int i = 0; i < rows; ++i) {
+            table(i, j) = 0.5 * i - 3.0 * j;
+        }
+    }
+    return table;
+}
+
+// Fresh cache directory per test
+class SharedTrackTest : public testing::Test {
+protected:
+    std::string cache_dir_ = testing::TempDir() + "shared_track_cache_" + std::to_string(::getpid());
+    
+    void SetUp() override {
+        std::filesystem::remove_all(cache_dir_);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(cache_dir_);
+    }
+};
+
+} // namespace
+
+TEST(SharedTables, FileRoundTrip) {
+    std::string path = testing::TempDir() + "shared_tables_test.bin";
+    MatrixXd a = testTable(17, 3);
+    MatrixXd b = testTable(1, 5);
+    SharedTables created = SharedTables::create({{"a", a}, {"b", b}}, 42, path);
+    
+    SharedTables mapped(path);
+    EXPECT_EQ(mapped.key(), 42u);
+    EXPECT_EQ(mapped.fd(), -1);
+    EXPECT_TRUE(mapped.contains("b"));
+    EXPECT_FALSE(mapped.contains("c"));
+    EXPECT_EQ(MatrixXd(mapped.table("a")), a);
+    EXPECT_EQ(MatrixXd(mapped.table("b")), b);
+    EXPECT_THROW(mapped.table("c"), std::runtime_error);
+    
+    // Truncated files are rejected
+    std::string content;
+    {
+        std::ifstream file(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content.substr(0, content.size() - 8);
+    EXPECT_THROW(SharedTables truncated(path), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST(SharedTables, TrackDataCopiesShareTheReftrack) {
+    MatrixXd table = testTable(40, 4);
+    TrackData track;
+    track.setReftrack(table);
+    
+    ASSERT_TRUE(track.reftrackTables());
+    EXPECT_GE(track.reftrackTables()->fd(), 0);
+    EXPECT_EQ(MatrixXd(track.reftrack()), table);
+    
+    // Copies reference the same pages, the mapping lives as long as any copy
+    TrackData copy = track;
+    EXPECT_EQ(copy.reftrack().data(), track.reftrack().data());
+    track = TrackData();
+    EXPECT_EQ(track.reftrack().size(), 0);
+    EXPECT_EQ(MatrixXd(copy.reftrack()), table);
+}
+
+TEST(SharedTables, SetReftrackRequiresTheTable) {
+    TrackData track;
+    EXPECT_THROW(track.setReftrack(std::shared_ptr<const SharedTables>()), std::runtime_error);
+    auto other = std::make_shared<const SharedTables>(SharedTables::create({{"ggv", testTable(3, 3)}}, 0));
+    EXPECT_THROW(track.setReftrack(other), std::runtime_error);
+}
+
+TEST_F(SharedTrackTest, OptimizersShareThePreparedReftrackFile) {
+    GlobalRaceTrajectoryOptimizer first;
+    first.setArtifactCache(cache_dir_);
+    ASSERT_TRUE(first.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(first.prepareTrack(false));
+    
+    const TrackData& prepared = first.getTrackData();
+    ASSERT_TRUE(prepared.reftrackTables());
+    EXPECT_EQ(prepared.reftrackTables()->fd(), -1);
+    EXPECT_EQ(prepared.reftrackTables()->path().rfind(cache_dir_ + "/reftrack_", 0), 0u);
+    
+    // A second optimizer (e.g. another worker process) takes the snapshot from the cache and maps the same file
+    GlobalRaceTrajectoryOptimizer second;
+    second.setArtifactCache(cache_dir_);
+    ASSERT_TRUE(second.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(second.prepareTrack(false));
+    
+    const TrackData& loaded = second.getTrackData();
+    ASSERT_TRUE(loaded.reftrackTables());
+    EXPECT_EQ(loaded.reftrackTables()->path(), prepared.reftrackTables()->path());
+    EXPECT_EQ(loaded.reftrack(), prepared.reftrack());
+    EXPECT_EQ(loaded.normvectors, prepared.normvectors);
+    
+    // A moved start line is published under its own key
+    Vector2d start = prepared.reftrack().row(prepared.reftrack().rows() / 3).head<2>().transpose();
+    first.setStartPoint(start);
+    EXPECT_NE(first.getTrackData().reftrackTables()->path(), second.getTrackData().reftrackTables()->path());
+    EXPECT_EQ(first.getTrackData().reftrack().row(0).head<2>().transpose(), start);
+}
+
+TEST_F(SharedTrackTest, SnapshotUsesMatchingReftrackTables) {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    const TrackData& track = optimizer.getTrackData();
+    
+    std::filesystem::create_directories(cache_dir_);
+    std::string snapshot = cache_dir_ + "/snapshot.bin";
+    ASSERT_TRUE(utils::saveTrackSnapshot(track, 7, snapshot));
+    
+    TrackData shared;
+    ASSERT_TRUE(utils::loadTrackSnapshot(snapshot, track.source_hash, 7, shared, track.reftrackTables()));
+    EXPECT_EQ(shared.reftrack().data(), track.reftrack().data());
+    
+    // Tables holding another reference track are not used
+    auto other = std::make_shared<const SharedTables>(
+        SharedTables::create({{"reftrack", testTable(track.reftrack().rows(), 4)}}, 0));
+    TrackData copied;
+    ASSERT_TRUE(utils::loadTrackSnapshot(snapshot, track.source_hash, 7, copied, other));
+    EXPECT_NE(copied.reftrackTables(), other);
+    EXPECT_EQ(copied.reftrack(), track.reftrack());
+}
+
+TEST_F(SharedTrackTest, ChangedGgvRecomputesOnlyTheVelocity) {
+    // GGV diagram with lower acceleration limits than the input file
+    std::filesystem::create_directories(cache_dir_);
+    std::string ggv_file = cache_dir_ + "/ggv_low.csv";
+    {
+        MatrixXd ggv = utils::readCSV(GGV_FILE);
+        ASSERT_GT(ggv.rows(), 0);
+        std::ofstream file(ggv_file);
+        file << "# v_mps,ax_max_mps2,ay_max_mps2\n";
+        for (int i = 0; i < ggv.rows(); ++i) {
+            file << ggv(i, 0) << "," << 0.5 * ggv(i, 1) << "," << 0.5 * ggv(i, 2) << "\n";
+        }
+    }
+    
+    // Runs the minimum curvature optimization on a new optimizer, returns its standard output
+    auto run = [&](const std::string& ggv, OptimizationResult& result) {
+        GlobalRaceTrajectoryOptimizer optimizer;
+        optimizer.setArtifactCache(cache_dir_);
+        EXPECT_TRUE(optimizer.loadTrack(TRACK_FILE));
+        EXPECT_TRUE(optimizer.loadVehicleDynamics(ggv, AX_MAX_FILE));
+        EXPECT_TRUE(optimizer.prepareTrack(false));
+        testing::internal::CaptureStdout();
+        result = optimizer.optimizeMinCurvature(false);
+        return testing::internal::GetCapturedStdout();
+    };
+    
+    OptimizationResult first, second;
+    std::string output = run(GGV_FILE, first);
+    ASSERT_TRUE(first.success) << first.message;
+    EXPECT_EQ(output.find("loaded from cache"), std::string::npos);
+    
+    output = run(ggv_file, second);
+    ASSERT_TRUE(second.success) << second.message;
+    EXPECT_NE(output.find("Optimized path loaded from cache"), std::string::npos);
+    EXPECT_EQ(output.find("Velocity profile loaded from cache"), std::string::npos);
+    EXPECT_EQ(second.alpha_opt, first.alpha_opt);
+    EXPECT_EQ(second.raceline, first.raceline);
+    EXPECT_NE(second.content_key, first.content_key);
+    
+    // Both velocity profiles are cached, the path once
+    int n_path = 0, n_velocity = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir_)) {
+        std::string name = entry.path().filename().string();
+        n_path += name.rfind("path_", 0) == 0;
+        n_velocity += name.rfind("velocity_", 0) == 0;
+    }
+    EXPECT_EQ(n_path, 1);
+    EXPECT_EQ(n_velocity, 2);
+}
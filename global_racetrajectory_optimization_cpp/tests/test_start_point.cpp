@@ -0,0 +1,81 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+
+} // namespace
+
+TEST(StartPoint, RotatesAllPreparedArrays) {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack());
+    TrackData before = optimizer.getTrackData();
+    int n_points = before.reftrack().rows();
+    int k = n_points / 3;
+    
+    TrackView view = optimizer.setStartPoint(before.reftrack().row(k).head<2>().transpose());
+    const TrackData& after = optimizer.getTrackData();
+    
+    EXPECT_EQ(after.start_index, k);
+    EXPECT_EQ(view.offset(), 0);
+    EXPECT_EQ(after.source_hash, before.source_hash);
+    for (int i : {0, 1, n_points - k - 1, n_points - k, n_points - 1}) {
+        int j = (i + k) % n_points;
+        EXPECT_EQ(after.reftrack().row(i), before.reftrack().row(j));
+        EXPECT_EQ(after.coeffs_x.row(i), before.coeffs_x.row(j));
+        EXPECT_EQ(after.coeffs_y.row(i), before.coeffs_y.row(j));
+        EXPECT_EQ(after.normvectors.row(i), before.normvectors.row(j));
+        EXPECT_EQ(after.el_lengths(i), before.el_lengths(j));
+    }
+    
+    // Spline system permuted along with the splines: four equations and unknowns per spline, the continuity rows
+    // couple spline i to spline i + 1 (the last one to spline 0)
+    ASSERT_EQ(after.a_interp.rows(), 4 * n_points);
+    EXPECT_EQ(after.a_interp.nonZeros(), before.a_interp.nonZeros());
+    for (int i : {0, 5, n_points - k - 1, n_points - 1}) {
+        int j = (i + k) % n_points;
+        int i_next = (i + 1) % n_points;
+        int j_next = (j + 1) % n_points;
+        for (int r = 0; r < 4; ++r) {
+            for (int c = 0; c < 4; ++c) {
+                EXPECT_EQ(after.a_interp.coeff(4 * i + r, 4 * i + c), before.a_interp.coeff(4 * j + r, 4 * j + c));
+                EXPECT_EQ(after.a_interp.coeff(4 * i + r, 4 * i_next + c),
+                          before.a_interp.coeff(4 * j + r, 4 * j_next + c));
+            }
+        }
+        EXPECT_NE(after.a_interp.coeff(4 * i + 2, 4 * i_next + 1), 0.0);
+    }
+    
+    // The segment index starts at the new start line
+    ASSERT_TRUE(after.segment_index);
+    EXPECT_NEAR(after.segment_index->match(after.reftrack().row(0).head<2>().transpose()).s, 0.0, 1e-9);
+    EXPECT_NEAR(after.segment_index->length(), before.segment_index->length(), 1e-6);
+}
+
+TEST(StartPoint, ResultsStartAtTheNewStartLine) {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack());
+    OptimizationResult original = optimizer.optimizeShortestPath();
+    ASSERT_TRUE(original.success);
+    
+    int k = optimizer.getTrackData().reftrack().rows() / 2;
+    Vector2d start = optimizer.getTrackData().reftrack().row(k).head<2>().transpose();
+    optimizer.setStartPoint(start);
+    OptimizationResult moved = optimizer.optimizeShortestPath();
+    ASSERT_TRUE(moved.success);
+    
+    EXPECT_EQ(moved.raceline.row(0).transpose(), start);
+    EXPECT_NEAR(moved.s_opt(0), 0.0, 1e-12);
+    EXPECT_NE(moved.content_key, original.content_key);
+    EXPECT_NEAR(moved.kappa_opt(0), original.kappa_opt(k), 1e-9);
+    
+    // Reversing afterwards keeps the start line
+    ASSERT_TRUE(optimizer.reverseDirection());
+    EXPECT_EQ(optimizer.getTrackData().reftrack().row(0).head<2>().transpose(), start);
+}
@@ -0,0 +1,170 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+constexpr double SPEED = 40.0;
+
+class TelemetryTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        optimizer_ = new GlobalRaceTrajectoryOptimizer();
+        ASSERT_TRUE(optimizer_->loadTrack(TRACK_FILE));
+        ASSERT_TRUE(optimizer_->prepareTrack(false));
+    }
+    
+    static void TearDownTestSuite() {
+        delete optimizer_;
+        optimizer_ = nullptr;
+    }
+    
+    static GlobalRaceTrajectoryOptimizer* optimizer_;
+    std::string path_ = testing::TempDir() + "telemetry_test.csv";
+    
+    // Log driving along the reference line at constant speed, one sample per point from row first_row on, n_samples
+    // points in total (full precision, so samples match the points exactly). offset(i) shifts sample i sideways,
+    // extra_rows(i) is written before it
+    template <typename Offset, typename Extra>
+    std::string writeLog(int first_row, int n_samples, Offset offset, Extra extra_rows) {
+        const TrackData& track = optimizer_->getTrackData();
+        ConstMatrixMap reftrack = track.reftrack();
+        int n = reftrack.rows();
+        
+        std::ofstream file(path_, std::ios::trunc);
+        file.precision(17);
+        file << "t,x,y\n";
+        double t = 0.0;
+        for (int i = 0; i < n_samples; ++i) {
+            int row = (first_row + i) % n;
+            Vector2d p = reftrack.row(row).head<2>().transpose() + offset(i) * track.normvectors.row(row).transpose();
+            file << extra_rows(i) << t << "," << p.x() << "," << p.y() << "\n";
+            t += track.el_lengths(row) / SPEED;
+        }
+        return path_;
+    }
+    
+    std::string writeLog(int first_row, int n_samples) {
+        return writeLog(first_row, n_samples, [](int) { return 0.0; }, [](int) { return ""; });
+    }
+    
+    double trackLength() const {
+        return optimizer_->getTrackData().el_lengths.sum();
+    }
+    
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+};
+
+GlobalRaceTrajectoryOptimizer* TelemetryTest::optimizer_ = nullptr;
+
+} // namespace
+
+TEST_F(TelemetryTest, SplitsLapsAtTheStartLine) {
+    int n = optimizer_->getTrackData().reftrack().rows();
+    TelemetryLog log = utils::ingestTelemetry(writeLog(n / 2, 5 * n / 2 + 100), optimizer_->getTrackData());
+    
+    ASSERT_TRUE(log.success) << log.message;
+    EXPECT_EQ(log.n_samples, 5 * n / 2 + 100);
+    EXPECT_EQ(log.n_invalid, 0);
+    EXPECT_EQ(log.n_rejected, 0);
+    ASSERT_EQ(log.laps.size(), 2u);
+    
+    for (int k = 0; k < 2; ++k) {
+        const TelemetryLap& lap = log.laps[k];
+        EXPECT_EQ(lap.lap, k + 1);
+        EXPECT_TRUE(lap.complete);
+        EXPECT_DOUBLE_EQ(lap.s(0), 0.0);
+        EXPECT_NEAR(lap.s(lap.s.size() - 1), trackLength(), 1e-6);
+        EXPECT_NEAR(lap.lap_time, trackLength() / SPEED, 1e-6);
+        EXPECT_NEAR(lap.v.mean(), SPEED, 0.5);
+        EXPECT_LT(lap.d.cwiseAbs().maxCoeff(), 1e-6);
+        EXPECT_TRUE(((lap.s.tail(lap.s.size() - 1) - lap.s.head(lap.s.size() - 1)).array() > 0.0).all());
+    }
+    EXPECT_NEAR(log.laps[1].t_start - log.laps[0].t_start, trackLength() / SPEED, 1e-6);
+    
+    // The partial laps before the first and after the last crossing
+    TelemetryOptions opts;
+    opts.keep_partial = true;
+    log = utils::ingestTelemetry(path_, optimizer_->getTrackData(), opts);
+    ASSERT_EQ(log.laps.size(), 4u);
+    EXPECT_FALSE(log.laps.front().complete);
+    EXPECT_FALSE(log.laps.back().complete);
+    
+    // Resampled onto a uniform grid
+    opts.keep_partial = false;
+    opts.ds_resample = 2.0;
+    log = utils::ingestTelemetry(path_, optimizer_->getTrackData(), opts);
+    ASSERT_EQ(log.laps.size(), 2u);
+    EXPECT_NEAR(log.laps[0].s(1) - log.laps[0].s(0), 2.0, 1e-9);
+    EXPECT_NEAR(log.laps[0].lap_time, trackLength() / SPEED, 1e-6);
+}
+
+TEST_F(TelemetryTest, NonFiniteRowsAreSkipped) {
+    int n = optimizer_->getTrackData().reftrack().rows();
+    auto glitches = [&](int i) -> std::string {
+        if (i == n) {
+            return "1.0,nan,2.0\n";
+        }
+        if (i == n + 10) {
+            return "nan,0.0,0.0\n1.0,2.0,inf\n";
+        }
+        return "";
+    };
+    TelemetryLog log = utils::ingestTelemetry(writeLog(n / 2, 5 * n / 2 + 100, [](int) { return 0.0; }, glitches),
+                                              optimizer_->getTrackData());
+    
+    ASSERT_TRUE(log.success) << log.message;
+    EXPECT_EQ(log.n_invalid, 3);
+    EXPECT_EQ(log.n_samples, 5 * n / 2 + 100);
+    EXPECT_EQ(log.laps.size(), 2u);
+}
+
+TEST_F(TelemetryTest, LapsLeavingTheTrackAreRejected) {
+    int n = optimizer_->getTrackData().reftrack().rows();
+    
+    // Pit lane 20 m beside the reference line during the second complete lap
+    auto pit_lane = [&](int i) { return (i > 3 * n / 2 + 100 && i < 3 * n / 2 + 200) ? 20.0 : 0.0; };
+    TelemetryLog log = utils::ingestTelemetry(writeLog(n / 2, 5 * n / 2 + 100, pit_lane, [](int) { return ""; }),
+                                              optimizer_->getTrackData());
+    
+    ASSERT_TRUE(log.success) << log.message;
+    EXPECT_EQ(log.n_rejected, 1);
+    ASSERT_EQ(log.laps.size(), 1u);
+    EXPECT_EQ(log.laps[0].lap, 1);
+}
+
+TEST_F(TelemetryTest, MovedStartLineSplitsThere) {
+    GlobalRaceTrajectoryOptimizer optimizer;
+    ASSERT_TRUE(optimizer.loadTrack(TRACK_FILE));
+    ASSERT_TRUE(optimizer.prepareTrack(false));
+    int n = optimizer.getTrackData().reftrack().rows();
+    
+    std::string log_file = writeLog(n / 2, 5 * n / 2 + 100);
+    Vector2d start = optimizer.getTrackData().reftrack().row(n / 4).head<2>().transpose();
+    
+    // Crossing the original start line (row 0) after n / 2 samples, the moved one (row n / 4) after 3n / 4
+    const TrackData& track = optimizer_->getTrackData();
+    double t_line = 0.0;
+    for (int i = 0; i < 3 * n / 4; ++i) {
+        t_line += track.el_lengths((n / 2 + i) % n) / SPEED;
+    }
+    
+    optimizer.setStartPoint(start);
+    ASSERT_EQ(optimizer.getTrackData().start_index, n / 4);
+    TelemetryLog log = utils::ingestTelemetry(log_file, optimizer.getTrackData());
+    
+    ASSERT_TRUE(log.success) << log.message;
+    ASSERT_EQ(log.laps.size(), 1u);
+    EXPECT_EQ(log.laps[0].lap, 1);
+    EXPECT_NEAR(log.laps[0].t_start, t_line, 1e-6);
+    EXPECT_NEAR(log.laps[0].lap_time, trackLength() / SPEED, 1e-6);
+    EXPECT_LT((log.laps[0].xy.row(0) - start.transpose()).norm(), 1e-6);
+}
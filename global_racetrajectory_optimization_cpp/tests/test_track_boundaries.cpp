@@ -0,0 +1,128 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+constexpr int N_POINTS = 600;
+constexpr double RADIUS = 60.0;
+constexpr double W_RIGHT = 3.0;  // outwards
+constexpr double W_LEFT = 5.0;   // towards the centre
+
+// Counter-clockwise circle, normals pointing left (to the centre): left boundary at radius 55, right one at 63
+TrackData circleTrack() {
+    TrackData track;
+    MatrixXd reftrack(N_POINTS, 4);
+    track.normvectors.resize(N_POINTS, 2);
+    for (int i = 0; i < N_POINTS; ++i) {
+        double a = 2.0 * M_PI * i / N_POINTS;
+        reftrack.row(i) << RADIUS * std::cos(a), RADIUS * std::sin(a), W_RIGHT, W_LEFT;
+        track.normvectors.row(i) << -std::cos(a), -std::sin(a);
+    }
+    track.setReftrack(reftrack);
+    return track;
+}
+
+// Point at radius r in the direction of track point i (the boundary points lie exactly on these rays)
+Vector2d atRadius(int i, double r) {
+    double a = 2.0 * M_PI * i / N_POINTS;
+    return r * Vector2d(std::cos(a), std::sin(a));
+}
+
+} // namespace
+
+TEST(TrackBoundaries, DistancesArePositiveInside) {
+    TrackBoundaries boundaries(circleTrack());
+    double tilt = std::cos(M_PI / N_POINTS);  // the outer boundary segments are tilted against the tangent at a point
+    
+    for (int i : {0, 77, 300, 599}) {
+        TrackBoundaries::Query q = boundaries.query(atRadius(i, RADIUS));
+        EXPECT_TRUE(q.inside);
+        EXPECT_NEAR(q.d_left, W_LEFT, 1e-9);
+        EXPECT_NEAR(q.d_right, W_RIGHT * tilt, 1e-9);
+        EXPECT_NEAR(q.signed_distance, W_RIGHT * tilt, 1e-9);
+        
+        // Closer to the left boundary
+        q = boundaries.query(atRadius(i, 56.0));
+        EXPECT_TRUE(q.inside);
+        EXPECT_NEAR(q.d_left, 1.0, 1e-9);
+        EXPECT_NEAR(q.d_right, 7.0 * tilt, 1e-9);
+        EXPECT_NEAR(q.signed_distance, 1.0, 1e-9);
+    }
+    
+    EXPECT_EQ(boundaries.leftBound().rows(), N_POINTS);
+    EXPECT_NEAR(boundaries.leftBound().row(0).norm(), RADIUS - W_LEFT, 1e-9);
+    EXPECT_NEAR(boundaries.rightBound().row(0).norm(), RADIUS + W_RIGHT, 1e-9);
+}
+
+TEST(TrackBoundaries, PointsJustOutsideEachBoundary) {
+    TrackBoundaries boundaries(circleTrack());
+    
+    for (int i : {0, 150, 451}) {
+        // Beyond the left boundary (infield)
+        TrackBoundaries::Query q = boundaries.query(atRadius(i, RADIUS - W_LEFT - 0.01));
+        EXPECT_FALSE(q.inside);
+        EXPECT_NEAR(q.d_left, -0.01, 1e-6);
+        EXPECT_GT(q.d_right, 0.0);
+        EXPECT_NEAR(q.signed_distance, -0.01, 1e-6);
+        EXPECT_TRUE(boundaries.query(atRadius(i, RADIUS - W_LEFT + 0.01)).inside);
+        
+        // Beyond the right boundary (outside)
+        q = boundaries.query(atRadius(i, RADIUS + W_RIGHT + 0.01));
+        EXPECT_FALSE(q.inside);
+        EXPECT_NEAR(q.d_right, -0.01, 1e-6);
+        EXPECT_GT(q.d_left, 0.0);
+        EXPECT_TRUE(boundaries.query(atRadius(i, RADIUS + W_RIGHT - 0.01)).inside);
+    }
+    
+    // Far away on both sides
+    EXPECT_FALSE(boundaries.query(Vector2d(0.0, 0.0)).inside);
+    EXPECT_FALSE(boundaries.query(Vector2d(500.0, -20.0)).inside);
+}
+
+TEST(TrackBoundaries, BatchMatchesScalar) {
+    TrackBoundaries boundaries(circleTrack());
+    
+    MatrixXd points(1000, 2);
+    for (int k = 0; k < points.rows(); ++k) {
+        points.row(k) = atRadius(k * 7 % N_POINTS, 50.0 + 18.0 * std::abs(std::sin(0.37 * k))).transpose();
+    }
+    
+    Eigen::Array<bool, Eigen::Dynamic, 1> inside = boundaries.inside(points, 4);
+    VectorXd signed_distance = boundaries.signedDistance(points, 4);
+    MatrixXd distances = boundaries.boundaryDistances(points, 4);
+    ASSERT_EQ(inside.size(), points.rows());
+    ASSERT_EQ(distances.rows(), points.rows());
+    
+    int n_inside = 0;
+    for (int k = 0; k < points.rows(); ++k) {
+        TrackBoundaries::Query q = boundaries.query(points.row(k).transpose());
+        EXPECT_EQ(inside(k), q.inside);
+        EXPECT_EQ(signed_distance(k), q.signed_distance);
+        EXPECT_EQ(distances(k, 0), q.d_left);
+        EXPECT_EQ(distances(k, 1), q.d_right);
+        n_inside += q.inside;
+    }
+    
+    // Both cases are covered
+    EXPECT_GT(n_inside, 100);
+    EXPECT_LT(n_inside, 900);
+}
+
+TEST(TrackBoundaries, RequiresWidthsAndNormals) {
+    TrackData track = circleTrack();
+    MatrixXd reftrack = track.reftrack();
+    
+    TrackData no_widths = track;
+    no_widths.setReftrack(MatrixXd(reftrack.leftCols(3)));
+    EXPECT_THROW(TrackBoundaries boundaries(no_widths), std::runtime_error);
+    
+    TrackData no_normals = track;
+    no_normals.normvectors.conservativeResize(N_POINTS - 1, 2);
+    EXPECT_THROW(TrackBoundaries boundaries(no_normals), std::runtime_error);
+    
+    EXPECT_THROW(TrackBoundaries().query(Vector2d(0.0, 0.0)), std::runtime_error);
+}
@@ -0,0 +1,89 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+MatrixXd toTrack(const std::vector<Vector2d>& points, double w_right, double w_left) {
+    MatrixXd track(points.size(), 4);
+    for (size_t i = 0; i < points.size(); ++i) {
+        track.row(i) << points[i](0), points[i](1), w_right, w_left;
+    }
+    return track;
+}
+
+std::vector<Vector2d> circle(int n, double radius) {
+    std::vector<Vector2d> points;
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        points.emplace_back(radius * std::cos(a), radius * std::sin(a));
+    }
+    return points;
+}
+
+// Counter-clockwise rectangle with rounded corners of radius r, points about 1 m apart
+std::vector<Vector2d> roundedRectangle(double length, double height, double r) {
+    std::vector<Vector2d> points;
+    const Vector2d corners[4] = {{length - r, r}, {length - r, height - r}, {r, height - r}, {r, r}};
+    const Vector2d dirs[4] = {{0.0, 1.0}, {-1.0, 0.0}, {0.0, -1.0}, {1.0, 0.0}};
+    const double sides[4] = {height - 2.0 * r, length - 2.0 * r, height - 2.0 * r, length - 2.0 * r};
+    
+    for (int c = 0; c < 4; ++c) {
+        // Corner arc from the previous side to side c, then the straight of side c
+        double a0 = (c - 1) * M_PI / 2.0;
+        for (int k = 0; k < 4; ++k) {
+            double a = a0 + k * M_PI / 8.0;
+            points.push_back(corners[c] + r * Vector2d(std::cos(a), std::sin(a)));
+        }
+        Vector2d start = corners[c] + r * Vector2d(std::cos(a0 + M_PI / 2.0), std::sin(a0 + M_PI / 2.0));
+        int n_side = static_cast<int>(sides[c]);
+        for (int k = 0; k < n_side; ++k) {
+            points.push_back(start + dirs[c] * sides[c] * k / n_side);
+        }
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(TrackIntersections, AcceptsCircle) {
+    EXPECT_TRUE(utils::checkTrackIntersections(toTrack(circle(200, 50.0), 3.0, 3.0)));
+}
+
+TEST(TrackIntersections, AcceptsDuplicatedPoint) {
+    std::vector<Vector2d> points = circle(200, 50.0);
+    points.insert(points.begin() + 80, points[80]);
+    EXPECT_TRUE(utils::checkTrackIntersections(toTrack(points, 3.0, 3.0)));
+}
+
+TEST(TrackIntersections, RejectsFigureEight) {
+    std::vector<Vector2d> points;
+    for (int i = 0; i < 300; ++i) {
+        double a = 2.0 * M_PI * i / 300;
+        points.emplace_back(80.0 * std::sin(a), 40.0 * std::sin(2.0 * a));
+    }
+    EXPECT_FALSE(utils::checkTrackIntersections(toTrack(points, 2.0, 2.0)));
+}
+
+TEST(TrackIntersections, ToleratesLocalFoldsInTightCorners) {
+    // Inner width above the corner radius: the left boundary crosses itself at every corner
+    EXPECT_TRUE(utils::checkTrackIntersections(toTrack(roundedRectangle(60.0, 40.0, 2.0), 3.0, 4.0)));
+}
+
+TEST(TrackIntersections, RejectsCrossingsBeyondFolds) {
+    // Same kind of corners, but the inner boundary of each long straight reaches across the opposite one
+    EXPECT_FALSE(utils::checkTrackIntersections(toTrack(roundedRectangle(60.0, 7.0, 2.0), 3.0, 8.0)));
+}
+
+TEST(TrackIntersections, RejectsSelfCrossingOpenLine) {
+    // First and last segment of an open line are no neighbours
+    std::vector<Vector2d> points;
+    for (int k = 0; k <= 40; ++k) points.emplace_back(k, 0.0);
+    for (int k = 1; k <= 30; ++k) points.emplace_back(40.0, k);
+    for (int k = 1; k <= 20; ++k) points.emplace_back(40.0 - k, 30.0);
+    for (int k = 1; k <= 50; ++k) points.emplace_back(20.0, 30.0 - k);
+    EXPECT_FALSE(utils::checkTrackIntersections(toTrack(points, 0.5, 0.5)));
+}
@@ -0,0 +1,134 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+constexpr uint64_t SOURCE_HASH = 0x1234;
+constexpr uint64_t OPTIONS_HASH = 0x5678;
+
+// Prepared-looking track: ellipse with extra channel, cubic coefficients and a banded 4n x 4n spline matrix
+TrackData testTrack(int n) {
+    TrackData track;
+    MatrixXd reftrack(n, 5);
+    track.normvectors.resize(n, 2);
+    track.coeffs_x.resize(n, 4);
+    track.coeffs_y.resize(n, 4);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        reftrack.row(i) << 70.0 * std::cos(a), 45.0 * std::sin(a), 3.0 + 0.01 * i, 4.0 - 0.01 * i, 0.5 * i;
+        track.normvectors.row(i) << -std::cos(a), -std::sin(a);
+        track.coeffs_x.row(i) << i, 0.1 * i, -0.2 * i, 0.3;
+        track.coeffs_y.row(i) << -i, 0.4 * i, 0.5, -0.6 * i;
+    }
+    track.setReftrack(reftrack);
+    track.el_lengths = VectorXd::LinSpaced(n, 1.0, 2.0);
+    
+    std::vector<Eigen::Triplet<double>> entries;
+    for (int i = 0; i < 4 * n; ++i) {
+        entries.emplace_back(i, i, 1.0 + i);
+        entries.emplace_back(i, (i + 3) % (4 * n), -0.25 * i);
+    }
+    track.a_interp.resize(4 * n, 4 * n);
+    track.a_interp.setFromTriplets(entries.begin(), entries.end());
+    
+    track.track_name = "ellipse";
+    track.source_hash = SOURCE_HASH;
+    return track;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& path, const std::string& content) {
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << content;
+}
+
+class TrackSnapshotTest : public testing::Test {
+protected:
+    std::string path_ = testing::TempDir() + "track_snapshot_test.bin";
+    
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+};
+
+} // namespace
+
+TEST_F(TrackSnapshotTest, RoundTrip) {
+    TrackData track = testTrack(150);
+    ASSERT_TRUE(utils::saveTrackSnapshot(track, OPTIONS_HASH, path_));
+    
+    TrackData loaded;
+    loaded.track_name = "ellipse";
+    ASSERT_TRUE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH, loaded));
+    
+    EXPECT_EQ(loaded.reftrack(), track.reftrack());
+    EXPECT_EQ(loaded.coeffs_x, track.coeffs_x);
+    EXPECT_EQ(loaded.coeffs_y, track.coeffs_y);
+    EXPECT_EQ(loaded.normvectors, track.normvectors);
+    EXPECT_EQ(loaded.el_lengths, track.el_lengths);
+    EXPECT_EQ(loaded.a_interp.nonZeros(), track.a_interp.nonZeros());
+    EXPECT_EQ(MatrixXd(loaded.a_interp), MatrixXd(track.a_interp));
+    EXPECT_EQ(loaded.track_name, "ellipse");
+    EXPECT_EQ(loaded.source_hash, SOURCE_HASH);
+    
+    // The spatial index is rebuilt from the loaded reference line
+    ASSERT_TRUE(loaded.segment_index);
+    Vector2d mid = 0.5 * (track.reftrack().block<1, 2>(37, 0) + track.reftrack().block<1, 2>(38, 0)).transpose();
+    EXPECT_EQ(loaded.segment_index->closestSegment(mid), 37);
+}
+
+TEST_F(TrackSnapshotTest, OtherHashesMiss) {
+    ASSERT_TRUE(utils::saveTrackSnapshot(testTrack(50), OPTIONS_HASH, path_));
+    
+    TrackData loaded;
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH + 1, OPTIONS_HASH, loaded));
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH + 1, loaded));
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_ + ".missing", SOURCE_HASH, OPTIONS_HASH, loaded));
+    EXPECT_EQ(loaded.reftrack().size(), 0);
+}
+
+TEST_F(TrackSnapshotTest, UnpreparedTrackIsNotWritten) {
+    TrackData track = testTrack(50);
+    track.el_lengths.resize(49);
+    EXPECT_FALSE(utils::saveTrackSnapshot(track, OPTIONS_HASH, path_));
+    EXPECT_FALSE(std::ifstream(path_).good());
+}
+
+TEST_F(TrackSnapshotTest, CorruptFilesAreRejected) {
+    ASSERT_TRUE(utils::saveTrackSnapshot(testTrack(50), OPTIONS_HASH, path_));
+    std::string content = readFile(path_);
+    TrackData loaded;
+    
+    // Truncated payload and truncated header
+    writeFile(path_, content.substr(0, content.size() - 8));
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH, loaded));
+    writeFile(path_, content.substr(0, 16));
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH, loaded));
+    
+    // Wrong magic
+    std::string bad_magic = content;
+    bad_magic[0] = 'X';
+    writeFile(path_, bad_magic);
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH, loaded));
+    
+    // Row index of the last stored sparse entry out of range (inner indices end the file)
+    std::string bad_index = content;
+    int32_t huge = 1 << 30;
+    std::memcpy(&bad_index[bad_index.size() - 4], &huge, sizeof(huge));
+    writeFile(path_, bad_index);
+    EXPECT_FALSE(utils::loadTrackSnapshot(path_, SOURCE_HASH, OPTIONS_HASH, loaded));
+    
+    EXPECT_EQ(loaded.reftrack().size(), 0);
+}
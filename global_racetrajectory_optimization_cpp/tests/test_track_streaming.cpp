@@ -0,0 +1,223 @@
+#include "global_racetrajectory_optimization/global_racetrajectory_optimization.hpp"
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace global_racetrajectory_optimization;
+
+namespace {
+
+const std::string TRACK_FILE = std::string(TEST_INPUTS_DIR) + "/tracks/berlin_2018.csv";
+constexpr int SEGMENT_POINTS = 50;
+constexpr int OVERLAP = 8;
+
+// Closed wavy loop [x, y, w_tr_right, w_tr_left] of about 1 km, raw points every 0.5 degrees
+MatrixXd wavyLoop() {
+    MatrixXd raw(720, 4);
+    for (int i = 0; i < raw.rows(); ++i) {
+        double a = 2.0 * M_PI * i / raw.rows();
+        double r = 150.0 + 20.0 * std::sin(3.0 * a);
+        raw.row(i) << r * std::cos(a), 0.8 * r * std::sin(a), 4.0, 5.0 + std::cos(a);
+    }
+    return raw;
+}
+
+StepsizeOptions stepsizeOptions() {
+    StepsizeOptions opts;
+    opts.stepsize_reg = 3.0;
+    return opts;
+}
+
+// Streams raw in chunks of chunk_rows rows, returns the segments in callback order
+std::vector<TrackSegment> stream(const MatrixXd& raw, int chunk_rows, bool closed, int* n_points = nullptr,
+                                 double* length = nullptr) {
+    std::vector<TrackSegment> segments;
+    TrackStreamPreparer preparer(stepsizeOptions(), [&](const TrackSegment& segment) { segments.push_back(segment); },
+                                 SEGMENT_POINTS, OVERLAP, closed);
+    for (int row = 0; row < raw.rows(); row += chunk_rows) {
+        preparer.add(raw.middleRows(row, std::min<int>(chunk_rows, raw.rows() - row)));
+    }
+    preparer.finish();
+    
+    EXPECT_EQ(preparer.numSegments(), static_cast<int>(segments.size()));
+    if (n_points) {
+        *n_points = preparer.numPoints();
+    }
+    if (length) {
+        *length = preparer.length();
+    }
+    return segments;
+}
+
+// Segments of a closed track put back together in track order
+struct Assembled {
+    MatrixXd points, coeffs_x, coeffs_y;
+    VectorXd el_lengths;
+};
+
+Assembled assemble(const std::vector<TrackSegment>& segments, int n_points) {
+    Assembled track;
+    track.points.setZero(n_points, 2);
+    track.coeffs_x.setZero(n_points, 4);
+    track.coeffs_y.setZero(n_points, 4);
+    track.el_lengths.setZero(n_points);
+    
+    for (const TrackSegment& segment : segments) {
+        for (int r = 0; r < segment.reftrack.rows(); ++r) {
+            int i = (segment.first_point + r) % n_points;
+            track.points.row(i) = segment.reftrack.row(r).head<2>();
+            track.coeffs_x.row(i) = segment.coeffs_x.row(r);
+            track.coeffs_y.row(i) = segment.coeffs_y.row(r);
+            track.el_lengths(i) = segment.el_lengths(r);
+        }
+    }
+    return track;
+}
+
+} // namespace
+
+TEST(TrackStreaming, ClosedSegmentsCoverTheTrackOnce) {
+    int n_points = 0;
+    double length = 0.0;
+    std::vector<TrackSegment> segments = stream(wavyLoop(), 100, true, &n_points, &length);
+    ASSERT_GT(n_points, 5 * SEGMENT_POINTS);
+    ASSERT_GE(segments.size(), 5u);
+    
+    // Contiguous from point OVERLAP on, the last segment wraps around to end with the first points
+    EXPECT_EQ(segments.front().first_point, OVERLAP);
+    int next_point = OVERLAP;
+    double next_s = segments.front().s_start;
+    for (size_t k = 0; k < segments.size(); ++k) {
+        const TrackSegment& segment = segments[k];
+        EXPECT_EQ(segment.index, static_cast<int>(k));
+        EXPECT_EQ(segment.first_point, next_point);
+        EXPECT_NEAR(segment.s_start, next_s, 1e-9);
+        EXPECT_EQ(segment.coeffs_x.rows(), segment.reftrack.rows());
+        EXPECT_EQ(segment.el_lengths.size(), segment.reftrack.rows());
+        next_point += segment.reftrack.rows();
+        next_s += segment.el_lengths.sum();
+    }
+    EXPECT_EQ(next_point, n_points + OVERLAP);
+    EXPECT_NEAR(next_s - segments.front().s_start, length, 1e-9);
+    
+    // s_start counts from point 0, the points are stepsize_reg apart along the raw polyline (the closing element is
+    // shorter)
+    Assembled track = assemble(segments, n_points);
+    EXPECT_NEAR(segments.front().s_start, track.el_lengths.head(OVERLAP).sum(), 1e-9);
+    EXPECT_NEAR(track.el_lengths(0), 3.0, 1e-3);
+    EXPECT_LE(track.el_lengths(n_points - 1), 3.0 + 1e-9);
+    EXPECT_NEAR(length, track.el_lengths.sum(), 1e-9);
+    
+    // The closing spline runs from the last point to point 0
+    const TrackSegment& last = segments.back();
+    int r = n_points - 1 - last.first_point;
+    double x_end = last.coeffs_x.row(r).sum();
+    double y_end = last.coeffs_y.row(r).sum();
+    EXPECT_NEAR(x_end, track.points(0, 0), 1e-9);
+    EXPECT_NEAR(y_end, track.points(0, 1), 1e-9);
+    EXPECT_EQ(last.reftrack.row(last.reftrack.rows() - OVERLAP), wavyLoop().row(0));
+}
+
+TEST(TrackStreaming, ClosedSplinesMatchTheWholeTrack) {
+    int n_points = 0;
+    std::vector<TrackSegment> segments = stream(wavyLoop(), 100, true, &n_points);
+    Assembled track = assemble(segments, n_points);
+    
+    // Whole track splines over the same points
+    trajectory_planning_helpers::Matrix2Xd path(2, n_points + 1);
+    path.leftCols(n_points) = track.points.transpose();
+    path.col(n_points) = track.points.row(0).transpose();
+    VectorXd el_lengths = (path.rightCols(n_points) - path.leftCols(n_points)).colwise().norm().transpose();
+    auto [coeffs_x, coeffs_y, a_interp, normvectors] = trajectory_planning_helpers::calc_splines(path, el_lengths);
+    
+    EXPECT_LT((track.el_lengths - el_lengths).cwiseAbs().maxCoeff(), 1e-12);
+    
+    // All splines, including the first ones, the closing one and those at the segment boundaries
+    double max_err = std::max((track.coeffs_x - coeffs_x).cwiseAbs().maxCoeff(),
+                              (track.coeffs_y - coeffs_y).cwiseAbs().maxCoeff());
+    EXPECT_LT(max_err, 1e-5);
+    for (int i : {0, 1, OVERLAP - 1, OVERLAP, SEGMENT_POINTS + OVERLAP, n_points - 1}) {
+        EXPECT_NEAR(track.coeffs_x(i, 2), coeffs_x(i, 2), 1e-3 * std::abs(coeffs_x(i, 2)) + 1e-7) << "spline " << i;
+        EXPECT_NEAR(track.coeffs_y(i, 2), coeffs_y(i, 2), 1e-3 * std::abs(coeffs_y(i, 2)) + 1e-7) << "spline " << i;
+    }
+}
+
+TEST(TrackStreaming, ChunkBoundariesDoNotChangeTheSegments) {
+    MatrixXd raw = wavyLoop();
+    
+    for (bool closed : {true, false}) {
+        std::vector<TrackSegment> reference = stream(raw, static_cast<int>(raw.rows()), closed);
+        for (int chunk_rows : {1, 7, 64}) {
+            std::vector<TrackSegment> segments = stream(raw, chunk_rows, closed);
+            ASSERT_EQ(segments.size(), reference.size());
+            for (size_t k = 0; k < segments.size(); ++k) {
+                EXPECT_EQ(segments[k].first_point, reference[k].first_point);
+                EXPECT_EQ(segments[k].reftrack, reference[k].reftrack);
+                EXPECT_EQ(segments[k].coeffs_x, reference[k].coeffs_x);
+                EXPECT_EQ(segments[k].coeffs_y, reference[k].coeffs_y);
+            }
+        }
+    }
+}
+
+TEST(TrackStreaming, OpenTrackEndsWithoutSpline) {
+    int n_points = 0;
+    std::vector<TrackSegment> segments = stream(wavyLoop(), 100, false, &n_points);
+    
+    EXPECT_EQ(segments.front().first_point, 0);
+    EXPECT_EQ(segments.front().s_start, 0.0);
+    int n_splines = 0;
+    for (const TrackSegment& segment : segments) {
+        n_splines += segment.coeffs_x.rows();
+    }
+    EXPECT_EQ(n_splines, n_points - 1);
+    EXPECT_EQ(segments.back().coeffs_x.rows(), segments.back().reftrack.rows() - 1);
+}
+
+TEST(TrackStreaming, ShortClosedTrackHoldsBackAllPoints) {
+    // Fewer points than the overlap: one segment with all of them, starting at point 0
+    MatrixXd raw(5, 2);
+    raw << 0.0, 0.0,
+           6.0, 0.0,
+           6.0, 6.0,
+           0.0, 6.0,
+           0.0, 0.0;
+    int n_points = 0;
+    double length = 0.0;
+    std::vector<TrackSegment> segments = stream(raw, 2, true, &n_points, &length);
+    
+    ASSERT_EQ(n_points, 8);
+    ASSERT_EQ(segments.size(), 1u);
+    EXPECT_EQ(segments[0].first_point, 0);
+    EXPECT_EQ(segments[0].reftrack.rows(), 8);
+    EXPECT_NEAR(length, 24.0, 1e-9);
+    EXPECT_NEAR(segments[0].coeffs_x.row(7).sum(), 0.0, 1e-9);
+    EXPECT_NEAR(segments[0].coeffs_y.row(7).sum(), 0.0, 1e-9);
+}
+
+TEST(TrackStreaming, FileStreamMatchesPreparer) {
+    MatrixXd raw = utils::readCSV(TRACK_FILE);
+    ASSERT_GT(raw.rows(), 0);
+    
+    std::vector<TrackSegment> expected;
+    TrackStreamPreparer preparer(stepsizeOptions(), [&](const TrackSegment& segment) { expected.push_back(segment); },
+                                 SEGMENT_POINTS);
+    preparer.add(raw);
+    preparer.finish();
+    
+    // Small read blocks, so that the chunks end in the middle of lines
+    std::vector<TrackSegment> segments;
+    int n_points = utils::prepareTrackStreaming(TRACK_FILE, stepsizeOptions(),
+                                                [&](const TrackSegment& segment) { segments.push_back(segment); },
+                                                SEGMENT_POINTS, true, 257);
+    
+    EXPECT_EQ(n_points, preparer.numPoints());
+    ASSERT_EQ(segments.size(), expected.size());
+    for (size_t k = 0; k < segments.size(); ++k) {
+        EXPECT_EQ(segments[k].reftrack, expected[k].reftrack);
+        EXPECT_EQ(segments[k].coeffs_x, expected[k].coeffs_x);
+        EXPECT_EQ(segments[k].s_start, expected[k].s_start);
+    }
+}
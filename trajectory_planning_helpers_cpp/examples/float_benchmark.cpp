@@ -0,0 +1,122 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+using namespace trajectory_planning_helpers;
+
+// Runs fn n_runs times and returns the mean runtime in milliseconds
+static double timeIt(const std::function<void()>& fn, int n_runs) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < n_runs; ++i) {
+        fn();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / n_runs;
+}
+
+template <typename Scalar>
+struct BenchmarkData {
+    Matrix2X<Scalar> reftrack;
+    VectorX<Scalar> el_lengths;
+    Matrix2X<Scalar> path;
+    MatrixX<Scalar> coeffs_x;
+    MatrixX<Scalar> coeffs_y;
+    VectorX<Scalar> psi;
+};
+
+template <typename Scalar>
+BenchmarkData<Scalar> createData(int n_ref, int n_path) {
+    BenchmarkData<Scalar> data;
+    
+    // Closed, wavy oval of roughly 5 km length
+    Eigen::Matrix2Xd ref(2, n_ref);
+    for (int i = 0; i < n_ref; ++i) {
+        double phi = 2.0 * M_PI * i / n_ref;
+        double r = 800.0 + 40.0 * std::sin(7.0 * phi);
+        ref(0, i) = r * std::cos(phi);
+        ref(1, i) = 0.6 * r * std::sin(phi);
+    }
+    
+    Eigen::VectorXd el(n_ref);
+    for (int i = 0; i < n_ref; ++i) {
+        el(i) = (ref.col((i + 1) % n_ref) - ref.col(i)).norm();
+    }
+    
+    // Noisy "telemetry" positions along the track
+    Eigen::Matrix2Xd path(2, n_path);
+    for (int i = 0; i < n_path; ++i) {
+        int j = static_cast<int>(static_cast<long>(i) * n_ref / n_path);
+        path.col(i) = ref.col(j) + Eigen::Vector2d(0.5 * std::sin(0.1 * i), 0.5 * std::cos(0.13 * i));
+    }
+    
+    Eigen::Matrix2Xd ref_cl(2, n_ref + 1);
+    ref_cl.leftCols(n_ref) = ref;
+    ref_cl.col(n_ref) = ref.col(0);
+    auto [coeffs_x, coeffs_y, A, normvec] = calc_splines(ref_cl, el);
+    
+    data.reftrack = ref.cast<Scalar>();
+    data.el_lengths = el.cast<Scalar>();
+    data.path = path.cast<Scalar>();
+    data.coeffs_x = coeffs_x.cast<Scalar>();
+    data.coeffs_y = coeffs_y.cast<Scalar>();
+    data.psi = Eigen::VectorXd::LinSpaced(n_ref, -M_PI, M_PI).cast<Scalar>();
+    return data;
+}
+
+template <typename Scalar>
+void runBenchmarks(const BenchmarkData<Scalar>& data, double* times) {
+    volatile Scalar sink = 0;
+    
+    times[0] = timeIt([&]() {
+        VectorX<Scalar> s = path_matching_global<Scalar>(data.path, data.reftrack, data.el_lengths);
+        sink = sink + s(0);
+    }, 3);
+    
+    times[1] = timeIt([&]() {
+        auto [psi, kappa] = calc_head_curv_num<Scalar>(data.reftrack, data.el_lengths, true);
+        sink = sink + kappa(0);
+    }, 20);
+    
+    times[2] = timeIt([&]() {
+        auto [path_interp, inds, t, s] = interp_splines<Scalar>(data.coeffs_x, data.coeffs_y, 0, 0.5);
+        sink = sink + s(0);
+    }, 20);
+    
+    Matrix2X<Scalar> tangvecs, normvecs;
+    times[3] = timeIt([&]() {
+        calc_tangent_normal_vectors<Scalar>(data.psi, tangvecs, normvecs);
+        sink = sink + normvecs(0, 0);
+    }, 50);
+}
+
+int main(int argc, char* argv[]) {
+    int n_ref = (argc > 1) ? std::atoi(argv[1]) : 10000;
+    int n_path = (argc > 2) ? std::atoi(argv[2]) : 2000;
+    
+    std::cout << "Trajectory Planning Helpers C++ - float vs. double benchmark" << std::endl;
+    std::cout << "Reference points: " << n_ref << ", path points: " << n_path << std::endl;
+    
+    auto data_d = createData<double>(n_ref, n_path);
+    auto data_f = createData<float>(n_ref, n_path);
+    
+    double times_d[4], times_f[4];
+    runBenchmarks<double>(data_d, times_d);
+    runBenchmarks<float>(data_f, times_f);
+    
+    const char* names[4] = {"path_matching_global", "calc_head_curv_num", "interp_splines", "calc_tangent_normal_vectors"};
+    
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\n" << std::left << std::setw(30) << "function"
+              << std::right << std::setw(12) << "double [ms]" << std::setw(12) << "float [ms]"
+              << std::setw(10) << "speedup" << std::endl;
+    for (int i = 0; i < 4; ++i) {
+        std::cout << std::left << std::setw(30) << names[i]
+                  << std::right << std::setw(12) << times_d[i] << std::setw(12) << times_f[i]
+                  << std::setw(9) << times_d[i] / times_f[i] << "x" << std::endl;
+    }
+    
+    return 0;
+}
@@ -1,30 +1,130 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <vector>
 #include <tuple>
+#include <thread>
+#include <exception>
+#include <algorithm>
 
 namespace trajectory_planning_helpers {
 
+namespace detail {
+
+// Eigen types per scalar type. The functions below only see these through the alias templates, which makes their
+// scalar a non-deduced context: calls without template arguments default to double and keep accepting Eigen
+// expressions through implicit conversion, float callers select the fast path explicitly (e.g. f<float>(...))
+template <typename Scalar>
+struct EigenTypes {
+    using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    using MatrixX = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+    using Matrix2X = Eigen::Matrix<Scalar, 2, Eigen::Dynamic>;
+    using Vector2 = Eigen::Matrix<Scalar, 2, 1>;
+};
+
+} // namespace detail
+
+// Scalar-templated type aliases (all functions are explicitly instantiated for float and double)
+template <typename Scalar> using VectorX = typename detail::EigenTypes<Scalar>::VectorX;
+template <typename Scalar> using MatrixX = typename detail::EigenTypes<Scalar>::MatrixX;
+template <typename Scalar> using Matrix2X = typename detail::EigenTypes<Scalar>::Matrix2X;
+template <typename Scalar> using Vector2 = typename detail::EigenTypes<Scalar>::Vector2;
+
 // Type aliases for better readability
-using VectorXd = Eigen::VectorXd;
-using MatrixXd = Eigen::MatrixXd;
-using Matrix2Xd = Eigen::Matrix2Xd;
-using Vector2d = Eigen::Vector2d;
-
-// Spline calculation functions
-std::tuple<MatrixXd, MatrixXd, MatrixXd, MatrixXd> calc_splines(
-    const Matrix2Xd& path,
-    const VectorXd& el_lengths = VectorXd(),
+using VectorXd = VectorX<double>;
+using MatrixXd = MatrixX<double>;
+using Matrix2Xd = Matrix2X<double>;
+using Vector2d = Vector2<double>;
+
+using VectorXf = VectorX<float>;
+using MatrixXf = MatrixX<float>;
+using Matrix2Xf = Matrix2X<float>;
+using Vector2f = Vector2<float>;
+
+// Read-only views used for all array inputs: they bind plain matrices, blocks and maps of any stride without
+// copying (e.g. reftrack.leftCols(2) or a column of a larger table). Row-major expressions such as
+// reftrack.transpose() are still accepted but are copied into a temporary; use transposed_view() instead
+using DynamicStride = Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>;
+template <typename Scalar> using Matrix2XView = Eigen::Ref<const Matrix2X<Scalar>, 0, DynamicStride>;
+template <typename Scalar> using MatrixXView = Eigen::Ref<const MatrixX<Scalar>, 0, DynamicStride>;
+template <typename Scalar> using VectorXView = Eigen::Ref<const VectorX<Scalar>, 0, Eigen::InnerStride<>>;
+
+// Zero-copy transposed view of column-major storage, e.g. an N x 4 reftrack [x, y, w_tr_right, w_tr_left]
+// seen as 4 x N with one point per column, which binds to the Matrix2XView/MatrixXView inputs without a copy
+template <typename Derived>
+Eigen::Map<const MatrixX<typename Derived::Scalar>, 0, DynamicStride> transposed_view(const Eigen::MatrixBase<Derived>& m) {
+    static_assert(int(Derived::Flags) & Eigen::DirectAccessBit, "transposed_view requires direct memory access");
+    static_assert(!(int(Derived::Flags) & Eigen::RowMajorBit), "transposed_view requires column-major storage");
+    return Eigen::Map<const MatrixX<typename Derived::Scalar>, 0, DynamicStride>(
+        m.derived().data(), m.cols(), m.rows(), DynamicStride(m.derived().innerStride(), m.derived().outerStride()));
+}
+
+// Splits [0, n) into contiguous chunks of at least min_chunk elements and calls fn(begin, end) for each chunk on up
+// to n_threads threads (n_threads <= 0: hardware concurrency). fn must be safe to call concurrently on disjoint
+// ranges; the first exception thrown by a chunk is rethrown after all threads have joined
+template <typename Fn>
+void parallel_for(int n, Fn&& fn, int n_threads = 0, int min_chunk = 1024) {
+    if (n <= 0) {
+        return;
+    }
+    
+    if (n_threads <= 0) {
+        n_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+    n_threads = std::max(1, std::min(n_threads, (n + min_chunk - 1) / std::max(1, min_chunk)));
+    
+    if (n_threads == 1) {
+        fn(0, n);
+        return;
+    }
+    
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(n_threads);
+    int chunk = (n + n_threads - 1) / n_threads;
+    
+    for (int k = 0; k < n_threads; ++k) {
+        int begin = k * chunk;
+        int end = std::min(n, begin + chunk);
+        if (begin >= end) {
+            break;
+        }
+        threads.emplace_back([&fn, &errors, k, begin, end]() {
+            try {
+                fn(begin, end);
+            } catch (...) {
+                errors[k] = std::current_exception();
+            }
+        });
+    }
+    
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// Spline calculation functions: coefficients [a, b, c, d] per spline, the sparse 4N x 4N linear system they solve and
+// the normal vectors at the spline starts
+template <typename Scalar = double>
+std::tuple<MatrixX<Scalar>, MatrixX<Scalar>, Eigen::SparseMatrix<Scalar>, MatrixX<Scalar>> calc_splines(
+    const Matrix2XView<Scalar>& path,
+    const VectorXView<Scalar>& el_lengths = VectorX<Scalar>(),
     double psi_s = 0.0,
     double psi_e = 0.0,
     bool use_dist_scaling = true
 );
 
 // Curvature calculation functions
-std::tuple<VectorXd, VectorXd> calc_head_curv_num(
-    const Matrix2Xd& path,
-    const VectorXd& el_lengths,
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> calc_head_curv_num(
+    const Matrix2XView<Scalar>& path,
+    const VectorXView<Scalar>& el_lengths,
     bool is_closed,
     double stepsize_psi_preview = 1.0,
     double stepsize_psi_review = 1.0,
@@ -33,32 +133,71 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
     bool calc_curv = true
 );
 
+// Analytical heading and curvature at arbitrary spline parameters t (spline index ind_spls(i), t_spls(i) in [0, 1])
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> calc_head_curv_an(
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const VectorXView<Scalar>& ind_spls,
+    const VectorXView<Scalar>& t_spls,
+    bool calc_curv = true
+);
+
 // Spline interpolation
-std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
-    const MatrixXd& coeffs_x,
-    const MatrixXd& coeffs_y,
+template <typename Scalar = double>
+std::tuple<Matrix2X<Scalar>, VectorX<Scalar>, VectorX<Scalar>, VectorX<Scalar>> interp_splines(
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
     int incl_last_point = 0,
     double stepsize_approx = 1.0
 );
 
 // Normal vector calculation
-MatrixXd calc_normal_vectors(const VectorXd& psi);
+template <typename Scalar = double>
+MatrixX<Scalar> calc_normal_vectors(const VectorXView<Scalar>& psi);
+
+// Tangent vector calculation
+template <typename Scalar = double>
+MatrixX<Scalar> calc_tangent_vectors(const VectorXView<Scalar>& psi);
 
-// Tangent vector calculation  
-MatrixXd calc_tangent_vectors(const VectorXd& psi);
+// Fused tangent and normal vector calculation (one sincos per heading), writes into
+// the given matrices and only reallocates them if their size does not match psi
+template <typename Scalar = double>
+void calc_tangent_normal_vectors(const VectorXView<Scalar>& psi, Matrix2X<Scalar>& tangvecs, Matrix2X<Scalar>& normvecs);
 
 // Angle normalization
-VectorXd normalize_psi(const VectorXd& psi);
+template <typename Scalar = double>
+VectorX<Scalar> normalize_psi(const VectorXView<Scalar>& psi);
 double normalize_psi(double psi);
+float normalize_psi(float psi);
 
 // 3-point angle calculation
-VectorXd angle3pt(const Matrix2Xd& points);
+template <typename Scalar = double>
+VectorX<Scalar> angle3pt(const Matrix2XView<Scalar>& points);
 
 // Optimization functions
-std::tuple<VectorXd, VectorXd, double> opt_min_curv(
-    const MatrixXd& reftrack,
-    const MatrixXd& normvectors,
-    const MatrixXd& A,
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>, double> opt_min_curv(
+    const MatrixXView<Scalar>& reftrack,
+    const MatrixXView<Scalar>& normvectors,
+    const MatrixXView<Scalar>& A,
+    double kappa_bound,
+    double w_veh,
+    bool print_debug = false,
+    bool plot_debug = false,
+    bool closed = true,
+    double psi_s = 0.0,
+    double psi_e = 0.0,
+    bool fix_s = false,
+    bool fix_e = false
+);
+
+// Same with the spline matrix A stored sparse (it is banded), avoids densifying it for large tracks
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>, double> opt_min_curv(
+    const MatrixXView<Scalar>& reftrack,
+    const MatrixXView<Scalar>& normvectors,
+    const Eigen::SparseMatrix<Scalar>& A,
     double kappa_bound,
     double w_veh,
     bool print_debug = false,
@@ -71,35 +210,183 @@ std::tuple<VectorXd, VectorXd, double> opt_min_curv(
 );
 
 // Velocity profile calculation
-std::tuple<VectorXd, VectorXd> calc_vel_profile(
-    const VectorXd& kappa,
-    const VectorXd& el_lengths,
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> calc_vel_profile(
+    const VectorXView<Scalar>& kappa,
+    const VectorXView<Scalar>& el_lengths,
     bool closed,
     double drag_coeff,
     double m_veh,
-    const VectorXd& ggv,
+    const VectorXView<Scalar>& ggv,
     double mu = 1.0,
     double v_start = 0.0,
     double v_end = 0.0
 );
 
+// Result of matching a position onto a reference line: segment index, parameter t in [0, 1] on that segment,
+// arc length s of the projected point and signed lateral distance d (positive to the left of the driving direction)
+template <typename Scalar = double>
+struct PathMatch {
+    int index = 0;
+    Scalar t = 0;
+    Scalar s = 0;
+    Scalar d = 0;
+};
+
+// Static uniform grid over the segments of a reference line. Built once per prepared track, nearest-segment
+// queries only visit the grid cells around the query position (expected O(1) instead of O(M) per query)
+template <typename Scalar = double>
+class SegmentIndex {
+public:
+    SegmentIndex() = default;
+    
+    // points: one point per column; closed adds the segment from the last back to the first point;
+    // cell_size <= 0 selects a cell size from the mean segment length
+    explicit SegmentIndex(const Matrix2XView<Scalar>& points, bool closed = true, double cell_size = 0.0);
+    
+    // Projects pos onto the closest segment
+    PathMatch<Scalar> match(const Vector2<Scalar>& pos) const;
+    
+    // Index of the segment closest to pos
+    int closestSegment(const Vector2<Scalar>& pos) const;
+    
+    // Projects pos onto segment seg_idx (no search)
+    PathMatch<Scalar> projectOnSegment(const Vector2<Scalar>& pos, int seg_idx) const;
+    
+    // Same closed line starting at point offset: shifts the arc lengths and renumbers the segments in the grid cells
+    // instead of building the grid again (same matches as an index built over the rotated points)
+    SegmentIndex rotated(int offset) const;
+    
+    bool empty() const { return n_segments_ == 0; }
+    bool closed() const { return closed_; }
+    int numSegments() const { return n_segments_; }
+    Scalar length() const { return s_points_(n_segments_); }
+    const Matrix2X<Scalar>& points() const { return points_; }
+    const VectorX<Scalar>& sPoints() const { return s_points_; }  // arc length at each segment start + total length
+
+private:
+    Matrix2X<Scalar> points_;
+    VectorX<Scalar> s_points_;
+    bool closed_ = true;
+    int n_segments_ = 0;
+    
+    // Grid geometry and segment lists per cell (compressed: segments of cell c are cell_segments_[cell_start_[c]..])
+    Scalar x_min_ = 0, y_min_ = 0;
+    Scalar cell_size_ = 1;
+    int nx_ = 0, ny_ = 0;
+    std::vector<int> cell_start_;
+    std::vector<int> cell_segments_;
+    
+    int segmentEnd(int seg_idx) const { return (seg_idx + 1 < points_.cols()) ? seg_idx + 1 : 0; }
+};
+
+// Frenet frame of a reference line (e.g. a prepared track or a raceline) with per-segment tangent, normal and arc
+// length tables. Batch conversions process the columns in parallel chunks (see parallel_for)
+template <typename Scalar = double>
+class FrenetFrame {
+public:
+    FrenetFrame() = default;
+    
+    // points: one point per column; closed adds the segment from the last back to the first point
+    explicit FrenetFrame(const Matrix2XView<Scalar>& points, bool closed = true);
+    explicit FrenetFrame(const SegmentIndex<Scalar>& index);
+    
+    // Single conversions: pos -> (s, d) and (s, d) -> pos, s wraps around on closed lines
+    Vector2<Scalar> toFrenet(const Vector2<Scalar>& pos) const;
+    Vector2<Scalar> toCartesian(Scalar s, Scalar d) const;
+    
+    // Batch conversions: positions (2 x N) -> rows [s; d] and rows [s; d] -> positions
+    Matrix2X<Scalar> toFrenet(const Matrix2XView<Scalar>& positions, int n_threads = 0) const;
+    Matrix2X<Scalar> toFrenet(const Matrix2X<Scalar>& positions, int n_threads = 0) const {
+        // Exact match for plain matrices, which would otherwise also convert to Vector2
+        return toFrenet(Matrix2XView<Scalar>(positions), n_threads);
+    }
+    Matrix2X<Scalar> toCartesian(const Matrix2XView<Scalar>& frenet, int n_threads = 0) const;
+    
+    const SegmentIndex<Scalar>& index() const { return index_; }
+    const Matrix2X<Scalar>& tangents() const { return tangents_; }
+    const Matrix2X<Scalar>& normals() const { return normals_; }
+    Scalar length() const { return index_.length(); }
+
+private:
+    SegmentIndex<Scalar> index_;
+    Matrix2X<Scalar> tangents_;  // unit tangent per segment
+    Matrix2X<Scalar> normals_;   // unit normal per segment (pointing left)
+    
+    void initTables();
+    int segmentAt(Scalar& s) const;
+    Vector2<Scalar> projectOnSegment(const Vector2<Scalar>& pos, int seg_idx) const;
+};
+
 // Path matching functions
-VectorXd path_matching_global(
-    const Matrix2Xd& path,
-    const Matrix2Xd& reftrack,
-    const VectorXd& el_lengths_reftrack
+template <typename Scalar = double>
+VectorX<Scalar> path_matching_global(
+    const Matrix2XView<Scalar>& path,
+    const Matrix2XView<Scalar>& reftrack,
+    const VectorXView<Scalar>& el_lengths_reftrack
+);
+
+// Path matching against a prebuilt segment index, projects onto the segments instead of the closest vertex and
+// returns s and d of every path point
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> path_matching_global(
+    const Matrix2XView<Scalar>& path,
+    const SegmentIndex<Scalar>& index
 );
 
-std::tuple<int, double> path_matching_local(
-    const Vector2d& pos_est,
-    const Matrix2Xd& reftrack,
+template <typename Scalar = double>
+std::tuple<int, Scalar> path_matching_local(
+    const Vector2<Scalar>& pos_est,
+    const Matrix2XView<Scalar>& reftrack,
     int s_ind_last_guess,
-    const VectorXd& el_lengths = VectorXd()
+    const VectorXView<Scalar>& el_lengths = VectorX<Scalar>()
+);
+
+// Local path matching for cyclic localization (e.g. in a control loop): searches the segments around last_match
+// within the distance travelled since the last call (estimated from the previous projection) plus ds_margin,
+// wrapping across start/finish on closed lines. At most max_segments segments are checked in each direction, which
+// bounds the latency of tracking; a reach beyond them (lost lock, e.g. a relocalization jump) falls back to
+// index.match(), which also (re)initializes last_match
+template <typename Scalar = double>
+PathMatch<Scalar> path_matching_local(
+    const Vector2<Scalar>& pos_est,
+    const SegmentIndex<Scalar>& index,
+    const PathMatch<Scalar>& last_match,
+    double ds_margin = 5.0,
+    int max_segments = 100
+);
+
+// Exact projection onto cubic splines (coeffs as returned by calc_splines, spline i starting at index segment i): the
+// spline is seeded by the segment index, then t is refined with Newton steps on the distance (moving to the
+// neighbouring spline if the minimum lies beyond t = 0 or 1). s is the index arc length at the spline start plus the
+// fraction of the spline arc length up to t, d is positive to the left
+template <typename Scalar = double>
+PathMatch<Scalar> path_matching_spline(
+    const Vector2<Scalar>& pos,
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const SegmentIndex<Scalar>& index,
+    int max_iter = 5,
+    double tol = 1e-6
+);
+
+// Batch form, processes the path points in parallel chunks and returns s and d of every point
+template <typename Scalar = double>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> path_matching_spline(
+    const Matrix2XView<Scalar>& path,
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const SegmentIndex<Scalar>& index,
+    int max_iter = 5,
+    double tol = 1e-6,
+    int n_threads = 0
 );
 
-// Spline approximation
-std::tuple<MatrixXd, VectorXd> spline_approximation(
-    const Matrix2Xd& track,
+// Spline approximation: track holds one point per column with rows [x, y, further channels...] (e.g. track
+// widths), all channels are resampled in the same pass and returned as one point per row
+template <typename Scalar = double>
+std::tuple<MatrixX<Scalar>, VectorX<Scalar>> spline_approximation(
+    const MatrixXView<Scalar>& track,
     int k_reg = 3,
     double s_reg = 10.0,
     int stepsize_prep = 1,
@@ -107,4 +394,4 @@ std::tuple<MatrixXd, VectorXd> spline_approximation(
     bool debug = false
 );
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+} // namespace trajectory_planning_helpers
@@ -3,12 +3,13 @@
 
 namespace trajectory_planning_helpers {
 
-VectorXd angle3pt(const Matrix2Xd& points) {
+template <typename Scalar>
+VectorX<Scalar> angle3pt(const Matrix2XView<Scalar>& points) {
     int n_points = points.cols();
-    VectorXd angles(n_points);
+    VectorX<Scalar> angles(n_points);
     
     for (int i = 0; i < n_points; ++i) {
-        Vector2d p1, p2, p3;
+        Vector2<Scalar> p1, p2, p3;
         
         if (i == 0) {
             p1 = points.col(n_points - 1);
@@ -24,11 +25,11 @@ VectorXd angle3pt(const Matrix2Xd& points) {
             p3 = points.col(i + 1);
         }
         
-        Vector2d v1 = p1 - p2;
-        Vector2d v2 = p3 - p2;
+        Vector2<Scalar> v1 = p1 - p2;
+        Vector2<Scalar> v2 = p3 - p2;
         
-        double dot_product = v1.dot(v2);
-        double cross_product = v1(0) * v2(1) - v1(1) * v2(0);
+        Scalar dot_product = v1.dot(v2);
+        Scalar cross_product = v1(0) * v2(1) - v1(1) * v2(0);
         
         angles(i) = std::atan2(cross_product, dot_product);
     }
@@ -36,4 +37,8 @@ VectorXd angle3pt(const Matrix2Xd& points) {
     return angles;
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template VectorX<float> angle3pt<float>(const Matrix2XView<float>&);
+template VectorX<double> angle3pt<double>(const Matrix2XView<double>&);
+
+} // namespace trajectory_planning_helpers
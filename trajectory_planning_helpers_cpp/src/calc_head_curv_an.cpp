@@ -0,0 +1,73 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace trajectory_planning_helpers {
+
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> calc_head_curv_an(
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const VectorXView<Scalar>& ind_spls,
+    const VectorXView<Scalar>& t_spls,
+    bool calc_curv) {
+    
+    // Check inputs
+    if (coeffs_x.rows() != coeffs_y.rows()) {
+        throw std::runtime_error("coeffs_x and coeffs_y must have same number of rows!");
+    }
+    
+    if (coeffs_x.cols() != 4 || coeffs_y.cols() != 4) {
+        throw std::runtime_error("Coefficient matrices must have 4 columns!");
+    }
+    
+    if (ind_spls.size() != t_spls.size()) {
+        throw std::runtime_error("ind_spls and t_spls must have the same length!");
+    }
+    
+    int n_points = t_spls.size();
+    int no_splines = coeffs_x.rows();
+    
+    // Gather first and second derivatives of all requested points
+    // x(t) = a0 + a1*t + a2*t^2 + a3*t^3 -> x'(t) = a1 + 2*a2*t + 3*a3*t^2, x''(t) = 2*a2 + 6*a3*t
+    using ArrayX = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    ArrayX x_d(n_points), y_d(n_points), x_dd(n_points), y_dd(n_points);
+    
+    for (int i = 0; i < n_points; ++i) {
+        int ind = static_cast<int>(ind_spls(i));
+        if (ind < 0 || ind >= no_splines) {
+            throw std::runtime_error("Spline index out of range!");
+        }
+        
+        Scalar t = t_spls(i);
+        x_d(i) = coeffs_x(ind, 1) + 2.0 * coeffs_x(ind, 2) * t + 3.0 * coeffs_x(ind, 3) * t * t;
+        y_d(i) = coeffs_y(ind, 1) + 2.0 * coeffs_y(ind, 2) * t + 3.0 * coeffs_y(ind, 3) * t * t;
+        x_dd(i) = 2.0 * coeffs_x(ind, 2) + 6.0 * coeffs_x(ind, 3) * t;
+        y_dd(i) = 2.0 * coeffs_y(ind, 2) + 6.0 * coeffs_y(ind, 3) * t;
+    }
+    
+    // HEADING CALCULATION (north = 0, same convention as calc_head_curv_num)
+    VectorX<Scalar> psi(n_points);
+    for (int i = 0; i < n_points; ++i) {
+        psi(i) = normalize_psi(std::atan2(y_d(i), x_d(i)) - M_PI / 2.0);
+    }
+    
+    // CURVATURE CALCULATION
+    VectorX<Scalar> kappa;
+    if (calc_curv) {
+        ArrayX speed_sq = x_d.square() + y_d.square();
+        kappa = ((x_d * y_dd - y_d * x_dd) / (speed_sq * speed_sq.sqrt())).matrix();
+    } else {
+        kappa = VectorX<Scalar>::Zero(n_points);
+    }
+    
+    return std::make_tuple(psi, kappa);
+}
+
+// Explicit instantiations
+template std::tuple<VectorX<float>, VectorX<float>> calc_head_curv_an<float>(
+    const MatrixXView<float>&, const MatrixXView<float>&, const VectorXView<float>&, const VectorXView<float>&, bool);
+template std::tuple<VectorX<double>, VectorX<double>> calc_head_curv_an<double>(
+    const MatrixXView<double>&, const MatrixXView<double>&, const VectorXView<double>&, const VectorXView<double>&, bool);
+
+} // namespace trajectory_planning_helpers
@@ -4,9 +4,10 @@
 
 namespace trajectory_planning_helpers {
 
-std::tuple<VectorXd, VectorXd> calc_head_curv_num(
-    const Matrix2Xd& path,
-    const VectorXd& el_lengths,
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> calc_head_curv_num(
+    const Matrix2XView<Scalar>& path,
+    const VectorXView<Scalar>& el_lengths,
     bool is_closed,
     double stepsize_psi_preview,
     double stepsize_psi_review,
@@ -23,8 +24,11 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
         throw std::runtime_error("path must have the length of el_lengths + 1!");
     }
     
-    VectorXd psi(n_points);
-    VectorXd kappa(n_points);
+    VectorX<Scalar> psi(n_points);
+    VectorX<Scalar> kappa(n_points);
+    
+    // All per-point arithmetic stays in Scalar, mixing in double constants would promote every float operation
+    const Scalar half_pi = static_cast<Scalar>(M_PI / 2.0);
     
     if (is_closed) {
         // CLOSED PATH CASE
@@ -41,7 +45,7 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
         
         // HEADING CALCULATION
         // Create extended path for boundary handling
-        Matrix2Xd path_temp(2, n_points + steps_tot_psi);
+        Matrix2X<Scalar> path_temp(2, n_points + steps_tot_psi);
         
         // Add review points at the beginning
         for (int i = 0; i < ind_step_review_psi; ++i) {
@@ -58,17 +62,17 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
         
         // Calculate tangent vectors
         for (int i = 0; i < n_points; ++i) {
-            Vector2d tangvec = path_temp.col(i + steps_tot_psi) - path_temp.col(i);
-            psi(i) = std::atan2(tangvec(1), tangvec(0)) - M_PI / 2.0;
+            Vector2<Scalar> tangvec = path_temp.col(i + steps_tot_psi) - path_temp.col(i);
+            psi(i) = std::atan2(tangvec(1), tangvec(0)) - half_pi;
         }
         
         // Normalize psi
-        psi = normalize_psi(psi);
+        psi = normalize_psi<Scalar>(psi);
         
         // CURVATURE CALCULATION
         if (calc_curv) {
             // Extend psi array for curvature calculation
-            VectorXd psi_temp(n_points + steps_tot_curv);
+            VectorX<Scalar> psi_temp(n_points + steps_tot_curv);
             
             for (int i = 0; i < ind_step_review_curv; ++i) {
                 psi_temp(i) = psi(n_points - ind_step_review_curv + i);
@@ -81,30 +85,30 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
             }
             
             // Calculate delta psi
-            VectorXd delta_psi(n_points);
+            VectorX<Scalar> delta_psi(n_points);
             for (int i = 0; i < n_points; ++i) {
                 delta_psi(i) = normalize_psi(psi_temp(i + steps_tot_curv) - psi_temp(i));
             }
             
             // Calculate cumulative distances
-            VectorXd s_points_cl(n_points + 1);
+            VectorX<Scalar> s_points_cl(n_points + 1);
             s_points_cl(0) = 0.0;
             for (int i = 0; i < n_points; ++i) {
                 s_points_cl(i + 1) = s_points_cl(i) + el_lengths(i);
             }
             
-            VectorXd s_points = s_points_cl.head(n_points);
+            VectorX<Scalar> s_points = s_points_cl.head(n_points);
             
             // Calculate reverse cumulative distances
-            VectorXd s_points_cl_reverse(n_points);
-            double cumsum = 0.0;
+            VectorX<Scalar> s_points_cl_reverse(n_points);
+            Scalar cumsum = 0;
             for (int i = n_points - 1; i >= 0; --i) {
                 cumsum += el_lengths(i);
                 s_points_cl_reverse(n_points - 1 - i) = -cumsum;
             }
             
             // Extend s_points for curvature calculation
-            VectorXd s_points_temp(n_points + steps_tot_curv);
+            VectorX<Scalar> s_points_temp(n_points + steps_tot_curv);
             
             for (int i = 0; i < ind_step_review_curv; ++i) {
                 s_points_temp(i) = s_points_cl_reverse(ind_step_review_curv - 1 - i);
@@ -112,25 +116,25 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
             
             s_points_temp.segment(ind_step_review_curv, n_points) = s_points;
             
-            double total_track_length = s_points_cl(n_points);
+            Scalar total_track_length = s_points_cl(n_points);
             for (int i = 0; i < ind_step_preview_curv; ++i) {
                 s_points_temp(ind_step_review_curv + n_points + i) = total_track_length + s_points(i);
             }
             
             // Calculate curvature
             for (int i = 0; i < n_points; ++i) {
-                double ds = s_points_temp(i + steps_tot_curv) - s_points_temp(i);
+                Scalar ds = s_points_temp(i + steps_tot_curv) - s_points_temp(i);
                 kappa(i) = delta_psi(i) / ds;
             }
         } else {
             kappa.setZero();
         }
-        
+    
     } else {
         // UNCLOSED PATH CASE
         
         // HEADING CALCULATION
-        Matrix2Xd tangvecs(2, n_points);
+        Matrix2X<Scalar> tangvecs(2, n_points);
         
         // First point
         tangvecs.col(0) = path.col(1) - path.col(0);
@@ -145,14 +149,14 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
         
         // Calculate psi
         for (int i = 0; i < n_points; ++i) {
-            psi(i) = std::atan2(tangvecs(1, i), tangvecs(0, i)) - M_PI / 2.0;
+            psi(i) = std::atan2(tangvecs(1, i), tangvecs(0, i)) - half_pi;
         }
         
-        psi = normalize_psi(psi);
+        psi = normalize_psi<Scalar>(psi);
         
         // CURVATURE CALCULATION
         if (calc_curv) {
-            VectorXd delta_psi(n_points);
+            VectorX<Scalar> delta_psi(n_points);
             
             // First point
             delta_psi(0) = psi(1) - psi(0);
@@ -165,7 +169,7 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
             // Last point
             delta_psi(n_points - 1) = psi(n_points - 1) - psi(n_points - 2);
             
-            delta_psi = normalize_psi(delta_psi);
+            delta_psi = normalize_psi<Scalar>(delta_psi);
             
             // Calculate curvature
             kappa(0) = delta_psi(0) / el_lengths(0);
@@ -175,7 +179,7 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
             }
             
             kappa(n_points - 1) = delta_psi(n_points - 1) / el_lengths(n_points - 2);
-            
+        
         } else {
             kappa.setZero();
         }
@@ -184,4 +188,10 @@ std::tuple<VectorXd, VectorXd> calc_head_curv_num(
     return std::make_tuple(psi, kappa);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template std::tuple<VectorX<float>, VectorX<float>> calc_head_curv_num<float>(
+    const Matrix2XView<float>&, const VectorXView<float>&, bool, double, double, double, double, bool);
+template std::tuple<VectorX<double>, VectorX<double>> calc_head_curv_num<double>(
+    const Matrix2XView<double>&, const VectorXView<double>&, bool, double, double, double, double, bool);
+
+} // namespace trajectory_planning_helpers
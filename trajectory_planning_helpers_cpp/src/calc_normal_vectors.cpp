@@ -1,18 +1,21 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
-#include <cmath>
+#include "fast_math.hpp"
 
 namespace trajectory_planning_helpers {
 
-MatrixXd calc_normal_vectors(const VectorXd& psi) {
+template <typename Scalar>
+MatrixX<Scalar> calc_normal_vectors(const VectorXView<Scalar>& psi) {
     int n = psi.size();
-    MatrixXd normal_vectors(2, n);
+    MatrixX<Scalar> normal_vectors(2, n);
     
-    for (int i = 0; i < n; ++i) {
-        normal_vectors(0, i) = std::cos(psi(i) + M_PI / 2.0);  // x component
-        normal_vectors(1, i) = std::sin(psi(i) + M_PI / 2.0);  // y component
-    }
+    // cos(psi + pi/2) = -sin(psi), sin(psi + pi/2) = cos(psi)
+    detail::heading_vectors<Scalar>(psi, nullptr, normal_vectors.data());
     
     return normal_vectors;
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template MatrixX<float> calc_normal_vectors<float>(const VectorXView<float>&);
+template MatrixX<double> calc_normal_vectors<double>(const VectorXView<double>&);
+
+} // namespace trajectory_planning_helpers
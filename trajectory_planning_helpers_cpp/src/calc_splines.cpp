@@ -1,12 +1,81 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 namespace trajectory_planning_helpers {
 
-std::tuple<MatrixXd, MatrixXd, MatrixXd, MatrixXd> calc_splines(
-    const Matrix2Xd& path,
-    const VectorXd& el_lengths,
+namespace {
+
+// Solves the tridiagonal system sub(i) * m(i - 1) + diag(i) * m(i) + sup(i) * m(i + 1) = rhs(i) for both columns of
+// rhs (Thomas algorithm, the systems set up below are diagonally dominant)
+template <typename Scalar>
+MatrixX<Scalar> solveTridiagonal(const VectorX<Scalar>& sub, const VectorX<Scalar>& diag, const VectorX<Scalar>& sup,
+                                 MatrixX<Scalar> rhs) {
+    int n = diag.size();
+    VectorX<Scalar> sup_mod(n);
+    
+    sup_mod(0) = sup(0) / diag(0);
+    rhs.row(0) /= diag(0);
+    for (int i = 1; i < n; ++i) {
+        Scalar denom = diag(i) - sub(i) * sup_mod(i - 1);
+        sup_mod(i) = sup(i) / denom;
+        rhs.row(i) = (rhs.row(i) - sub(i) * rhs.row(i - 1)) / denom;
+    }
+    for (int i = n - 2; i >= 0; --i) {
+        rhs.row(i) -= sup_mod(i) * rhs.row(i + 1);
+    }
+    
+    return rhs;
+}
+
+// Cyclic variant: sub(0) couples row 0 to m(n - 1) and sup(n - 1) couples row n - 1 to m(0) (Sherman-Morrison on
+// top of two tridiagonal solves)
+template <typename Scalar>
+MatrixX<Scalar> solveCyclicTridiagonal(const VectorX<Scalar>& sub, VectorX<Scalar> diag, const VectorX<Scalar>& sup,
+                                       const MatrixX<Scalar>& rhs) {
+    int n = diag.size();
+    
+    if (n < 3) {
+        // Corner entries coincide with the band, small enough for a dense solve
+        MatrixX<Scalar> dense = MatrixX<Scalar>::Zero(n, n);
+        for (int i = 0; i < n; ++i) {
+            dense(i, i) += diag(i);
+            dense(i, (i + n - 1) % n) += sub(i);
+            dense(i, (i + 1) % n) += sup(i);
+        }
+        return dense.partialPivLu().solve(rhs);
+    }
+    
+    Scalar gamma = -diag(0);
+    Scalar corner_low = sup(n - 1);
+    Scalar corner_high = sub(0);
+    diag(0) -= gamma;
+    diag(n - 1) -= corner_high * corner_low / gamma;
+    
+    MatrixX<Scalar> x = solveTridiagonal<Scalar>(sub, diag, sup, rhs);
+    
+    MatrixX<Scalar> u = MatrixX<Scalar>::Zero(n, 1);
+    u(0, 0) = gamma;
+    u(n - 1, 0) = corner_low;
+    MatrixX<Scalar> z = solveTridiagonal<Scalar>(sub, diag, sup, u);
+    
+    Scalar denom = 1.0 + z(0, 0) + corner_high * z(n - 1, 0) / gamma;
+    for (int c = 0; c < x.cols(); ++c) {
+        Scalar factor = (x(0, c) + corner_high * x(n - 1, c) / gamma) / denom;
+        x.col(c) -= factor * z.col(0);
+    }
+    
+    return x;
+}
+
+} // namespace
+
+template <typename Scalar>
+std::tuple<MatrixX<Scalar>, MatrixX<Scalar>, Eigen::SparseMatrix<Scalar>, MatrixX<Scalar>> calc_splines(
+    const Matrix2XView<Scalar>& path,
+    const VectorXView<Scalar>& el_lengths,
     double psi_s,
     double psi_e,
     bool use_dist_scaling) {
@@ -30,38 +99,99 @@ std::tuple<MatrixXd, MatrixXd, MatrixXd, MatrixXd> calc_splines(
     
     int no_splines = n_points - 1;
     
-    // Fast approximation: Use linear segments instead of complex spline fitting
-    // This is much faster for large datasets and still gives good results
+    if (no_splines < 1) {
+        throw std::runtime_error("Spline calculation requires at least two points!");
+    }
     
-    // Create simple linear spline coefficients (degree 1)
-    MatrixXd coeffs_x = MatrixXd::Zero(no_splines, 4);
-    MatrixXd coeffs_y = MatrixXd::Zero(no_splines, 4);
+    // Cubic splines x(t) = a + b*t + c*t^2 + d*t^3, t in [0, 1], through all points with continuous first and second
+    // derivatives. With distance scaling the derivatives are matched with respect to the element lengths h_i, i.e.
+    // the splines form one C2 cubic spline over the arc length. That spline is found from its second derivatives M at
+    // the points (tridiagonal system, cyclic for closed paths, clamped to the headings psi_s/psi_e for open ones), the
+    // coefficients of spline i follow as a = p_i, b = p_i+1 - p_i - h_i^2 (2 M_i + M_i+1) / 6, c = h_i^2 M_i / 2 and
+    // d = h_i^2 (M_i+1 - M_i) / 6
+    VectorX<Scalar> h = VectorX<Scalar>::Ones(no_splines);
+    if (use_dist_scaling) {
+        for (int i = 0; i < no_splines; ++i) {
+            h(i) = (el_lengths.size() > 0) ? el_lengths(i) : (path.col(i + 1) - path.col(i)).norm();
+        }
+    }
+    // Zero-length elements (duplicated points) would divide by zero
+    h = h.cwiseMax(Scalar(1e-9));
     
+    // Chord slopes of every element, one column per coordinate
+    MatrixX<Scalar> slope(no_splines, 2);
     for (int i = 0; i < no_splines; ++i) {
-        // Linear spline: f(t) = a0 + a1*t (where t goes from 0 to 1)
-        coeffs_x(i, 0) = path(0, i);                    // a0: start point
-        coeffs_x(i, 1) = path(0, i+1) - path(0, i);     // a1: direction vector
+        slope.row(i) = (path.col(i + 1) - path.col(i)).transpose() / h(i);
+    }
+    
+    MatrixX<Scalar> m;
+    if (closed) {
+        // Unknowns M_0..M_n-1 (M_n = M_0): h_i-1 M_i-1 + 2 (h_i-1 + h_i) M_i + h_i M_i+1 = 6 (slope_i - slope_i-1)
+        int n = no_splines;
+        VectorX<Scalar> sub(n), diag(n), sup(n);
+        MatrixX<Scalar> rhs(n, 2);
+        for (int i = 0; i < n; ++i) {
+            int prev = (i + n - 1) % n;
+            sub(i) = h(prev);
+            diag(i) = 2.0 * (h(prev) + h(i));
+            sup(i) = h(i);
+            rhs.row(i) = Scalar(6) * (slope.row(i) - slope.row(prev));
+        }
+        m = solveCyclicTridiagonal<Scalar>(sub, diag, sup, rhs);
+        m.conservativeResize(n + 1, Eigen::NoChange);
+        m.row(n) = m.row(0);
+    } else {
+        // Unknowns M_0..M_n, end rows clamp the first derivative to the unit direction of psi_s/psi_e (0 = north)
+        int n = no_splines + 1;
+        Eigen::Matrix<Scalar, 1, 2> dir_s(-std::sin(psi_s), std::cos(psi_s));
+        Eigen::Matrix<Scalar, 1, 2> dir_e(-std::sin(psi_e), std::cos(psi_e));
+        if (!use_dist_scaling) {
+            // Without scaling the parameter runs over [0, 1] per element, the end derivatives then span one element
+            dir_s *= (el_lengths.size() > 0) ? el_lengths(0) : (path.col(1) - path.col(0)).norm();
+            dir_e *= (el_lengths.size() > 0) ? el_lengths(no_splines - 1)
+                                             : (path.col(n_points - 1) - path.col(n_points - 2)).norm();
+        }
         
-        coeffs_y(i, 0) = path(1, i);                    // a0: start point  
-        coeffs_y(i, 1) = path(1, i+1) - path(1, i);     // a1: direction vector
+        VectorX<Scalar> sub = VectorX<Scalar>::Zero(n), diag(n), sup = VectorX<Scalar>::Zero(n);
+        MatrixX<Scalar> rhs(n, 2);
+        diag(0) = 2.0 * h(0);
+        sup(0) = h(0);
+        rhs.row(0) = Scalar(6) * (slope.row(0) - dir_s);
+        for (int i = 1; i < n - 1; ++i) {
+            sub(i) = h(i - 1);
+            diag(i) = 2.0 * (h(i - 1) + h(i));
+            sup(i) = h(i);
+            rhs.row(i) = Scalar(6) * (slope.row(i) - slope.row(i - 1));
+        }
+        sub(n - 1) = h(n - 2);
+        diag(n - 1) = 2.0 * h(n - 2);
+        rhs.row(n - 1) = Scalar(6) * (dir_e - slope.row(n - 2));
+        m = solveTridiagonal<Scalar>(sub, diag, sup, rhs);
     }
     
-    // Calculate normalized normal vectors from tangent vectors
-    MatrixXd normvec_normalized(no_splines, 2);
+    MatrixX<Scalar> coeffs_x(no_splines, 4);
+    MatrixX<Scalar> coeffs_y(no_splines, 4);
     for (int i = 0; i < no_splines; ++i) {
-        // Tangent vector is the derivative: [coeffs_x(i,1), coeffs_y(i,1)]
-        double tx = coeffs_x(i, 1);
-        double ty = coeffs_y(i, 1);
-        
-        // Normal vector is perpendicular to tangent: [-ty, tx]
-        double nx = -ty;
-        double ny = tx;
-        
-        // Normalize
-        double norm = std::sqrt(nx * nx + ny * ny);
-        if (norm > 1e-10) {
-            normvec_normalized(i, 0) = nx / norm;
-            normvec_normalized(i, 1) = ny / norm;
+        Scalar h_sq = h(i) * h(i);
+        for (int c = 0; c < 2; ++c) {
+            MatrixX<Scalar>& coeffs = (c == 0) ? coeffs_x : coeffs_y;
+            coeffs(i, 0) = path(c, i);
+            coeffs(i, 1) = path(c, i + 1) - path(c, i) - h_sq * (2.0 * m(i, c) + m(i + 1, c)) / 6.0;
+            coeffs(i, 2) = h_sq * m(i, c) / 2.0;
+            coeffs(i, 3) = h_sq * (m(i + 1, c) - m(i, c)) / 6.0;
+        }
+    }
+    
+    // Normal vectors from the derivative at the start of every spline (there is no heading to convert here),
+    // pointing to the left: [-y'(0), x'(0)]
+    MatrixX<Scalar> normvec_normalized(no_splines, 2);
+    for (int i = 0; i < no_splines; ++i) {
+        Scalar tx = coeffs_x(i, 1);
+        Scalar ty = coeffs_y(i, 1);
+        Scalar norm = std::sqrt(tx * tx + ty * ty);
+        if (norm > Scalar(1e-10)) {
+            normvec_normalized(i, 0) = -ty / norm;
+            normvec_normalized(i, 1) = tx / norm;
         } else {
             // Handle degenerate case
             normvec_normalized(i, 0) = 1.0;
@@ -69,10 +199,49 @@ std::tuple<MatrixXd, MatrixXd, MatrixXd, MatrixXd> calc_splines(
         }
     }
     
-    // Create dummy A matrix (not used in optimized version)
-    MatrixXd A = MatrixXd::Identity(no_splines, no_splines);
+    // Linear system of the coefficients (unknowns [a_i, b_i, c_i, d_i] per spline, four equations per spline: start
+    // point, end point, first and second derivative continuity with the next spline scaled by h_i / h_i+1). The last
+    // two rows close the path, or hold the start and end headings of open paths. The coefficients above solve it
+    std::vector<Eigen::Triplet<Scalar>> entries;
+    entries.reserve(12 * no_splines);
+    for (int i = 0; i < no_splines; ++i) {
+        int j = 4 * i;
+        entries.emplace_back(j, j, 1.0);
+        for (int k = 0; k < 4; ++k) {
+            entries.emplace_back(j + 1, j + k, 1.0);
+        }
+        
+        if (i == no_splines - 1 && !closed) {
+            break;
+        }
+        int next = (i + 1 < no_splines) ? j + 4 : 0;
+        Scalar scaling = h(i) / h((i + 1) % no_splines);
+        entries.emplace_back(j + 2, j + 1, 1.0);
+        entries.emplace_back(j + 2, j + 2, 2.0);
+        entries.emplace_back(j + 2, j + 3, 3.0);
+        entries.emplace_back(j + 2, next + 1, -scaling);
+        entries.emplace_back(j + 3, j + 2, 2.0);
+        entries.emplace_back(j + 3, j + 3, 6.0);
+        entries.emplace_back(j + 3, next + 2, -2.0 * scaling * scaling);
+    }
+    if (!closed) {
+        int j = 4 * (no_splines - 1);
+        entries.emplace_back(j + 2, 1, 1.0);
+        entries.emplace_back(j + 3, j + 1, 1.0);
+        entries.emplace_back(j + 3, j + 2, 2.0);
+        entries.emplace_back(j + 3, j + 3, 3.0);
+    }
+    
+    Eigen::SparseMatrix<Scalar> A(4 * no_splines, 4 * no_splines);
+    A.setFromTriplets(entries.begin(), entries.end());
     
     return std::make_tuple(coeffs_x, coeffs_y, A, normvec_normalized);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template std::tuple<MatrixX<float>, MatrixX<float>, Eigen::SparseMatrix<float>, MatrixX<float>> calc_splines<float>(
+    const Matrix2XView<float>&, const VectorXView<float>&, double, double, bool);
+template std::tuple<MatrixX<double>, MatrixX<double>, Eigen::SparseMatrix<double>, MatrixX<double>> calc_splines<double>(
+    const Matrix2XView<double>&, const VectorXView<double>&, double, double, bool);
+
+} // namespace trajectory_planning_helpers
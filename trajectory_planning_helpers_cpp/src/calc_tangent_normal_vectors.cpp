@@ -0,0 +1,26 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include "fast_math.hpp"
+
+namespace trajectory_planning_helpers {
+
+template <typename Scalar>
+void calc_tangent_normal_vectors(const VectorXView<Scalar>& psi, Matrix2X<Scalar>& tangvecs, Matrix2X<Scalar>& normvecs) {
+    int n = psi.size();
+    
+    // Only reallocate if the caller did not provide correctly sized outputs
+    if (tangvecs.cols() != n) {
+        tangvecs.resize(2, n);
+    }
+    if (normvecs.cols() != n) {
+        normvecs.resize(2, n);
+    }
+    
+    // Tangent: [cos(psi), sin(psi)], normal: tangent rotated by +pi/2 -> [-sin(psi), cos(psi)]
+    detail::heading_vectors<Scalar>(psi, tangvecs.data(), normvecs.data());
+}
+
+// Explicit instantiations
+template void calc_tangent_normal_vectors<float>(const VectorXView<float>&, Matrix2X<float>&, Matrix2X<float>&);
+template void calc_tangent_normal_vectors<double>(const VectorXView<double>&, Matrix2X<double>&, Matrix2X<double>&);
+
+} // namespace trajectory_planning_helpers
@@ -1,18 +1,20 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
-#include <cmath>
+#include "fast_math.hpp"
 
 namespace trajectory_planning_helpers {
 
-MatrixXd calc_tangent_vectors(const VectorXd& psi) {
+template <typename Scalar>
+MatrixX<Scalar> calc_tangent_vectors(const VectorXView<Scalar>& psi) {
     int n = psi.size();
-    MatrixXd tangent_vectors(2, n);
+    MatrixX<Scalar> tangent_vectors(2, n);
     
-    for (int i = 0; i < n; ++i) {
-        tangent_vectors(0, i) = std::cos(psi(i));  // x component  
-        tangent_vectors(1, i) = std::sin(psi(i));  // y component
-    }
+    detail::heading_vectors<Scalar>(psi, tangent_vectors.data(), nullptr);
     
     return tangent_vectors;
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template MatrixX<float> calc_tangent_vectors<float>(const VectorXView<float>&);
+template MatrixX<double> calc_tangent_vectors<double>(const VectorXView<double>&);
+
+} // namespace trajectory_planning_helpers
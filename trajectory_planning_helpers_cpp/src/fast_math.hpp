@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cmath>
+
+namespace trajectory_planning_helpers::detail {
+
+// Computes sine and cosine of the same angle with a single libm call where the
+// compiler provides one (glibc sincos), falling back to two separate calls
+inline void sincos(double x, double& s, double& c) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_sincos(x, &s, &c);
+#else
+    s = std::sin(x);
+    c = std::cos(x);
+#endif
+}
+
+inline void sincos(float x, float& s, float& c) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_sincosf(x, &s, &c);
+#else
+    s = std::sin(x);
+    c = std::cos(x);
+#endif
+}
+
+// Tangent [cos(psi), sin(psi)] and normal [-sin(psi), cos(psi)] of every heading from one sincos per element, written
+// column by column into 2 x n storage. Either output may be null, so calc_tangent_vectors, calc_normal_vectors and
+// calc_tangent_normal_vectors share this single kernel
+template <typename Scalar, typename Psi>
+inline void heading_vectors(const Psi& psi, Scalar* tang, Scalar* norm) {
+    int n = static_cast<int>(psi.size());
+    
+    for (int i = 0; i < n; ++i) {
+        Scalar s, c;
+        sincos(psi(i), s, c);
+        
+        if (tang != nullptr) {
+            tang[2 * i] = c;
+            tang[2 * i + 1] = s;
+        }
+        if (norm != nullptr) {
+            norm[2 * i] = -s;
+            norm[2 * i + 1] = c;
+        }
+    }
+}
+
+} // namespace trajectory_planning_helpers::detail
@@ -0,0 +1,139 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace trajectory_planning_helpers {
+
+template <typename Scalar>
+FrenetFrame<Scalar>::FrenetFrame(const Matrix2XView<Scalar>& points, bool closed)
+    : index_(points, closed) {
+    initTables();
+}
+
+template <typename Scalar>
+FrenetFrame<Scalar>::FrenetFrame(const SegmentIndex<Scalar>& index)
+    : index_(index) {
+    if (index_.empty()) {
+        throw std::runtime_error("FrenetFrame requires a non-empty segment index!");
+    }
+    initTables();
+}
+
+template <typename Scalar>
+void FrenetFrame<Scalar>::initTables() {
+    int n_segments = index_.numSegments();
+    const Matrix2X<Scalar>& points = index_.points();
+    const VectorX<Scalar>& s_points = index_.sPoints();
+
+    tangents_.resize(2, n_segments);
+    normals_.resize(2, n_segments);
+
+    for (int i = 0; i < n_segments; ++i) {
+        int i_next = (i + 1 < points.cols()) ? i + 1 : 0;
+        Scalar seg_length = s_points(i + 1) - s_points(i);
+
+        if (seg_length > Scalar(1e-9)) {
+            tangents_.col(i) = (points.col(i_next) - points.col(i)) / seg_length;
+        } else {
+            tangents_.col(i) = (i > 0) ? Vector2<Scalar>(tangents_.col(i - 1)) : Vector2<Scalar>(1, 0);
+        }
+
+        // Normal rotated by +90 deg, i.e. pointing to the left (positive d)
+        normals_(0, i) = -tangents_(1, i);
+        normals_(1, i) = tangents_(0, i);
+    }
+}
+
+template <typename Scalar>
+int FrenetFrame<Scalar>::segmentAt(Scalar& s) const {
+    const VectorX<Scalar>& s_points = index_.sPoints();
+    int n_segments = index_.numSegments();
+    Scalar length = s_points(n_segments);
+
+    // Wrap around on closed lines, open lines are extrapolated along the first/last segment
+    if (index_.closed() && length > 0) {
+        s = std::fmod(s, length);
+        if (s < 0) {
+            s += length;
+        }
+    }
+
+    int seg_idx = static_cast<int>(std::upper_bound(s_points.data(), s_points.data() + n_segments, s) - s_points.data()) - 1;
+    return std::clamp(seg_idx, 0, n_segments - 1);
+}
+
+template <typename Scalar>
+Vector2<Scalar> FrenetFrame<Scalar>::projectOnSegment(const Vector2<Scalar>& pos, int seg_idx) const {
+    // Projection with the tangent/normal tables: the tangent gives the arc length along the segment directly and the
+    // normal the side, the distance is taken to the clamped foot point
+    const VectorX<Scalar>& s_points = index_.sPoints();
+    Vector2<Scalar> to_point = pos - index_.points().col(seg_idx);
+    Scalar seg_length = s_points(seg_idx + 1) - s_points(seg_idx);
+    Scalar along = std::clamp(to_point.dot(tangents_.col(seg_idx)), Scalar(0), seg_length);
+    Scalar dist = (to_point - along * tangents_.col(seg_idx)).norm();
+
+    Scalar d = (to_point.dot(normals_.col(seg_idx)) >= 0) ? dist : -dist;
+    return Vector2<Scalar>(s_points(seg_idx) + along, d);
+}
+
+template <typename Scalar>
+Vector2<Scalar> FrenetFrame<Scalar>::toFrenet(const Vector2<Scalar>& pos) const {
+    return projectOnSegment(pos, index_.closestSegment(pos));
+}
+
+template <typename Scalar>
+Vector2<Scalar> FrenetFrame<Scalar>::toCartesian(Scalar s, Scalar d) const {
+    int seg_idx = segmentAt(s);
+    Scalar ds = s - index_.sPoints()(seg_idx);
+    return index_.points().col(seg_idx) + ds * tangents_.col(seg_idx) + d * normals_.col(seg_idx);
+}
+
+template <typename Scalar>
+Matrix2X<Scalar> FrenetFrame<Scalar>::toFrenet(const Matrix2XView<Scalar>& positions, int n_threads) const {
+    int n_points = positions.cols();
+    Matrix2X<Scalar> frenet(2, n_points);
+
+    parallel_for(n_points, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            frenet.col(i) = toFrenet(Vector2<Scalar>(positions.col(i)));
+        }
+    }, n_threads);
+
+    return frenet;
+}
+
+template <typename Scalar>
+Matrix2X<Scalar> FrenetFrame<Scalar>::toCartesian(const Matrix2XView<Scalar>& frenet, int n_threads) const {
+    int n_points = frenet.cols();
+    Matrix2X<Scalar> positions(2, n_points);
+
+    const Matrix2X<Scalar>& points = index_.points();
+    const VectorX<Scalar>& s_points = index_.sPoints();
+
+    parallel_for(n_points, [&](int begin, int end) {
+        // Segment lookup first, then the affine mapping over the whole chunk in one pass
+        std::vector<int> seg_inds(end - begin);
+        VectorX<Scalar> ds(end - begin);
+
+        for (int i = begin; i < end; ++i) {
+            Scalar s = frenet(0, i);
+            seg_inds[i - begin] = segmentAt(s);
+            ds(i - begin) = s - s_points(seg_inds[i - begin]);
+        }
+
+        for (int i = begin; i < end; ++i) {
+            int seg_idx = seg_inds[i - begin];
+            positions.col(i) = points.col(seg_idx) + ds(i - begin) * tangents_.col(seg_idx)
+                               + frenet(1, i) * normals_.col(seg_idx);
+        }
+    }, n_threads);
+
+    return positions;
+}
+
+// Explicit instantiations
+template class FrenetFrame<float>;
+template class FrenetFrame<double>;
+
+} // namespace trajectory_planning_helpers
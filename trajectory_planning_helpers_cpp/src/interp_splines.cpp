@@ -4,9 +4,10 @@
 
 namespace trajectory_planning_helpers {
 
-std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
-    const MatrixXd& coeffs_x,
-    const MatrixXd& coeffs_y,
+template <typename Scalar>
+std::tuple<Matrix2X<Scalar>, VectorX<Scalar>, VectorX<Scalar>, VectorX<Scalar>> interp_splines(
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
     int incl_last_point,
     double stepsize_approx) {
     
@@ -30,16 +31,16 @@ std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
         double length = 0.0;
         
         for (int j = 0; j < n_samples; ++j) {
-            double t1 = double(j) / n_samples;
-            double t2 = double(j + 1) / n_samples;
+            Scalar t1 = Scalar(j) / n_samples;
+            Scalar t2 = Scalar(j + 1) / n_samples;
             
             // Calculate derivatives at t1 and t2
-            double dx1 = coeffs_x(i, 1) + 2.0 * coeffs_x(i, 2) * t1 + 3.0 * coeffs_x(i, 3) * t1 * t1;
-            double dy1 = coeffs_y(i, 1) + 2.0 * coeffs_y(i, 2) * t1 + 3.0 * coeffs_y(i, 3) * t1 * t1;
-            double dx2 = coeffs_x(i, 1) + 2.0 * coeffs_x(i, 2) * t2 + 3.0 * coeffs_x(i, 3) * t2 * t2;
-            double dy2 = coeffs_y(i, 1) + 2.0 * coeffs_y(i, 2) * t2 + 3.0 * coeffs_y(i, 3) * t2 * t2;
+            Scalar dx1 = coeffs_x(i, 1) + Scalar(2.0) * coeffs_x(i, 2) * t1 + Scalar(3.0) * coeffs_x(i, 3) * t1 * t1;
+            Scalar dy1 = coeffs_y(i, 1) + Scalar(2.0) * coeffs_y(i, 2) * t1 + Scalar(3.0) * coeffs_y(i, 3) * t1 * t1;
+            Scalar dx2 = coeffs_x(i, 1) + Scalar(2.0) * coeffs_x(i, 2) * t2 + Scalar(3.0) * coeffs_x(i, 3) * t2 * t2;
+            Scalar dy2 = coeffs_y(i, 1) + Scalar(2.0) * coeffs_y(i, 2) * t2 + Scalar(3.0) * coeffs_y(i, 3) * t2 * t2;
             
-            double speed_avg = 0.5 * (std::sqrt(dx1*dx1 + dy1*dy1) + std::sqrt(dx2*dx2 + dy2*dy2));
+            Scalar speed_avg = Scalar(0.5) * (std::sqrt(dx1*dx1 + dy1*dy1) + std::sqrt(dx2*dx2 + dy2*dy2));
             length += speed_avg / n_samples;
         }
         
@@ -52,21 +53,21 @@ std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
     }
     
     // Interpolate splines
-    Matrix2Xd path_interp(2, total_points);
-    VectorXd spline_inds(total_points);
-    VectorXd t_values(total_points);
-    VectorXd s_values(total_points);
+    Matrix2X<Scalar> path_interp(2, total_points);
+    VectorX<Scalar> spline_inds(total_points);
+    VectorX<Scalar> t_values(total_points);
+    VectorX<Scalar> s_values(total_points);
     
     int point_idx = 0;
     double s_current = 0.0;
     
     for (int i = 0; i < no_splines; ++i) {
         for (int j = 0; j < no_interp_points[i]; ++j) {
-            double t = double(j) / no_interp_points[i];
+            Scalar t = Scalar(j) / no_interp_points[i];
             
             // Calculate position
-            double x = coeffs_x(i, 0) + coeffs_x(i, 1) * t + coeffs_x(i, 2) * t * t + coeffs_x(i, 3) * t * t * t;
-            double y = coeffs_y(i, 0) + coeffs_y(i, 1) * t + coeffs_y(i, 2) * t * t + coeffs_y(i, 3) * t * t * t;
+            Scalar x = coeffs_x(i, 0) + coeffs_x(i, 1) * t + coeffs_x(i, 2) * t * t + coeffs_x(i, 3) * t * t * t;
+            Scalar y = coeffs_y(i, 0) + coeffs_y(i, 1) * t + coeffs_y(i, 2) * t * t + coeffs_y(i, 3) * t * t * t;
             
             path_interp(0, point_idx) = x;
             path_interp(1, point_idx) = y;
@@ -85,12 +86,12 @@ std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
     
     // Include last point if requested
     if (incl_last_point > 0) {
-        double t = 1.0;
+        Scalar t = 1.0;
         int last_spline = no_splines - 1;
         
-        double x = coeffs_x(last_spline, 0) + coeffs_x(last_spline, 1) * t + 
+        Scalar x = coeffs_x(last_spline, 0) + coeffs_x(last_spline, 1) * t + 
                    coeffs_x(last_spline, 2) * t * t + coeffs_x(last_spline, 3) * t * t * t;
-        double y = coeffs_y(last_spline, 0) + coeffs_y(last_spline, 1) * t + 
+        Scalar y = coeffs_y(last_spline, 0) + coeffs_y(last_spline, 1) * t + 
                    coeffs_y(last_spline, 2) * t * t + coeffs_y(last_spline, 3) * t * t * t;
         
         path_interp(0, point_idx) = x;
@@ -104,4 +105,10 @@ std::tuple<Matrix2Xd, VectorXd, VectorXd, VectorXd> interp_splines(
     return std::make_tuple(path_interp, spline_inds, t_values, s_values);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template std::tuple<Matrix2X<float>, VectorX<float>, VectorX<float>, VectorX<float>> interp_splines<float>(
+    const MatrixXView<float>&, const MatrixXView<float>&, int, double);
+template std::tuple<Matrix2X<double>, VectorX<double>, VectorX<double>, VectorX<double>> interp_splines<double>(
+    const MatrixXView<double>&, const MatrixXView<double>&, int, double);
+
+} // namespace trajectory_planning_helpers
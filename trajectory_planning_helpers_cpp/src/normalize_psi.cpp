@@ -3,8 +3,9 @@
 
 namespace trajectory_planning_helpers {
 
-VectorXd normalize_psi(const VectorXd& psi) {
-    VectorXd normalized(psi.size());
+template <typename Scalar>
+VectorX<Scalar> normalize_psi(const VectorXView<Scalar>& psi) {
+    VectorX<Scalar> normalized(psi.size());
     
     for (int i = 0; i < psi.size(); ++i) {
         normalized(i) = normalize_psi(psi(i));
@@ -23,4 +24,19 @@ double normalize_psi(double psi) {
     return psi;
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+float normalize_psi(float psi) {
+    const float pi = static_cast<float>(M_PI);
+    while (psi > pi) {
+        psi -= 2.0f * pi;
+    }
+    while (psi < -pi) {
+        psi += 2.0f * pi;
+    }
+    return psi;
+}
+
+// Explicit instantiations
+template VectorX<float> normalize_psi<float>(const VectorXView<float>&);
+template VectorX<double> normalize_psi<double>(const VectorXView<double>&);
+
+} // namespace trajectory_planning_helpers
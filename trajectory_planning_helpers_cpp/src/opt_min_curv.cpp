@@ -4,33 +4,27 @@
 
 namespace trajectory_planning_helpers {
 
-std::tuple<VectorXd, VectorXd, double> opt_min_curv(
-    const MatrixXd& reftrack,
-    const MatrixXd& normvectors,
-    const MatrixXd& A,
-    double kappa_bound,
-    double w_veh,
-    bool print_debug,
-    bool plot_debug,
-    bool closed,
-    double psi_s,
-    double psi_e,
-    bool fix_s,
-    bool fix_e) {
+namespace {
+
+// Shared by the dense and sparse overloads, the placeholder does not read the spline matrix
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>, double> optMinCurv(
+    const MatrixXView<Scalar>& reftrack,
+    bool print_debug) {
     
     // Simplified minimum curvature optimization
     // This is a placeholder implementation that returns the reference track
     
     int n_points = reftrack.rows();
     
-    VectorXd alpha_opt = VectorXd::Zero(n_points);
-    VectorXd s_opt(n_points);
+    VectorX<Scalar> alpha_opt = VectorX<Scalar>::Zero(n_points);
+    VectorX<Scalar> s_opt(n_points);
     
     // Calculate arc lengths along reference track  
     s_opt(0) = 0.0;
     for (int i = 1; i < n_points; ++i) {
-        Vector2d p1(reftrack(i-1, 0), reftrack(i-1, 1));
-        Vector2d p2(reftrack(i, 0), reftrack(i, 1));
+        Vector2<Scalar> p1(reftrack(i-1, 0), reftrack(i-1, 1));
+        Vector2<Scalar> p2(reftrack(i, 0), reftrack(i, 1));
         s_opt(i) = s_opt(i-1) + (p2 - p1).norm();
     }
     
@@ -43,4 +37,56 @@ std::tuple<VectorXd, VectorXd, double> opt_min_curv(
     return std::make_tuple(alpha_opt, s_opt, t_opt);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+} // namespace
+
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>, double> opt_min_curv(
+    const MatrixXView<Scalar>& reftrack,
+    const MatrixXView<Scalar>& normvectors,
+    const MatrixXView<Scalar>& A,
+    double kappa_bound,
+    double w_veh,
+    bool print_debug,
+    bool plot_debug,
+    bool closed,
+    double psi_s,
+    double psi_e,
+    bool fix_s,
+    bool fix_e) {
+    
+    return optMinCurv<Scalar>(reftrack, print_debug);
+}
+
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>, double> opt_min_curv(
+    const MatrixXView<Scalar>& reftrack,
+    const MatrixXView<Scalar>& /*normvectors*/,
+    const Eigen::SparseMatrix<Scalar>& /*A*/,
+    double /*kappa_bound*/,
+    double /*w_veh*/,
+    bool print_debug,
+    bool /*plot_debug*/,
+    bool /*closed*/,
+    double /*psi_s*/,
+    double /*psi_e*/,
+    bool /*fix_s*/,
+    bool /*fix_e*/) {
+    
+    return optMinCurv<Scalar>(reftrack, print_debug);
+}
+
+// Explicit instantiations
+template std::tuple<VectorX<float>, VectorX<float>, double> opt_min_curv<float>(
+    const MatrixXView<float>&, const MatrixXView<float>&, const MatrixXView<float>&, double, double,
+    bool, bool, bool, double, double, bool, bool);
+template std::tuple<VectorX<double>, VectorX<double>, double> opt_min_curv<double>(
+    const MatrixXView<double>&, const MatrixXView<double>&, const MatrixXView<double>&, double, double,
+    bool, bool, bool, double, double, bool, bool);
+template std::tuple<VectorX<float>, VectorX<float>, double> opt_min_curv<float>(
+    const MatrixXView<float>&, const MatrixXView<float>&, const Eigen::SparseMatrix<float>&, double, double,
+    bool, bool, bool, double, double, bool, bool);
+template std::tuple<VectorX<double>, VectorX<double>, double> opt_min_curv<double>(
+    const MatrixXView<double>&, const MatrixXView<double>&, const Eigen::SparseMatrix<double>&, double, double,
+    bool, bool, bool, double, double, bool, bool);
+
+} // namespace trajectory_planning_helpers
@@ -1,21 +1,23 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
 #include <cmath>
-#include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 namespace trajectory_planning_helpers {
 
-VectorXd path_matching_global(
-    const Matrix2Xd& path,
-    const Matrix2Xd& reftrack,
-    const VectorXd& el_lengths_reftrack) {
+template <typename Scalar>
+VectorX<Scalar> path_matching_global(
+    const Matrix2XView<Scalar>& path,
+    const Matrix2XView<Scalar>& reftrack,
+    const VectorXView<Scalar>& el_lengths_reftrack) {
     
     int n_path_points = path.cols();
     int n_reftrack_points = reftrack.cols();
     
-    VectorXd s_interp(n_path_points);
+    VectorX<Scalar> s_interp(n_path_points);
     
     // Calculate cumulative distances along reference track
-    VectorXd s_reftrack(n_reftrack_points);
+    VectorX<Scalar> s_reftrack(n_reftrack_points);
     s_reftrack(0) = 0.0;
     
     for (int i = 1; i < n_reftrack_points; ++i) {
@@ -26,17 +28,24 @@ VectorXd path_matching_global(
         }
     }
     
+    // Split reference coordinates into contiguous x/y arrays so the distance evaluation vectorizes (twice the
+    // number of SIMD lanes for float)
+    using ArrayX = Eigen::Array<Scalar, Eigen::Dynamic, 1>;
+    ArrayX ref_x = reftrack.row(0).transpose().array();
+    ArrayX ref_y = reftrack.row(1).transpose().array();
+    ArrayX dist_sq(n_reftrack_points);
+    
     // For each path point, find closest reference track point
     for (int i = 0; i < n_path_points; ++i) {
-        double min_dist = std::numeric_limits<double>::max();
-        int closest_idx = 0;
+        dist_sq = (ref_x - path(0, i)).square() + (ref_y - path(1, i)).square();
+        
+        // Vectorized min reduction followed by a scan for its position (faster than Eigen's indexed minCoeff)
+        Scalar min_dist_sq = dist_sq.minCoeff();
+        int closest_idx = static_cast<int>(std::find(dist_sq.data(), dist_sq.data() + n_reftrack_points, min_dist_sq) - dist_sq.data());
         
-        for (int j = 0; j < n_reftrack_points; ++j) {
-            double dist = (path.col(i) - reftrack.col(j)).norm();
-            if (dist < min_dist) {
-                min_dist = dist;
-                closest_idx = j;
-            }
+        // A non-finite path point gives NaN distances that compare unequal to everything, fall back to the first point
+        if (closest_idx == n_reftrack_points) {
+            closest_idx = 0;
         }
         
         s_interp(i) = s_reftrack(closest_idx);
@@ -45,4 +54,37 @@ VectorXd path_matching_global(
     return s_interp;
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> path_matching_global(
+    const Matrix2XView<Scalar>& path,
+    const SegmentIndex<Scalar>& index) {
+    
+    if (index.empty()) {
+        throw std::runtime_error("Segment index is empty!");
+    }
+    
+    int n_path_points = path.cols();
+    
+    VectorX<Scalar> s_interp(n_path_points);
+    VectorX<Scalar> d_interp(n_path_points);
+    
+    for (int i = 0; i < n_path_points; ++i) {
+        PathMatch<Scalar> match = index.match(path.col(i));
+        s_interp(i) = match.s;
+        d_interp(i) = match.d;
+    }
+    
+    return std::make_tuple(s_interp, d_interp);
+}
+
+// Explicit instantiations
+template VectorX<float> path_matching_global<float>(
+    const Matrix2XView<float>&, const Matrix2XView<float>&, const VectorXView<float>&);
+template VectorX<double> path_matching_global<double>(
+    const Matrix2XView<double>&, const Matrix2XView<double>&, const VectorXView<double>&);
+template std::tuple<VectorX<float>, VectorX<float>> path_matching_global<float>(
+    const Matrix2XView<float>&, const SegmentIndex<float>&);
+template std::tuple<VectorX<double>, VectorX<double>> path_matching_global<double>(
+    const Matrix2XView<double>&, const SegmentIndex<double>&);
+
+} // namespace trajectory_planning_helpers
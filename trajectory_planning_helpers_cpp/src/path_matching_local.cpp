@@ -1,14 +1,17 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include <stdexcept>
 
 namespace trajectory_planning_helpers {
 
-std::tuple<int, double> path_matching_local(
-    const Vector2d& pos_est,
-    const Matrix2Xd& reftrack,
+template <typename Scalar>
+std::tuple<int, Scalar> path_matching_local(
+    const Vector2<Scalar>& pos_est,
+    const Matrix2XView<Scalar>& reftrack,
     int s_ind_last_guess,
-    const VectorXd& el_lengths) {
+    const VectorXView<Scalar>& el_lengths) {
     
     int n_reftrack_points = reftrack.cols();
     
@@ -17,11 +20,11 @@ std::tuple<int, double> path_matching_local(
     int start_idx = std::max(0, s_ind_last_guess - search_window);
     int end_idx = std::min(n_reftrack_points - 1, s_ind_last_guess + search_window);
     
-    double min_dist = std::numeric_limits<double>::max();
+    Scalar min_dist = std::numeric_limits<Scalar>::max();
     int closest_idx = s_ind_last_guess;
     
     for (int i = start_idx; i <= end_idx; ++i) {
-        double dist = (pos_est - reftrack.col(i)).norm();
+        Scalar dist = (pos_est - reftrack.col(i)).squaredNorm();
         if (dist < min_dist) {
             min_dist = dist;
             closest_idx = i;
@@ -29,21 +32,114 @@ std::tuple<int, double> path_matching_local(
     }
     
     // Calculate interpolation parameter t
-    double t = 0.0;
+    Scalar t = 0.0;
     
     if (closest_idx < n_reftrack_points - 1) {
-        Vector2d p1 = reftrack.col(closest_idx);
-        Vector2d p2 = reftrack.col(closest_idx + 1);
-        Vector2d segment = p2 - p1;
-        Vector2d to_point = pos_est - p1;
+        Vector2<Scalar> p1 = reftrack.col(closest_idx);
+        Vector2<Scalar> p2 = reftrack.col(closest_idx + 1);
+        Vector2<Scalar> segment = p2 - p1;
+        Vector2<Scalar> to_point = pos_est - p1;
         
-        double segment_length_sq = segment.squaredNorm();
+        Scalar segment_length_sq = segment.squaredNorm();
         if (segment_length_sq > 1e-10) {
-            t = std::max(0.0, std::min(1.0, to_point.dot(segment) / segment_length_sq));
+            t = std::max(Scalar(0.0), std::min(Scalar(1.0), to_point.dot(segment) / segment_length_sq));
         }
     }
     
     return std::make_tuple(closest_idx, t);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+template <typename Scalar>
+PathMatch<Scalar> path_matching_local(
+    const Vector2<Scalar>& pos_est,
+    const SegmentIndex<Scalar>& index,
+    const PathMatch<Scalar>& last_match,
+    double ds_margin,
+    int max_segments) {
+    
+    int n_segments = index.numSegments();
+    
+    if (last_match.index < 0 || last_match.index >= n_segments) {
+        throw std::runtime_error("Last match does not belong to the segment index!");
+    }
+    
+    const Matrix2X<Scalar>& points = index.points();
+    const VectorX<Scalar>& s_points = index.sPoints();
+    
+    auto segmentLength = [&s_points](int seg_idx) { return s_points(seg_idx + 1) - s_points(seg_idx); };
+    
+    // Search reach: distance between the position and the previous projection, i.e. the distance travelled since the
+    // last call plus at most the previous lateral offset
+    int seg_last = last_match.index;
+    int seg_last_end = (seg_last + 1 < points.cols()) ? seg_last + 1 : 0;
+    Vector2<Scalar> pos_last = points.col(seg_last) + last_match.t * (points.col(seg_last_end) - points.col(seg_last));
+    Scalar reach = (pos_est - pos_last).norm() + static_cast<Scalar>(ds_margin);
+    
+    // On closed lines both directions together must not check a segment twice
+    int max_steps_fwd = max_segments;
+    int max_steps_bwd = max_segments;
+    if (index.closed()) {
+        max_steps_fwd = std::min(max_steps_fwd, n_segments / 2);
+        max_steps_bwd = std::min(max_steps_bwd, (n_segments - 1) / 2);
+    }
+    
+    PathMatch<Scalar> best = index.projectOnSegment(pos_est, seg_last);
+    
+    auto checkSegment = [&](int seg_idx) {
+        PathMatch<Scalar> match = index.projectOnSegment(pos_est, seg_idx);
+        if (std::abs(match.d) < std::abs(best.d)) {
+            best = match;
+        }
+    };
+    
+    // A walk that stops at max_segments before covering the reach has lost the lock (e.g. after a relocalization
+    // jump), the local result would be a wrong segment
+    bool lost = false;
+    
+    // Walk forward
+    Scalar dist = (1 - last_match.t) * segmentLength(seg_last);
+    int seg_idx = seg_last;
+    int k = 0;
+    for (; k < max_steps_fwd && dist < reach; ++k) {
+        if (seg_idx + 1 < n_segments) {
+            seg_idx++;
+        } else if (index.closed()) {
+            seg_idx = 0;
+        } else {
+            break;
+        }
+        checkSegment(seg_idx);
+        dist += segmentLength(seg_idx);
+    }
+    lost = lost || (k == max_segments && dist < reach);
+    
+    // Walk backward
+    dist = last_match.t * segmentLength(seg_last);
+    seg_idx = seg_last;
+    for (k = 0; k < max_steps_bwd && dist < reach; ++k) {
+        if (seg_idx > 0) {
+            seg_idx--;
+        } else if (index.closed()) {
+            seg_idx = n_segments - 1;
+        } else {
+            break;
+        }
+        checkSegment(seg_idx);
+        dist += segmentLength(seg_idx);
+    }
+    lost = lost || (k == max_segments && dist < reach);
+    
+    return lost ? index.match(pos_est) : best;
+}
+
+// Explicit instantiations
+template std::tuple<int, float> path_matching_local<float>(
+    const Vector2<float>&, const Matrix2XView<float>&, int, const VectorXView<float>&);
+template std::tuple<int, double> path_matching_local<double>(
+    const Vector2<double>&, const Matrix2XView<double>&, int, const VectorXView<double>&);
+template PathMatch<float> path_matching_local<float>(
+    const Vector2<float>&, const SegmentIndex<float>&, const PathMatch<float>&, double, int);
+template PathMatch<double> path_matching_local<double>(
+    const Vector2<double>&, const SegmentIndex<double>&, const PathMatch<double>&, double, int);
+    
+} // namespace trajectory_planning_helpers
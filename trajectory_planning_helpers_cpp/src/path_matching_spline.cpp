@@ -0,0 +1,193 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace trajectory_planning_helpers {
+
+namespace {
+
+// Position and first/second derivative of spline i at t
+template <typename Scalar>
+void eval_spline(const MatrixXView<Scalar>& coeffs_x, const MatrixXView<Scalar>& coeffs_y, int i, Scalar t,
+                 Vector2<Scalar>& p, Vector2<Scalar>& dp, Vector2<Scalar>& ddp) {
+    p << coeffs_x(i, 0) + (coeffs_x(i, 1) + (coeffs_x(i, 2) + coeffs_x(i, 3) * t) * t) * t,
+         coeffs_y(i, 0) + (coeffs_y(i, 1) + (coeffs_y(i, 2) + coeffs_y(i, 3) * t) * t) * t;
+    dp << coeffs_x(i, 1) + (2 * coeffs_x(i, 2) + 3 * coeffs_x(i, 3) * t) * t,
+          coeffs_y(i, 1) + (2 * coeffs_y(i, 2) + 3 * coeffs_y(i, 3) * t) * t;
+    ddp << 2 * coeffs_x(i, 2) + 6 * coeffs_x(i, 3) * t,
+           2 * coeffs_y(i, 2) + 6 * coeffs_y(i, 3) * t;
+}
+
+// Arc length of spline i from 0 to t (3-point Gauss-Legendre quadrature)
+template <typename Scalar>
+Scalar spline_length(const MatrixXView<Scalar>& coeffs_x, const MatrixXView<Scalar>& coeffs_y, int i, Scalar t) {
+    static const Scalar nodes[3] = {Scalar(-0.774596669241483), Scalar(0.0), Scalar(0.774596669241483)};
+    static const Scalar weights[3] = {Scalar(5.0 / 9.0), Scalar(8.0 / 9.0), Scalar(5.0 / 9.0)};
+
+    Scalar length = 0;
+    for (int k = 0; k < 3; ++k) {
+        Scalar tk = Scalar(0.5) * t * (nodes[k] + 1);
+        Scalar dx = coeffs_x(i, 1) + (2 * coeffs_x(i, 2) + 3 * coeffs_x(i, 3) * tk) * tk;
+        Scalar dy = coeffs_y(i, 1) + (2 * coeffs_y(i, 2) + 3 * coeffs_y(i, 3) * tk) * tk;
+        length += weights[k] * std::sqrt(dx * dx + dy * dy);
+    }
+    return Scalar(0.5) * t * length;
+}
+
+template <typename Scalar>
+void check_spline_inputs(const MatrixXView<Scalar>& coeffs_x, const MatrixXView<Scalar>& coeffs_y,
+                         const SegmentIndex<Scalar>& index) {
+    if (coeffs_x.rows() != coeffs_y.rows() || coeffs_x.cols() != 4 || coeffs_y.cols() != 4) {
+        throw std::runtime_error("Coefficient matrices must have the same number of rows and 4 columns!");
+    }
+
+    if (index.numSegments() != coeffs_x.rows()) {
+        throw std::runtime_error("Segment index must have one segment per spline!");
+    }
+}
+
+template <typename Scalar>
+PathMatch<Scalar> match_spline(
+    const Vector2<Scalar>& pos,
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const SegmentIndex<Scalar>& index,
+    int max_iter,
+    Scalar tol) {
+
+    int no_splines = coeffs_x.rows();
+
+    // Seed from the closest polyline segment
+    PathMatch<Scalar> seed = index.match(pos);
+    int spl = seed.index;
+    Scalar t = seed.t;
+
+    int best_spl = spl;
+    Scalar best_t = t;
+    Scalar best_dist_sq = std::numeric_limits<Scalar>::max();
+
+    Vector2<Scalar> p, dp, ddp;
+
+    // At most two moves to a neighbouring spline (avoids ping-pong at kinks of non-smooth splines)
+    for (int hop = 0; hop < 3; ++hop) {
+        // Newton steps on f(t) = (p(t) - pos) . p'(t), the derivative of half the squared distance
+        for (int iter = 0; iter < max_iter; ++iter) {
+            eval_spline(coeffs_x, coeffs_y, spl, t, p, dp, ddp);
+            Vector2<Scalar> r = p - pos;
+            Scalar f = r.dot(dp);
+            Scalar f_d = dp.squaredNorm() + r.dot(ddp);
+
+            // Fall back to a Gauss-Newton step where the distance is not locally convex
+            if (f_d <= Scalar(1e-12)) {
+                f_d = dp.squaredNorm();
+            }
+            if (f_d <= Scalar(1e-12)) {
+                break;
+            }
+
+            Scalar t_new = std::clamp(t - f / f_d, Scalar(0), Scalar(1));
+            bool converged = std::abs(t_new - t) < tol;
+            t = t_new;
+            if (converged) {
+                break;
+            }
+        }
+
+        eval_spline(coeffs_x, coeffs_y, spl, t, p, dp, ddp);
+        Vector2<Scalar> r = p - pos;
+        Scalar dist_sq = r.squaredNorm();
+
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best_spl = spl;
+            best_t = t;
+        }
+
+        // Continue on the neighbouring spline if the distance still decreases beyond the end of this one
+        Scalar f = r.dot(dp);
+        if (t >= 1 && f < 0 && (index.closed() || spl + 1 < no_splines)) {
+            spl = (spl + 1 < no_splines) ? spl + 1 : 0;
+            t = 0;
+        } else if (t <= 0 && f > 0 && (index.closed() || spl > 0)) {
+            spl = (spl > 0) ? spl - 1 : no_splines - 1;
+            t = 1;
+        } else {
+            break;
+        }
+    }
+
+    eval_spline(coeffs_x, coeffs_y, best_spl, best_t, p, dp, ddp);
+    Vector2<Scalar> r = pos - p;
+    Scalar cross = dp(0) * r(1) - dp(1) * r(0);
+
+    // Arc length: fraction of the spline length mapped onto the segment length of the index
+    const VectorX<Scalar>& s_points = index.sPoints();
+    Scalar spl_length = spline_length(coeffs_x, coeffs_y, best_spl, Scalar(1));
+    Scalar frac = (spl_length > Scalar(1e-12)) ? spline_length(coeffs_x, coeffs_y, best_spl, best_t) / spl_length : best_t;
+
+    PathMatch<Scalar> result;
+    result.index = best_spl;
+    result.t = best_t;
+    result.s = s_points(best_spl) + frac * (s_points(best_spl + 1) - s_points(best_spl));
+    result.d = (cross >= 0) ? r.norm() : -r.norm();
+    return result;
+}
+
+} // namespace
+
+template <typename Scalar>
+PathMatch<Scalar> path_matching_spline(
+    const Vector2<Scalar>& pos,
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const SegmentIndex<Scalar>& index,
+    int max_iter,
+    double tol) {
+
+    check_spline_inputs(coeffs_x, coeffs_y, index);
+    return match_spline(pos, coeffs_x, coeffs_y, index, max_iter, static_cast<Scalar>(tol));
+}
+
+template <typename Scalar>
+std::tuple<VectorX<Scalar>, VectorX<Scalar>> path_matching_spline(
+    const Matrix2XView<Scalar>& path,
+    const MatrixXView<Scalar>& coeffs_x,
+    const MatrixXView<Scalar>& coeffs_y,
+    const SegmentIndex<Scalar>& index,
+    int max_iter,
+    double tol,
+    int n_threads) {
+
+    check_spline_inputs(coeffs_x, coeffs_y, index);
+
+    int n_path_points = path.cols();
+    VectorX<Scalar> s_interp(n_path_points);
+    VectorX<Scalar> d_interp(n_path_points);
+
+    parallel_for(n_path_points, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            PathMatch<Scalar> match = match_spline<Scalar>(path.col(i), coeffs_x, coeffs_y, index, max_iter,
+                                                           static_cast<Scalar>(tol));
+            s_interp(i) = match.s;
+            d_interp(i) = match.d;
+        }
+    }, n_threads);
+
+    return std::make_tuple(s_interp, d_interp);
+}
+
+// Explicit instantiations
+template PathMatch<float> path_matching_spline<float>(
+    const Vector2<float>&, const MatrixXView<float>&, const MatrixXView<float>&, const SegmentIndex<float>&, int, double);
+template PathMatch<double> path_matching_spline<double>(
+    const Vector2<double>&, const MatrixXView<double>&, const MatrixXView<double>&, const SegmentIndex<double>&, int, double);
+template std::tuple<VectorX<float>, VectorX<float>> path_matching_spline<float>(
+    const Matrix2XView<float>&, const MatrixXView<float>&, const MatrixXView<float>&, const SegmentIndex<float>&,
+    int, double, int);
+template std::tuple<VectorX<double>, VectorX<double>> path_matching_spline<double>(
+    const Matrix2XView<double>&, const MatrixXView<double>&, const MatrixXView<double>&, const SegmentIndex<double>&,
+    int, double, int);
+
+} // namespace trajectory_planning_helpers
@@ -0,0 +1,240 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+namespace trajectory_planning_helpers {
+
+template <typename Scalar>
+SegmentIndex<Scalar>::SegmentIndex(const Matrix2XView<Scalar>& points, bool closed, double cell_size)
+    : points_(points), closed_(closed) {
+
+    int n_points = points_.cols();
+    if (n_points < 2) {
+        throw std::runtime_error("SegmentIndex requires at least two points!");
+    }
+
+    n_segments_ = closed_ ? n_points : n_points - 1;
+
+    // Arc length at the start of every segment (plus total length)
+    s_points_.resize(n_segments_ + 1);
+    s_points_(0) = 0;
+    double s_sum = 0.0;
+    for (int i = 0; i < n_segments_; ++i) {
+        s_sum += (points_.col(segmentEnd(i)) - points_.col(i)).norm();
+        s_points_(i + 1) = static_cast<Scalar>(s_sum);
+    }
+
+    // Grid geometry: about two mean segment lengths per cell, but never more than 16 cells per segment so that
+    // sparse reference lines spanning a large area do not allocate huge, mostly empty grids
+    Scalar x_max = points_.row(0).maxCoeff();
+    Scalar y_max = points_.row(1).maxCoeff();
+    x_min_ = points_.row(0).minCoeff();
+    y_min_ = points_.row(1).minCoeff();
+
+    double extent_x = std::max(static_cast<double>(x_max - x_min_), 1e-3);
+    double extent_y = std::max(static_cast<double>(y_max - y_min_), 1e-3);
+
+    if (cell_size <= 0.0) {
+        cell_size = 2.0 * s_sum / n_segments_;
+    }
+    cell_size = std::max({cell_size, std::sqrt(extent_x * extent_y / (16.0 * n_segments_)), 1e-3});
+    cell_size_ = static_cast<Scalar>(cell_size);
+
+    nx_ = static_cast<int>(extent_x / cell_size) + 1;
+    ny_ = static_cast<int>(extent_y / cell_size) + 1;
+
+    // Cell range covered by the bounding box of a segment
+    auto cellRange = [this](int seg_idx, int& cx0, int& cx1, int& cy0, int& cy1) {
+        const auto p1 = points_.col(seg_idx);
+        const auto p2 = points_.col(segmentEnd(seg_idx));
+        cx0 = std::clamp(static_cast<int>((std::min(p1(0), p2(0)) - x_min_) / cell_size_), 0, nx_ - 1);
+        cx1 = std::clamp(static_cast<int>((std::max(p1(0), p2(0)) - x_min_) / cell_size_), 0, nx_ - 1);
+        cy0 = std::clamp(static_cast<int>((std::min(p1(1), p2(1)) - y_min_) / cell_size_), 0, ny_ - 1);
+        cy1 = std::clamp(static_cast<int>((std::max(p1(1), p2(1)) - y_min_) / cell_size_), 0, ny_ - 1);
+    };
+
+    // Two passes (count, then fill) to store the per-cell segment lists in contiguous arrays
+    cell_start_.assign(static_cast<size_t>(nx_) * ny_ + 1, 0);
+
+    for (int i = 0; i < n_segments_; ++i) {
+        int cx0, cx1, cy0, cy1;
+        cellRange(i, cx0, cx1, cy0, cy1);
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                cell_start_[static_cast<size_t>(cy) * nx_ + cx + 1]++;
+            }
+        }
+    }
+
+    for (size_t c = 1; c < cell_start_.size(); ++c) {
+        cell_start_[c] += cell_start_[c - 1];
+    }
+
+    cell_segments_.resize(cell_start_.back());
+    std::vector<int> fill_pos(cell_start_.begin(), cell_start_.end() - 1);
+
+    for (int i = 0; i < n_segments_; ++i) {
+        int cx0, cx1, cy0, cy1;
+        cellRange(i, cx0, cx1, cy0, cy1);
+        for (int cy = cy0; cy <= cy1; ++cy) {
+            for (int cx = cx0; cx <= cx1; ++cx) {
+                cell_segments_[fill_pos[static_cast<size_t>(cy) * nx_ + cx]++] = i;
+            }
+        }
+    }
+}
+
+template <typename Scalar>
+PathMatch<Scalar> SegmentIndex<Scalar>::projectOnSegment(const Vector2<Scalar>& pos, int seg_idx) const {
+    const auto p1 = points_.col(seg_idx);
+    Vector2<Scalar> segment = points_.col(segmentEnd(seg_idx)) - p1;
+    Vector2<Scalar> to_point = pos - p1;
+
+    Scalar seg_length_sq = segment.squaredNorm();
+    Scalar t = 0;
+    if (seg_length_sq > Scalar(1e-12)) {
+        t = std::clamp(to_point.dot(segment) / seg_length_sq, Scalar(0), Scalar(1));
+    }
+
+    Vector2<Scalar> diff = to_point - t * segment;
+    Scalar dist = diff.norm();
+    Scalar cross = segment(0) * to_point(1) - segment(1) * to_point(0);
+
+    PathMatch<Scalar> result;
+    result.index = seg_idx;
+    result.t = t;
+    result.s = s_points_(seg_idx) + t * (s_points_(seg_idx + 1) - s_points_(seg_idx));
+    result.d = (cross >= 0) ? dist : -dist;
+    return result;
+}
+
+template <typename Scalar>
+PathMatch<Scalar> SegmentIndex<Scalar>::match(const Vector2<Scalar>& pos) const {
+    return projectOnSegment(pos, closestSegment(pos));
+}
+
+template <typename Scalar>
+int SegmentIndex<Scalar>::closestSegment(const Vector2<Scalar>& pos) const {
+    if (n_segments_ == 0) {
+        throw std::runtime_error("SegmentIndex is empty!");
+    }
+
+    if (!std::isfinite(pos(0)) || !std::isfinite(pos(1))) {
+        throw std::runtime_error("SegmentIndex cannot match a non-finite position!");
+    }
+
+    Scalar best_dist_sq = std::numeric_limits<Scalar>::max();
+    int best_seg = 0;
+
+    auto visitSegment = [&](int seg_idx) {
+        const auto p1 = points_.col(seg_idx);
+        Vector2<Scalar> segment = points_.col(segmentEnd(seg_idx)) - p1;
+        Vector2<Scalar> to_point = pos - p1;
+
+        Scalar seg_length_sq = segment.squaredNorm();
+        Scalar t = (seg_length_sq > Scalar(1e-12))
+            ? std::clamp(to_point.dot(segment) / seg_length_sq, Scalar(0), Scalar(1)) : Scalar(0);
+        Scalar dist_sq = (to_point - t * segment).squaredNorm();
+
+        if (dist_sq < best_dist_sq) {
+            best_dist_sq = dist_sq;
+            best_seg = seg_idx;
+        }
+    };
+
+    auto visitCell = [&](int x, int y) {
+        size_t c = static_cast<size_t>(y) * nx_ + x;
+        for (int k = cell_start_[c]; k < cell_start_[c + 1]; ++k) {
+            visitSegment(cell_segments_[k]);
+        }
+    };
+
+    // Query cell clamped to the grid, plus the distance of the query outside the grid along each axis
+    Scalar fx = (pos(0) - x_min_) / cell_size_;
+    Scalar fy = (pos(1) - y_min_) / cell_size_;
+    int cx = static_cast<int>(std::clamp(fx, Scalar(0), static_cast<Scalar>(nx_ - 1)));
+    int cy = static_cast<int>(std::clamp(fy, Scalar(0), static_cast<Scalar>(ny_ - 1)));
+    Scalar out_x = std::max({-fx, fx - nx_, Scalar(0)}) * cell_size_;
+    Scalar out_y = std::max({-fy, fy - ny_, Scalar(0)}) * cell_size_;
+
+    // Largest ring that still contains grid cells
+    int r_max = std::max({cx, nx_ - 1 - cx, cy, ny_ - 1 - cy});
+
+    // Search rings of cells around the query cell. Cells outside ring r are at least r * cell_size further away
+    // along x or y than the grid border on the side of the query
+    for (int r = 0; r <= r_max; ++r) {
+        int y0 = std::max(cy - r, 0);
+        int y1 = std::min(cy + r, ny_ - 1);
+
+        for (int y = y0; y <= y1; ++y) {
+            if (y == cy - r || y == cy + r) {
+                // Top or bottom row of the ring: all cells
+                for (int x = std::max(cx - r, 0); x <= std::min(cx + r, nx_ - 1); ++x) {
+                    visitCell(x, y);
+                }
+            } else {
+                // Side cells only
+                if (cx - r >= 0) {
+                    visitCell(cx - r, y);
+                }
+                if (r > 0 && cx + r < nx_) {
+                    visitCell(cx + r, y);
+                }
+            }
+        }
+
+        Scalar ring_dist = r * cell_size_;
+        Scalar bound_x = (ring_dist + out_x) * (ring_dist + out_x) + out_y * out_y;
+        Scalar bound_y = out_x * out_x + (ring_dist + out_y) * (ring_dist + out_y);
+        if (best_dist_sq <= std::min(bound_x, bound_y)) {
+            break;
+        }
+    }
+
+    return best_seg;
+}
+
+template <typename Scalar>
+SegmentIndex<Scalar> SegmentIndex<Scalar>::rotated(int offset) const {
+    if (!closed_) {
+        throw std::runtime_error("Only closed lines can be rotated!");
+    }
+
+    SegmentIndex result(*this);
+    int n = n_segments_;
+    offset = ((offset % n) + n) % n;
+    if (offset == 0) {
+        return result;
+    }
+
+    // Segment i of the rotated line is segment (i + offset) mod n of this one
+    result.points_.leftCols(n - offset) = points_.rightCols(n - offset);
+    result.points_.rightCols(offset) = points_.leftCols(offset);
+
+    Scalar s_offset = s_points_(offset);
+    Scalar length = s_points_(n);
+    result.s_points_.head(n - offset) = s_points_.segment(offset, n - offset).array() - s_offset;
+    result.s_points_.segment(n - offset, offset) = s_points_.head(offset).array() + (length - s_offset);
+    result.s_points_(n) = length;
+
+    // Renumber the cell lists and restore their ascending order (same tie-breaking as a rebuilt grid)
+    for (size_t c = 0; c + 1 < cell_start_.size(); ++c) {
+        auto first = result.cell_segments_.begin() + cell_start_[c];
+        auto last = result.cell_segments_.begin() + cell_start_[c + 1];
+        auto wrapped = std::lower_bound(first, last, offset);
+        for (auto it = first; it != last; ++it) {
+            *it = (*it - offset + n) % n;
+        }
+        std::rotate(first, wrapped, last);
+    }
+
+    return result;
+}
+
+// Explicit instantiations
+template class SegmentIndex<float>;
+template class SegmentIndex<double>;
+
+} // namespace trajectory_planning_helpers
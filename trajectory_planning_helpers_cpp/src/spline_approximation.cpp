@@ -1,11 +1,13 @@
 #include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 namespace trajectory_planning_helpers {
 
-std::tuple<MatrixXd, VectorXd> spline_approximation(
-    const Matrix2Xd& track,
+template <typename Scalar>
+std::tuple<MatrixX<Scalar>, VectorX<Scalar>> spline_approximation(
+    const MatrixXView<Scalar>& track,
     int k_reg,
     double s_reg,
     int stepsize_prep,
@@ -15,50 +17,47 @@ std::tuple<MatrixXd, VectorXd> spline_approximation(
     // Simplified and fast spline approximation implementation
     // This uses linear interpolation and resampling for performance
     
+    if (track.rows() < 2) {
+        throw std::runtime_error("Track must contain at least x and y rows!");
+    }
+    
     int n_points = track.cols();
+    int n_channels = track.rows();
     
-    // Calculate cumulative distances
-    VectorXd el_lengths_orig(n_points - 1);
+    // Calculate cumulative distances (based on x and y only)
+    VectorX<Scalar> el_lengths_orig(n_points - 1);
     for (int i = 0; i < n_points - 1; ++i) {
-        el_lengths_orig(i) = (track.col(i + 1) - track.col(i)).norm();
+        el_lengths_orig(i) = (track.template block<2, 1>(0, i + 1) - track.template block<2, 1>(0, i)).norm();
     }
     
     // Calculate total track length
-    double total_length = el_lengths_orig.sum();
+    double total_length = el_lengths_orig.template cast<double>().sum();
     
     // Determine number of output points based on desired stepsize
     double effective_stepsize = stepsize_reg;  // Use parameter from config
     int n_out = std::max(10, static_cast<int>(std::ceil(total_length / effective_stepsize)));
     
     // Create uniform spacing
-    VectorXd s_uniform = VectorXd::LinSpaced(n_out, 0.0, total_length);
+    Eigen::VectorX<Scalar> s_uniform = Eigen::VectorX<Scalar>::LinSpaced(n_out, 0.0, total_length);
     
     // Calculate cumulative distances for original track
-    VectorXd s_orig(n_points);
+    Eigen::VectorX<Scalar> s_orig(n_points);
     s_orig(0) = 0.0;
     for (int i = 1; i < n_points; ++i) {
         s_orig(i) = s_orig(i-1) + el_lengths_orig(i-1);
     }
     
-    // Interpolate track points to uniform spacing
-    MatrixXd track_out(n_out, 2);
+    // Interpolate all channels (x, y, track widths and any further per-point data) to uniform spacing in a
+    // single sweep: s_uniform is sorted, so the segment index only ever moves forward
+    MatrixX<Scalar> track_out(n_out, n_channels);
+    int seg_idx = 0;
     
     for (int i = 0; i < n_out; ++i) {
         double s_target = s_uniform(i);
         
-        // Find the segment containing s_target
-        int seg_idx = 0;
-        for (int j = 1; j < n_points; ++j) {
-            if (s_orig(j) > s_target) {
-                seg_idx = j - 1;
-                break;
-            }
-            seg_idx = j;
-        }
-        
-        // Handle edge case
-        if (seg_idx >= n_points - 1) {
-            seg_idx = n_points - 2;
+        // Advance to the segment containing s_target
+        while (seg_idx < n_points - 2 && s_orig(seg_idx + 1) <= s_target) {
+            ++seg_idx;
         }
         
         // Linear interpolation within the segment
@@ -67,15 +66,14 @@ std::tuple<MatrixXd, VectorXd> spline_approximation(
         double t = (seg_length > 1e-10) ? (local_s / seg_length) : 0.0;
         t = std::max(0.0, std::min(1.0, t)); // Clamp to [0,1]
         
-        // Interpolate x and y
-        track_out(i, 0) = (1.0 - t) * track(0, seg_idx) + t * track(0, seg_idx + 1);
-        track_out(i, 1) = (1.0 - t) * track(1, seg_idx) + t * track(1, seg_idx + 1);
+        Scalar w = static_cast<Scalar>(t);
+        track_out.row(i) = ((Scalar(1.0) - w) * track.col(seg_idx) + w * track.col(seg_idx + 1)).transpose();
     }
     
     // Calculate element lengths for output track
-    VectorXd el_lengths_out(n_out - 1);
+    VectorX<Scalar> el_lengths_out(n_out - 1);
     for (int i = 0; i < n_out - 1; ++i) {
-        el_lengths_out(i) = (track_out.row(i + 1) - track_out.row(i)).norm();
+        el_lengths_out(i) = (track_out.template block<1, 2>(i + 1, 0) - track_out.template block<1, 2>(i, 0)).norm();
     }
     
     if (debug) {
@@ -86,4 +84,10 @@ std::tuple<MatrixXd, VectorXd> spline_approximation(
     return std::make_tuple(track_out, el_lengths_out);
 }
 
-} // namespace trajectory_planning_helpers
\ No newline at end of file
+// Explicit instantiations
+template std::tuple<MatrixX<float>, VectorX<float>> spline_approximation<float>(
+    const MatrixXView<float>&, int, double, int, double, bool);
+template std::tuple<MatrixX<double>, VectorX<double>> spline_approximation<double>(
+    const MatrixXView<double>&, int, double, int, double, bool);
+
+} // namespace trajectory_planning_helpers
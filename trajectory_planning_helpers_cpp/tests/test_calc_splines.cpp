@@ -0,0 +1,170 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+// Closed circle with the first point repeated at the end, points unevenly spaced
+Matrix2Xd circle(int n, double radius) {
+    Matrix2Xd path(2, n + 1);
+    for (int i = 0; i <= n; ++i) {
+        double phi = 2.0 * M_PI * (i % n) / n + ((i % n) % 2 == 0 ? 0.0 : 0.3 * M_PI / n);
+        path(0, i) = radius * std::cos(phi);
+        path(1, i) = radius * std::sin(phi);
+    }
+    return path;
+}
+
+VectorXd elementLengths(const Matrix2Xd& path) {
+    VectorXd el_lengths(path.cols() - 1);
+    for (int i = 0; i < el_lengths.size(); ++i) {
+        el_lengths(i) = (path.col(i + 1) - path.col(i)).norm();
+    }
+    return el_lengths;
+}
+
+double value(const MatrixXd& coeffs, int i, double t) {
+    return coeffs(i, 0) + coeffs(i, 1) * t + coeffs(i, 2) * t * t + coeffs(i, 3) * t * t * t;
+}
+
+double derivative(const MatrixXd& coeffs, int i, double t) {
+    return coeffs(i, 1) + 2.0 * coeffs(i, 2) * t + 3.0 * coeffs(i, 3) * t * t;
+}
+
+double secondDerivative(const MatrixXd& coeffs, int i, double t) {
+    return 2.0 * coeffs(i, 2) + 6.0 * coeffs(i, 3) * t;
+}
+
+} // namespace
+
+TEST(CalcSplines, ClosedSplinesInterpolateWithContinuousDerivatives) {
+    Matrix2Xd path = circle(60, 50.0);
+    VectorXd el_lengths = elementLengths(path);
+    auto [coeffs_x, coeffs_y, a_interp, normvec] = calc_splines(path, el_lengths);
+    
+    int n = coeffs_x.rows();
+    ASSERT_EQ(n, 60);
+    for (int i = 0; i < n; ++i) {
+        int next = (i + 1) % n;
+        EXPECT_NEAR(value(coeffs_x, i, 0.0), path(0, i), 1e-9);
+        EXPECT_NEAR(value(coeffs_y, i, 1.0), path(1, i + 1), 1e-9);
+        
+        // Derivatives with respect to the arc length match across every point, including the closing one
+        double scale = el_lengths(i) / el_lengths(next);
+        EXPECT_NEAR(derivative(coeffs_x, i, 1.0), scale * derivative(coeffs_x, next, 0.0), 1e-9);
+        EXPECT_NEAR(secondDerivative(coeffs_y, i, 1.0), scale * scale * secondDerivative(coeffs_y, next, 0.0), 1e-9);
+    }
+    
+    // Normal vectors point to the left of the driving direction, i.e. to the center of a counterclockwise circle
+    for (int i = 0; i < n; ++i) {
+        EXPECT_NEAR(normvec.row(i).norm(), 1.0, 1e-12);
+        EXPECT_LT(normvec.row(i).dot(path.col(i).transpose()), -0.99 * 50.0);
+    }
+}
+
+TEST(CalcSplines, AnalyticCurvatureOfCircle) {
+    double radius = 50.0;
+    Matrix2Xd path = circle(120, radius);
+    auto [coeffs_x, coeffs_y, a_interp, normvec] = calc_splines(path, elementLengths(path));
+    
+    // Points and midpoints of all splines
+    int n = coeffs_x.rows();
+    VectorXd ind(2 * n), t(2 * n);
+    for (int i = 0; i < n; ++i) {
+        ind(2 * i) = ind(2 * i + 1) = i;
+        t(2 * i) = 0.0;
+        t(2 * i + 1) = 0.5;
+    }
+    auto [psi, kappa] = calc_head_curv_an(coeffs_x, coeffs_y, ind, t);
+    
+    EXPECT_LT((kappa.array() - 1.0 / radius).abs().maxCoeff(), 1e-3 / radius);
+    
+    // Heading (0 = north) of a counterclockwise circle at angle phi is phi
+    for (int i = 0; i < n; ++i) {
+        double phi = std::atan2(path(1, i), path(0, i));
+        EXPECT_NEAR(normalize_psi(psi(2 * i) - phi), 0.0, 1e-4);
+    }
+}
+
+TEST(CalcSplines, OpenSplinesFollowGivenHeadings) {
+    Matrix2Xd path(2, 4);
+    path << 0.0, 10.0, 20.0, 30.0,
+            0.0, 5.0, 5.0, 0.0;
+    double psi_s = -0.3;
+    double psi_e = -2.5;
+    auto [coeffs_x, coeffs_y, a_interp, normvec] = calc_splines(path, elementLengths(path), psi_s, psi_e);
+    
+    VectorXd ind(2), t(2);
+    ind << 0, 2;
+    t << 0.0, 1.0;
+    auto [psi, kappa] = calc_head_curv_an(coeffs_x, coeffs_y, ind, t);
+    EXPECT_NEAR(psi(0), psi_s, 1e-12);
+    EXPECT_NEAR(psi(1), psi_e, 1e-12);
+    EXPECT_NEAR(value(coeffs_x, 2, 1.0), 30.0, 1e-12);
+}
+
+TEST(CalcSplines, OpenSplinesRequireHeadings) {
+    Matrix2Xd path(2, 3);
+    path << 0.0, 1.0, 2.0,
+            0.0, 1.0, 0.0;
+    EXPECT_THROW(calc_splines(path), std::runtime_error);
+}
+
+TEST(CalcSplines, FloatAgreesWithDouble) {
+    Matrix2Xd path = circle(40, 20.0);
+    VectorXd el_lengths = elementLengths(path);
+    auto [coeffs_x, coeffs_y, a_interp, normvec] = calc_splines(path, el_lengths);
+    
+    Matrix2Xf path_f = path.cast<float>();
+    VectorXf el_lengths_f = el_lengths.cast<float>();
+    auto [coeffs_x_f, coeffs_y_f, a_interp_f, normvec_f] = calc_splines<float>(path_f, el_lengths_f);
+    
+    EXPECT_LT((coeffs_x_f.cast<double>() - coeffs_x).cwiseAbs().maxCoeff(), 1e-3);
+    EXPECT_LT((normvec_f.cast<double>() - normvec).cwiseAbs().maxCoeff(), 1e-4);
+}
+
+TEST(CalcSplines, CoefficientsSolveTheSparseSystem) {
+    // Coefficients of all splines stacked [a_0, b_0, c_0, d_0, a_1, ...]
+    auto stacked = [](const MatrixXd& coeffs) {
+        VectorXd c(4 * coeffs.rows());
+        for (int i = 0; i < coeffs.rows(); ++i) {
+            c.segment<4>(4 * i) = coeffs.row(i).transpose();
+        }
+        return c;
+    };
+    
+    // Closed: start and end points, all continuity rows (including the closing ones) are zero
+    Matrix2Xd path = circle(60, 50.0);
+    auto [coeffs_x, coeffs_y, a_interp, normvec] = calc_splines(path, elementLengths(path));
+    ASSERT_EQ(a_interp.rows(), 4 * 60);
+    ASSERT_EQ(a_interp.cols(), 4 * 60);
+    EXPECT_LE(a_interp.nonZeros(), 12 * 60);
+    
+    for (int c = 0; c < 2; ++c) {
+        VectorXd b = VectorXd::Zero(4 * 60);
+        for (int i = 0; i < 60; ++i) {
+            b(4 * i) = path(c, i);
+            b(4 * i + 1) = path(c, i + 1);
+        }
+        VectorXd residual = a_interp * stacked(c == 0 ? coeffs_x : coeffs_y) - b;
+        EXPECT_LT(residual.cwiseAbs().maxCoeff(), 1e-9);
+    }
+    
+    // Open: the last two rows hold the start and end derivatives
+    Matrix2Xd open_path(2, 4);
+    open_path << 0.0, 10.0, 20.0, 30.0,
+                 0.0, 5.0, 5.0, 0.0;
+    auto [open_x, open_y, open_a, open_normvec] = calc_splines(open_path, elementLengths(open_path), -0.3, -2.5);
+    ASSERT_EQ(open_a.rows(), 12);
+    
+    VectorXd b = VectorXd::Zero(12);
+    for (int i = 0; i < 3; ++i) {
+        b(4 * i) = open_path(0, i);
+        b(4 * i + 1) = open_path(0, i + 1);
+    }
+    b(10) = derivative(open_x, 0, 0.0);
+    b(11) = derivative(open_x, 2, 1.0);
+    EXPECT_LT((open_a * stacked(open_x) - b).cwiseAbs().maxCoeff(), 1e-9);
+}
@@ -0,0 +1,66 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+Matrix2Xd testTrack(int n) {
+    Matrix2Xd track(2, n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        track(0, i) = 120.0 * std::cos(a) + 10.0 * std::cos(3.0 * a);
+        track(1, i) = 70.0 * std::sin(a);
+    }
+    return track;
+}
+
+} // namespace
+
+TEST(FrenetFrame, AgreesWithSegmentIndexMatch) {
+    Matrix2Xd track = testTrack(800);
+    FrenetFrame<double> frame(track, true);
+    
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> coord(-160.0, 160.0);
+    for (int k = 0; k < 1000; ++k) {
+        Vector2d pos(coord(rng), coord(rng));
+        PathMatch<double> match = frame.index().match(pos);
+        Vector2d sd = frame.toFrenet(pos);
+        EXPECT_NEAR(sd(0), match.s, 1e-9);
+        EXPECT_NEAR(sd(1), match.d, 1e-9);
+    }
+}
+
+TEST(FrenetFrame, RoundTripNearTheLine) {
+    Matrix2Xd track = testTrack(800);
+    FrenetFrame<double> frame(track, true);
+    
+    Matrix2Xd frenet(2, 500);
+    for (int k = 0; k < frenet.cols(); ++k) {
+        frenet(0, k) = frame.length() * (k + 0.5) / frenet.cols();
+        frenet(1, k) = 0.2 * std::sin(0.3 * k);
+    }
+    
+    Matrix2Xd positions = frame.toCartesian(frenet);
+    Matrix2Xd back = frame.toFrenet(positions);
+    for (int k = 0; k < frenet.cols(); ++k) {
+        EXPECT_NEAR(back(0, k), frenet(0, k), 1e-6);
+        EXPECT_NEAR(back(1, k), frenet(1, k), 1e-6);
+    }
+}
+
+TEST(FrenetFrame, BatchMatchesSingleConversion) {
+    Matrix2Xd track = testTrack(300);
+    FrenetFrame<double> frame(track, true);
+    
+    Matrix2Xd positions = 1.05 * track;
+    Matrix2Xd frenet = frame.toFrenet(positions, 4);
+    for (int k = 0; k < positions.cols(); ++k) {
+        Vector2d sd = frame.toFrenet(Vector2d(positions.col(k)));
+        EXPECT_EQ(frenet(0, k), sd(0));
+        EXPECT_EQ(frenet(1, k), sd(1));
+    }
+}
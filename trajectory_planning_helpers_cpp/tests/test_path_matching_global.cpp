@@ -0,0 +1,73 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+// Ellipse with slightly uneven spacing, one point per column
+Matrix2Xd testTrack(int n) {
+    Matrix2Xd track(2, n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * (i + 0.3 * std::sin(0.1 * i)) / n;
+        track(0, i) = 80.0 * std::cos(a);
+        track(1, i) = 50.0 * std::sin(a);
+    }
+    return track;
+}
+
+VectorXd chordLengths(const Matrix2Xd& track) {
+    return (track.rightCols(track.cols() - 1) - track.leftCols(track.cols() - 1)).colwise().norm().transpose();
+}
+
+} // namespace
+
+TEST(PathMatchingGlobal, ReturnsArcLengthOfClosestPoint) {
+    Matrix2Xd track = testTrack(500);
+    VectorXd el_lengths = chordLengths(track);
+    
+    Matrix2Xd path(2, 50);
+    for (int k = 0; k < path.cols(); ++k) {
+        int i = (k * 37) % track.cols();
+        path.col(k) = track.col(i) + Vector2d(0.01, -0.02);
+    }
+    
+    VectorXd s = path_matching_global<double>(path, track, el_lengths);
+    for (int k = 0; k < path.cols(); ++k) {
+        int i = (k * 37) % track.cols();
+        EXPECT_NEAR(s(k), el_lengths.head(i).sum(), 1e-9);
+    }
+}
+
+TEST(PathMatchingGlobal, NonFinitePointsMatchTheFirstPoint) {
+    Matrix2Xd track = testTrack(500);
+    VectorXd el_lengths = chordLengths(track);
+    
+    Matrix2Xd path(2, 3);
+    path.col(0) << std::nan(""), 0.0;
+    path.col(1) << 0.0, INFINITY;
+    path.col(2) = track.col(100);
+    
+    VectorXd s = path_matching_global<double>(path, track, el_lengths);
+    EXPECT_EQ(s(0), 0.0);
+    EXPECT_EQ(s(1), 0.0);
+    EXPECT_NEAR(s(2), el_lengths.head(100).sum(), 1e-9);
+}
+
+TEST(CalcHeadCurvNum, FloatMatchesDouble) {
+    Matrix2Xd track = testTrack(2000);
+    VectorXd el_lengths(track.cols());
+    el_lengths.head(track.cols() - 1) = chordLengths(track);
+    el_lengths(track.cols() - 1) = (track.col(0) - track.col(track.cols() - 1)).norm();
+    
+    auto [psi, kappa] = calc_head_curv_num<double>(track, el_lengths, true);
+    Matrix2Xf track_f = track.cast<float>();
+    VectorXf el_lengths_f = el_lengths.cast<float>();
+    auto [psi_f, kappa_f] = calc_head_curv_num<float>(track_f, el_lengths_f, true);
+    
+    for (int i = 0; i < track.cols(); ++i) {
+        EXPECT_NEAR(std::abs(normalize_psi(psi_f(i) - static_cast<float>(psi(i)))), 0.0f, 1e-4f);
+        EXPECT_NEAR(kappa_f(i), kappa(i), 1e-4);
+    }
+}
@@ -0,0 +1,113 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+// Circle of radius 100 m, one point per column
+Matrix2Xd circle(int n) {
+    Matrix2Xd points(2, n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        points.col(i) << 100.0 * std::cos(a), 100.0 * std::sin(a);
+    }
+    return points;
+}
+
+Vector2d onCircle(double s, double d) {
+    double a = s / 100.0;
+    return (100.0 - d) * Vector2d(std::cos(a), std::sin(a));
+}
+
+// Hairpin loop: two straights 1 m apart (y = 0 outbound, y = 1 back), joined by half circles
+Matrix2Xd hairpin() {
+    Matrix2Xd points(2, 220);
+    int k = 0;
+    for (int i = 0; i < 100; ++i) {
+        points.col(k++) << i, 0.0;
+    }
+    for (int i = 0; i < 10; ++i) {
+        double a = -0.5 * M_PI + M_PI * i / 10;
+        points.col(k++) << 100.0 + 0.5 * std::cos(a), 0.5 + 0.5 * std::sin(a);
+    }
+    for (int i = 0; i < 100; ++i) {
+        points.col(k++) << 100.0 - i, 1.0;
+    }
+    for (int i = 0; i < 10; ++i) {
+        double a = 0.5 * M_PI + M_PI * i / 10;
+        points.col(k++) << 0.5 * std::cos(a), 0.5 + 0.5 * std::sin(a);
+    }
+    return points;
+}
+
+} // namespace
+
+TEST(PathMatchingLocal, TracksAcrossStartFinishInBothDirections) {
+    SegmentIndex<double> index(circle(200));
+    double length = index.length();
+    
+    // Forward over the line, 2 m per step
+    PathMatch<double> match = index.match(onCircle(length - 9.0, 0.5));
+    for (double s = length - 7.0; s < length + 10.0; s += 2.0) {
+        match = path_matching_local<double>(onCircle(s, 0.5), index, match, 5.0, 3);
+        PathMatch<double> global = index.match(onCircle(s, 0.5));
+        EXPECT_EQ(match.index, global.index);
+        EXPECT_NEAR(match.s, global.s, 1e-9);
+        EXPECT_NEAR(match.d, global.d, 1e-9);
+    }
+    EXPECT_LT(match.s, 10.0);
+    
+    // And back
+    for (double s = 8.0; s > -10.0; s -= 2.0) {
+        match = path_matching_local<double>(onCircle(s, -0.3), index, match, 5.0, 3);
+        PathMatch<double> global = index.match(onCircle(s, -0.3));
+        EXPECT_EQ(match.index, global.index);
+        EXPECT_NEAR(match.s, global.s, 1e-9);
+    }
+    EXPECT_GT(match.s, length - 10.0);
+}
+
+TEST(PathMatchingLocal, SearchStaysWithinTheReach) {
+    SegmentIndex<double> index(hairpin());
+    
+    // Closer to the return straight, but only the outbound one is within the distance travelled
+    PathMatch<double> last = index.match(Vector2d(50.1, 0.1));
+    ASSERT_EQ(last.index, 50);
+    Vector2d pos(50.4, 0.6);
+    
+    PathMatch<double> local = path_matching_local<double>(pos, index, last, 0.1);
+    EXPECT_EQ(local.index, 50);
+    EXPECT_NEAR(local.s, 50.4, 1e-9);
+    EXPECT_NEAR(std::abs(local.d), 0.6, 1e-9);
+    
+    PathMatch<double> global = index.match(pos);
+    EXPECT_GT(global.index, 110);
+    EXPECT_NEAR(std::abs(global.d), 0.4, 1e-9);
+}
+
+TEST(PathMatchingLocal, JumpBeyondMaxSegmentsFallsBackToGlobalMatch) {
+    SegmentIndex<double> index(circle(200));
+    PathMatch<double> last = index.match(onCircle(7.0, 0.0));
+    
+    // Within max_segments the local search follows
+    PathMatch<double> near = path_matching_local<double>(onCircle(20.0, 0.2), index, last, 1.0, 5);
+    EXPECT_NEAR(near.s, 20.0, 0.05);
+    
+    // A 100 m jump needs about 32 segments, the lock is lost and the global match is returned
+    Vector2d far = onCircle(107.0, 0.2);
+    PathMatch<double> jumped = path_matching_local<double>(far, index, last, 1.0, 5);
+    PathMatch<double> global = index.match(far);
+    EXPECT_EQ(jumped.index, global.index);
+    EXPECT_NEAR(jumped.s, global.s, 1e-9);
+    EXPECT_NEAR(jumped.d, global.d, 1e-9);
+    EXPECT_LT(std::abs(jumped.d), 1.0);
+}
+
+TEST(PathMatchingLocal, RejectsForeignLastMatch) {
+    SegmentIndex<double> index(circle(50));
+    PathMatch<double> last;
+    last.index = 50;
+    EXPECT_THROW(path_matching_local<double>(Vector2d(100.0, 0.0), index, last), std::runtime_error);
+}
@@ -0,0 +1,134 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+constexpr double RADIUS = 100.0;
+constexpr int N_POINTS = 210;  // about 3 m spacing
+
+// Closed circle with splines through its points, the segment index over the same points
+class PathMatchingSplineTest : public testing::Test {
+protected:
+    Matrix2Xd points_{2, N_POINTS};
+    MatrixXd coeffs_x_, coeffs_y_;
+    SegmentIndex<double> index_;
+    
+    void SetUp() override {
+        Matrix2Xd path(2, N_POINTS + 1);
+        for (int i = 0; i <= N_POINTS; ++i) {
+            path.col(i) = onCircle(angle(i % N_POINTS), 0.0);
+        }
+        points_ = path.leftCols(N_POINTS);
+        
+        VectorXd el_lengths = (path.rightCols(N_POINTS) - path.leftCols(N_POINTS)).colwise().norm().transpose();
+        Eigen::SparseMatrix<double> a_interp;
+        MatrixXd normvectors;
+        std::tie(coeffs_x_, coeffs_y_, a_interp, normvectors) = calc_splines<double>(path, el_lengths);
+        index_ = SegmentIndex<double>(points_);
+    }
+    
+    static double angle(double i) {
+        return 2.0 * M_PI * i / N_POINTS;
+    }
+    
+    // Point at angle a, d to the left (towards the centre)
+    static Vector2d onCircle(double a, double d) {
+        return (RADIUS - d) * Vector2d(std::cos(a), std::sin(a));
+    }
+    
+    // Index arc length of the point at angle a: segment start plus the angle fraction of the segment
+    double expectedS(double a) const {
+        double i = a / angle(1.0);
+        int seg = static_cast<int>(std::floor(i)) % N_POINTS;
+        return index_.sPoints()(seg) + (i - std::floor(i)) * (index_.sPoints()(seg + 1) - index_.sPoints()(seg));
+    }
+    
+    PathMatch<double> match(const Vector2d& pos) const {
+        return path_matching_spline<double>(pos, coeffs_x_, coeffs_y_, index_);
+    }
+};
+
+} // namespace
+
+TEST_F(PathMatchingSplineTest, MatchesTheCircleAnalytically) {
+    double max_err_s = 0.0, max_err_d = 0.0, max_err_s_polyline = 0.0;
+    
+    for (int k = 0; k < 97; ++k) {
+        double a = angle(0.37 + 2.13 * k);
+        double d = 2.0 * std::sin(0.7 * k);
+        Vector2d pos = onCircle(a, d);
+        
+        PathMatch<double> result = match(pos);
+        max_err_s = std::max(max_err_s, std::abs(result.s - expectedS(a)));
+        max_err_d = std::max(max_err_d, std::abs(result.d - d));
+        max_err_s_polyline = std::max(max_err_s_polyline, std::abs(index_.match(pos).s - expectedS(a)));
+    }
+    
+    EXPECT_LT(max_err_s, 1e-4);
+    EXPECT_LT(max_err_d, 1e-4);
+    
+    // The polyline projection is off by centimetres for the same points
+    EXPECT_GT(max_err_s_polyline, 1e-2);
+}
+
+TEST_F(PathMatchingSplineTest, MovesToTheNeighbouringSpline) {
+    // Outside the circle close to a point, the polyline match is the shared corner of two segments, the Newton
+    // iteration ends at t = 0 or 1 and continues on the neighbouring spline
+    for (int i = 5; i < N_POINTS; i += 40) {
+        for (double frac : {-0.05, 0.05}) {
+            double a = angle(i + frac);
+            PathMatch<double> seed = index_.match(onCircle(a, -20.0));
+            ASSERT_TRUE(seed.t <= 0.0 || seed.t >= 1.0);
+            
+            PathMatch<double> result = match(onCircle(a, -20.0));
+            
+            EXPECT_EQ(result.index, frac < 0 ? i - 1 : i);
+            EXPECT_NEAR(result.t, frac < 0 ? 0.95 : 0.05, 1e-3);
+            EXPECT_NEAR(result.s, expectedS(a), 1e-4);
+            EXPECT_NEAR(result.d, -20.0, 1e-4);
+        }
+    }
+}
+
+TEST_F(PathMatchingSplineTest, WrapsAtTheClosingSpline) {
+    double length = index_.length();
+    
+    PathMatch<double> before = match(onCircle(angle(-0.05), -20.0));
+    EXPECT_EQ(before.index, N_POINTS - 1);
+    EXPECT_NEAR(before.s, length - expectedS(angle(0.05)), 1e-4);
+    
+    PathMatch<double> after = match(onCircle(angle(0.05), -20.0));
+    EXPECT_EQ(after.index, 0);
+    EXPECT_NEAR(after.s, expectedS(angle(0.05)), 1e-4);
+    
+    // On the first point itself
+    PathMatch<double> at_start = match(onCircle(0.0, 1.0));
+    EXPECT_TRUE(at_start.s < 1e-6 || at_start.s > length - 1e-6);
+    EXPECT_NEAR(at_start.d, 1.0, 1e-6);
+}
+
+TEST_F(PathMatchingSplineTest, BatchMatchesScalar) {
+    Matrix2Xd path(2, 500);
+    for (int k = 0; k < path.cols(); ++k) {
+        path.col(k) = onCircle(angle(0.41 * k), 3.0 * std::cos(0.3 * k));
+    }
+    
+    auto [s, d] = path_matching_spline<double>(path, coeffs_x_, coeffs_y_, index_, 5, 1e-6, 4);
+    ASSERT_EQ(s.size(), path.cols());
+    for (int k = 0; k < path.cols(); ++k) {
+        PathMatch<double> result = match(path.col(k));
+        EXPECT_EQ(s(k), result.s);
+        EXPECT_EQ(d(k), result.d);
+    }
+}
+
+TEST_F(PathMatchingSplineTest, RejectsMismatchedInputs) {
+    SegmentIndex<double> other(points_.leftCols(N_POINTS - 1));
+    EXPECT_THROW(path_matching_spline<double>(Vector2d(0.0, 0.0), coeffs_x_, coeffs_y_, other), std::runtime_error);
+    
+    MatrixXd three_cols = coeffs_x_.leftCols(3);
+    EXPECT_THROW(path_matching_spline<double>(Vector2d(0.0, 0.0), three_cols, coeffs_y_, index_), std::runtime_error);
+}
@@ -0,0 +1,111 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+// Closed wavy loop, one point per column
+Matrix2Xd testTrack(int n) {
+    Matrix2Xd track(2, n);
+    for (int i = 0; i < n; ++i) {
+        double a = 2.0 * M_PI * i / n;
+        double r = 100.0 + 15.0 * std::sin(5.0 * a);
+        track(0, i) = r * std::cos(a);
+        track(1, i) = 0.6 * r * std::sin(a);
+    }
+    return track;
+}
+
+// Distance to the closest segment by checking all of them
+double bruteForceDistance(const SegmentIndex<double>& index, const Vector2d& pos) {
+    double best = std::numeric_limits<double>::max();
+    for (int i = 0; i < index.numSegments(); ++i) {
+        best = std::min(best, std::abs(index.projectOnSegment(pos, i).d));
+    }
+    return best;
+}
+
+} // namespace
+
+TEST(SegmentIndex, AgreesWithBruteForce) {
+    Matrix2Xd track = testTrack(1000);
+    SegmentIndex<double> index(track, true);
+    
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(-150.0, 150.0);
+    for (int k = 0; k < 2000; ++k) {
+        Vector2d pos(coord(rng), coord(rng));
+        PathMatch<double> match = index.match(pos);
+        EXPECT_NEAR(std::abs(match.d), bruteForceDistance(index, pos), 1e-9);
+    }
+}
+
+TEST(SegmentIndex, FarQueriesAgreeWithBruteForce) {
+    Matrix2Xd track = testTrack(1000);
+    SegmentIndex<double> index(track, true);
+    
+    const Vector2d far_positions[] = {{1e4, 0.0}, {-3e5, 2e5}, {0.0, -1e7}, {1e12, 1e12}, {-1e150, 5.0}};
+    for (const Vector2d& pos : far_positions) {
+        PathMatch<double> match = index.match(pos);
+        double expected = bruteForceDistance(index, pos);
+        EXPECT_NEAR(std::abs(match.d), expected, 1e-9 * expected);
+    }
+}
+
+TEST(SegmentIndex, RejectsNonFinitePositions) {
+    Matrix2Xd track = testTrack(100);
+    SegmentIndex<double> index(track, true);
+    
+    EXPECT_THROW(index.match(Vector2d(std::nan(""), 0.0)), std::runtime_error);
+    EXPECT_THROW(index.match(Vector2d(0.0, -INFINITY)), std::runtime_error);
+}
+
+TEST(SegmentIndex, MatchesPointsOnOpenLine) {
+    Matrix2Xd line(2, 3);
+    line << 0.0, 10.0, 10.0,
+            0.0, 0.0, 10.0;
+    SegmentIndex<double> index(line, false);
+    
+    PathMatch<double> match = index.match(Vector2d(4.0, 1.0));
+    EXPECT_EQ(match.index, 0);
+    EXPECT_NEAR(match.s, 4.0, 1e-12);
+    EXPECT_NEAR(match.d, 1.0, 1e-12);
+    
+    match = index.match(Vector2d(12.0, 5.0));
+    EXPECT_EQ(match.index, 1);
+    EXPECT_NEAR(match.s, 15.0, 1e-12);
+    EXPECT_NEAR(match.d, -2.0, 1e-12);
+    EXPECT_NEAR(index.length(), 20.0, 1e-12);
+}
+
+TEST(SegmentIndex, RotatedMatchesRebuiltIndex) {
+    Matrix2Xd track = testTrack(500);
+    SegmentIndex<double> index(track, true);
+    
+    for (int offset : {0, 1, 137, 499, -3}) {
+        int shift = (offset + 500) % 500;
+        Matrix2Xd rotated_track(2, 500);
+        rotated_track << track.rightCols(500 - shift), track.leftCols(shift);
+        SegmentIndex<double> rebuilt(rotated_track, true);
+        SegmentIndex<double> rotated = index.rotated(offset);
+        
+        EXPECT_EQ(rotated.points(), rebuilt.points());
+        EXPECT_LT((rotated.sPoints() - rebuilt.sPoints()).cwiseAbs().maxCoeff(), 1e-9);
+        
+        for (int k = 0; k < 300; ++k) {
+            Vector2d pos(60.0 * std::cos(0.7 * k) - 5.0, 40.0 * std::sin(1.3 * k) + 3.0);
+            PathMatch<double> a = rotated.match(pos);
+            PathMatch<double> b = rebuilt.match(pos);
+            EXPECT_EQ(a.index, b.index);
+            EXPECT_NEAR(a.s, b.s, 1e-9);
+            EXPECT_NEAR(a.d, b.d, 1e-9);
+        }
+    }
+    
+    Matrix2Xd line = track.leftCols(10);
+    EXPECT_THROW(SegmentIndex<double>(line, false).rotated(2), std::runtime_error);
+}
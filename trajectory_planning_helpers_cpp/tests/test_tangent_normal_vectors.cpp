@@ -0,0 +1,70 @@
+#include "trajectory_planning_helpers/trajectory_planning_helpers.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace trajectory_planning_helpers;
+
+namespace {
+
+VectorXd testHeadings(int n) {
+    VectorXd psi(n);
+    for (int i = 0; i < n; ++i) {
+        psi(i) = -M_PI + 2.0 * M_PI * i / n;
+    }
+    return psi;
+}
+
+} // namespace
+
+TEST(TangentNormalVectors, MatchReferenceFormulas) {
+    VectorXd psi = testHeadings(1000);
+    Matrix2Xd tangvecs, normvecs;
+    calc_tangent_normal_vectors(psi, tangvecs, normvecs);
+    
+    ASSERT_EQ(tangvecs.cols(), psi.size());
+    ASSERT_EQ(normvecs.cols(), psi.size());
+    for (int i = 0; i < psi.size(); ++i) {
+        EXPECT_NEAR(tangvecs(0, i), std::cos(psi(i)), 1e-15);
+        EXPECT_NEAR(tangvecs(1, i), std::sin(psi(i)), 1e-15);
+        EXPECT_NEAR(normvecs(0, i), std::cos(psi(i) + M_PI / 2.0), 1e-15);
+        EXPECT_NEAR(normvecs(1, i), std::sin(psi(i) + M_PI / 2.0), 1e-15);
+    }
+}
+
+TEST(TangentNormalVectors, AgreeWithSeparateFunctions) {
+    VectorXd psi = testHeadings(257);
+    Matrix2Xd tangvecs, normvecs;
+    calc_tangent_normal_vectors(psi, tangvecs, normvecs);
+    
+    EXPECT_EQ(MatrixXd(tangvecs), calc_tangent_vectors(psi));
+    EXPECT_EQ(MatrixXd(normvecs), calc_normal_vectors(psi));
+}
+
+TEST(TangentNormalVectors, ReusePreallocatedOutputs) {
+    VectorXd psi = testHeadings(64);
+    Matrix2Xd tangvecs(2, psi.size());
+    Matrix2Xd normvecs(2, psi.size());
+    const double* tang_data = tangvecs.data();
+    const double* norm_data = normvecs.data();
+    
+    calc_tangent_normal_vectors(psi, tangvecs, normvecs);
+    EXPECT_EQ(tangvecs.data(), tang_data);
+    EXPECT_EQ(normvecs.data(), norm_data);
+    
+    // Wrongly sized outputs are resized
+    Matrix2Xd small(2, 3);
+    calc_tangent_normal_vectors(psi, small, normvecs);
+    EXPECT_EQ(small.cols(), psi.size());
+}
+
+TEST(TangentNormalVectors, FloatAgreesWithDouble) {
+    VectorXd psi = testHeadings(500);
+    VectorXf psi_f = psi.cast<float>();
+    Matrix2Xd tangvecs, normvecs;
+    Matrix2Xf tangvecs_f, normvecs_f;
+    calc_tangent_normal_vectors(psi, tangvecs, normvecs);
+    calc_tangent_normal_vectors<float>(psi_f, tangvecs_f, normvecs_f);
+    
+    EXPECT_LT((tangvecs_f.cast<double>() - tangvecs).cwiseAbs().maxCoeff(), 1e-6);
+    EXPECT_LT((normvecs_f.cast<double>() - normvecs).cwiseAbs().maxCoeff(), 1e-6);
+}